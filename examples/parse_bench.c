@@ -0,0 +1,180 @@
+/* Parser variant benchmark: the same documents through every JunoParseMode.
+ *
+ *   bin/parse_bench [-s MB] [-r ROUNDS]
+ *
+ * Generates three synthetic documents of about MB megabytes each (default 8):
+ * "numbers" (an array of integers and decimals), "strings" (records with long
+ * text values, some escaped) and "records" (small mixed objects, the typical
+ * API payload). Each mode parses each document ROUNDS times (default 10) into
+ * an arena that is reset between rounds, so allocation stays out of the
+ * figures; the best round is reported in MB/s with the speedup over
+ * JUNO_PARSE_MODE_FULL. Build with optimization for meaningful numbers:
+ *
+ *   make CFLAGS="-O2 -std=c99" parse_bench && bin/parse_bench
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <juno/juno.h>
+
+typedef struct {
+    char  *data;
+    size_t len, cap;
+} Buf;
+
+static void buf_put(Buf *b, const char *s, size_t n) {
+    if (b->len + n + 1 > b->cap) {
+        while (b->len + n + 1 > b->cap) b->cap = b->cap ? b->cap * 2 : 4096;
+        b->data = (char*)realloc(b->data, b->cap);
+        if (!b->data) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    memcpy(b->data + b->len, s, n);
+    b->len += n;
+    b->data[b->len] = '\0';
+}
+
+static void buf_printf(Buf *b, const char *fmt, ...) {
+    char tmp[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+    va_end(ap);
+    buf_put(b, tmp, (size_t)n);
+}
+
+static uint32_t rng_state = 12345;
+static uint32_t rnd(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* ------------------------------
+ * Documents
+ * ------------------------------ */
+
+static void gen_numbers(Buf *b, size_t target) {
+    buf_put(b, "[", 1);
+    for (size_t i = 0; b->len < target; i++) {
+        if (i) buf_put(b, ",", 1);
+        switch (rnd() % 4) {
+            case 0: buf_printf(b, "%u", rnd() % 1000); break;
+            case 1: buf_printf(b, "-%u%05u", rnd() % 100000, rnd() % 100000); break;
+            case 2: buf_printf(b, "%u.%02u", rnd() % 10000, rnd() % 100); break;
+            default: buf_printf(b, "%.6e", (double)rnd() / 7.0); break;
+        }
+    }
+    buf_put(b, "]", 1);
+}
+
+static void gen_strings(Buf *b, size_t target) {
+    static const char *const words[] = {
+        "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit", "sed", "do"
+    };
+    buf_put(b, "[", 1);
+    for (size_t i = 0; b->len < target; i++) {
+        if (i) buf_put(b, ",", 1);
+        buf_printf(b, "{\"title\":\"entry %zu\",\"body\":\"", i);
+        unsigned nwords = 20 + rnd() % 60;
+        for (unsigned w = 0; w < nwords; w++) {
+            if (w) buf_put(b, " ", 1);
+            const char *word = words[rnd() % 10];
+            buf_put(b, word, strlen(word));
+        }
+        const char *tail = (rnd() % 4 == 0) ? "\\n\\\"quoted\\\" \\u00e9\"}" : "\"}";
+        buf_put(b, tail, strlen(tail));
+    }
+    buf_put(b, "]", 1);
+}
+
+static void gen_records(Buf *b, size_t target) {
+    buf_put(b, "[", 1);
+    for (size_t i = 0; b->len < target; i++) {
+        if (i) buf_put(b, ",", 1);
+        buf_printf(b, "{\"id\":%zu,\"name\":\"user_%u\",\"active\":%s,\"score\":%u.%u,"
+                      "\"tags\":[\"a%u\",\"b%u\"],\"parent\":null,\"geo\":{\"lat\":%d.%04u,\"lon\":%d.%04u}}",
+                   i, rnd() % 100000, (rnd() & 1) ? "true" : "false", rnd() % 100, rnd() % 10,
+                   rnd() % 10, rnd() % 10, (int)(rnd() % 180) - 90, rnd() % 10000,
+                   (int)(rnd() % 360) - 180, rnd() % 10000);
+    }
+    buf_put(b, "]", 1);
+}
+
+/* ------------------------------
+ * Measurement
+ * ------------------------------ */
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Best round in seconds, or a negative value if the parse failed. */
+static double run(const Buf *doc, JunoParseMode mode, JunoArena *arena, int rounds) {
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.arena = arena;
+    opts.mode = mode;
+
+    double best = 0;
+    for (int r = 0; r < rounds; r++) {
+        JunoError err;
+        juno_arena_reset(arena);
+        double t0 = now_s();
+        JsonNode *root = juno_parse_opts(doc->data, doc->len, &opts, &err);
+        double dt = now_s() - t0;
+        if (!root) {
+            fprintf(stderr, "parse failed: %s at %zu\n", err.msg, err.offset);
+            return -1;
+        }
+        if (r == 0 || dt < best) best = dt;
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    size_t mb = 8;
+    int rounds = 10;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-s") == 0) mb = (size_t)atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-r") == 0) rounds = atoi(argv[i + 1]);
+    }
+    if (mb == 0) mb = 1;
+    if (rounds <= 0) rounds = 1;
+
+    static const struct { const char *name; void (*gen)(Buf*, size_t); } docs[] = {
+        { "numbers", gen_numbers }, { "strings", gen_strings }, { "records", gen_records }
+    };
+    static const struct { const char *name; JunoParseMode mode; } modes[] = {
+        { "full", JUNO_PARSE_MODE_FULL }, { "strict", JUNO_PARSE_MODE_STRICT },
+        { "trusted", JUNO_PARSE_MODE_TRUSTED }, { "doubles", JUNO_PARSE_MODE_DOUBLES }
+    };
+
+    JunoArena *arena = juno_arena_new(1u << 20);
+    printf("%-8s %-8s %10s %8s\n", "doc", "mode", "MB/s", "speedup");
+    for (size_t d = 0; d < sizeof(docs) / sizeof(docs[0]); d++) {
+        Buf doc = { NULL, 0, 0 };
+        docs[d].gen(&doc, mb << 20);
+        double base = 0;
+        for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+            double t = run(&doc, modes[m].mode, arena, rounds);
+            if (t < 0) return 1;
+            if (m == 0) base = t;
+            printf("%-8s %-8s %10.1f %7.2fx\n", docs[d].name, modes[m].name,
+                   (double)doc.len / t / 1e6, base / t);
+        }
+        free(doc.data);
+    }
+    juno_arena_free(arena);
+    return 0;
+}
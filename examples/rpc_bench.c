@@ -0,0 +1,640 @@
+/* End-to-end JSON-RPC 2.0 benchmark: parse + dispatch + serialize per request.
+ *
+ *   bin/rpc_bench                                  in-process server and load generator,
+ *                                                  every payload shape at 1, 4 and 16 clients
+ *   bin/rpc_bench server [-u PATH | -p PORT] [-t THREADS]
+ *   bin/rpc_bench client [-u PATH | -p PORT] [-c CLIENTS] [-n REQUESTS] [-s SHAPE]
+ *
+ * The server accepts on a Unix domain socket (default /tmp/juno_rpc_bench.sock)
+ * or TCP loopback port and hands connections round-robin to worker threads,
+ * each running its own epoll loop. Requests and responses are newline-delimited
+ * JSON. Every request is parsed into a per-worker arena that is reset before
+ * the next one, so the steady state does no malloc on the server.
+ *
+ * Methods: "ping" -> "pong", "echo" -> params, "sum" -> sum of a number array.
+ * Each client thread owns one connection and keeps one request in flight;
+ * latency is measured from just before send() to the end of the response line
+ * and reported as p50 / p99 / p99.9 over all clients. Linux only (epoll).
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <juno/juno.h>
+#include <juno/builder.h>
+#include <juno/writer.h>
+
+#define DEFAULT_SOCKET  "/tmp/juno_rpc_bench.sock"
+#define MAX_LINE        (16u << 20)
+#define READ_CHUNK      (64u << 10)
+
+typedef struct {
+    const char *unix_path;  /* NULL: TCP */
+    int         port;
+} Endpoint;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int set_nonblock(int fd) {
+    int fl = fcntl(fd, F_GETFL, 0);
+    return fl < 0 ? -1 : fcntl(fd, F_SETFL, fl | O_NONBLOCK);
+}
+
+static int ep_socket(const Endpoint *ep, struct sockaddr_storage *sa, socklen_t *salen) {
+    memset(sa, 0, sizeof(*sa));
+    if (ep->unix_path) {
+        struct sockaddr_un *un = (struct sockaddr_un*)sa;
+        un->sun_family = AF_UNIX;
+        strncpy(un->sun_path, ep->unix_path, sizeof(un->sun_path) - 1);
+        *salen = (socklen_t)sizeof(*un);
+        return socket(AF_UNIX, SOCK_STREAM, 0);
+    }
+    struct sockaddr_in *in = (struct sockaddr_in*)sa;
+    in->sin_family = AF_INET;
+    in->sin_port = htons((uint16_t)ep->port);
+    in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    *salen = (socklen_t)sizeof(*in);
+    return socket(AF_INET, SOCK_STREAM, 0);
+}
+
+static void tcp_nodelay(const Endpoint *ep, int fd) {
+    int one = 1;
+    if (!ep->unix_path) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+/* ------------------------------
+ * Server: connections
+ * ------------------------------ */
+
+typedef struct Conn {
+    int          fd;
+    char        *in;
+    size_t       in_len, in_cap;
+    char        *out;
+    size_t       out_len, out_off, out_cap;
+    bool         want_out;      /* EPOLLOUT registered */
+    struct Conn *prev, *next;   /* worker's connection list */
+} Conn;
+
+typedef struct {
+    int             epfd;
+    pthread_t       tid;
+    JunoArena      *arena;      /* one request at a time */
+    pthread_mutex_t lock;       /* guards conns: the acceptor links, the worker unlinks */
+    Conn           *conns;
+} Worker;
+
+typedef struct {
+    Endpoint  ep;
+    int       listen_fd;
+    int       stop_pipe[2];     /* readable once the server stops */
+    unsigned  nworkers;
+    Worker   *workers;
+    pthread_t acceptor;
+} Server;
+
+static bool conn_append(void *ud, const char *data, size_t len) {
+    Conn *c = (Conn*)ud;
+    if (len > c->out_cap - c->out_len) {
+        size_t cap = c->out_cap ? c->out_cap : 4096;
+        while (len > cap - c->out_len) cap *= 2;
+        char *p = (char*)realloc(c->out, cap);
+        if (!p) return false;
+        c->out = p;
+        c->out_cap = cap;
+    }
+    memcpy(c->out + c->out_len, data, len);
+    c->out_len += len;
+    return true;
+}
+
+static void conn_close(Worker *w, Conn *c) {
+    epoll_ctl(w->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    pthread_mutex_lock(&w->lock);
+    if (c->prev) c->prev->next = c->next;
+    else w->conns = c->next;
+    if (c->next) c->next->prev = c->prev;
+    pthread_mutex_unlock(&w->lock);
+    free(c->in);
+    free(c->out);
+    free(c);
+}
+
+/* Write what the socket takes; register for EPOLLOUT while output remains. */
+static bool conn_flush(Worker *w, Conn *c) {
+    while (c->out_off < c->out_len) {
+        ssize_t n = send(c->fd, c->out + c->out_off, c->out_len - c->out_off, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+        c->out_off += (size_t)n;
+    }
+    if (c->out_off == c->out_len) c->out_off = c->out_len = 0;
+
+    bool want = c->out_len > 0;
+    if (want != c->want_out) {
+        struct epoll_event ev;
+        ev.events = EPOLLIN | (want ? EPOLLOUT : 0);
+        ev.data.ptr = c;
+        if (epoll_ctl(w->epfd, EPOLL_CTL_MOD, c->fd, &ev) != 0) return false;
+        c->want_out = want;
+    }
+    return true;
+}
+
+/* ------------------------------
+ * Server: dispatch
+ * ------------------------------ */
+
+static JsonNode* rpc_response(JunoArena *a) {
+    JsonNode *resp = juno_new_object(a);
+    juno_obj_append(a, resp, "jsonrpc", juno_new_string(a, "2.0", 3));
+    return resp;
+}
+
+static JsonNode* rpc_finish(JunoArena *a, JsonNode *resp, JsonNode *id) {
+    juno_obj_append(a, resp, "id", id ? id : juno_new_null(a));
+    return resp;
+}
+
+static JsonNode* rpc_error(JunoArena *a, JsonNode *id, int64_t code, const char *msg) {
+    JsonNode *resp = rpc_response(a);
+    JsonNode *e = juno_new_object(a);
+    juno_obj_append(a, e, "code", juno_new_int(a, code));
+    juno_obj_append(a, e, "message", juno_new_string(a, msg, strlen(msg)));
+    juno_obj_append(a, resp, "error", e);
+    return rpc_finish(a, resp, id);
+}
+
+static JsonNode* rpc_sum(JunoArena *a, const JsonNode *params) {
+    int64_t isum = 0;
+    double dsum = 0;
+    bool integral = true;
+    for (const JsonNode *n = params->first_child; n; n = n->next_sibling) {
+        int64_t i;
+        double d;
+        if (integral && juno_number_int64(n, &i)) {
+            isum += i;
+        } else if (juno_number_double(n, &d)) {
+            if (integral) dsum = (double)isum;
+            integral = false;
+            dsum += d;
+        } else {
+            return NULL;
+        }
+    }
+    return integral ? juno_new_int(a, isum) : juno_new_double(a, dsum);
+}
+
+/* Response to one request line, or NULL for a notification (no "id"). */
+static JsonNode* rpc_dispatch(JunoArena *a, const char *line, size_t len) {
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.arena = a;
+    JunoError err;
+    JsonNode *req = juno_parse_opts(line, len, &opts, &err);
+    if (!req) return rpc_error(a, NULL, -32700, "Parse error");
+    if (req->type != JND_OBJ) return rpc_error(a, NULL, -32600, "Invalid Request");
+
+    /* Unlinked from the request and re-attached to the response: no copies. */
+    JsonNode *id = juno_obj_remove(req, "id");
+    JsonNode *version = juno_obj_get(req, "jsonrpc");
+    JsonNode *method = juno_obj_get(req, "method");
+    JsonNode *params = juno_obj_remove(req, "params");
+    if (!version || version->type != JND_STRING || strcmp(version->value.svalue, "2.0") != 0 ||
+        !method || method->type != JND_STRING)
+        return rpc_error(a, id, -32600, "Invalid Request");
+    if (!id) return NULL;
+
+    JsonNode *result;
+    const char *m = method->value.svalue;
+    if (strcmp(m, "ping") == 0) {
+        result = juno_new_string(a, "pong", 4);
+    } else if (strcmp(m, "echo") == 0) {
+        result = params ? params : juno_new_null(a);
+    } else if (strcmp(m, "sum") == 0) {
+        result = (params && params->type == JND_ARRAY) ? rpc_sum(a, params) : NULL;
+        if (!result) return rpc_error(a, id, -32602, "Invalid params");
+    } else {
+        return rpc_error(a, id, -32601, "Method not found");
+    }
+
+    JsonNode *resp = rpc_response(a);
+    juno_obj_append(a, resp, "result", result);
+    return rpc_finish(a, resp, id);
+}
+
+/* Read what is available and answer every complete line. */
+static bool conn_read(Worker *w, Conn *c) {
+    for (;;) {
+        if (c->in_cap - c->in_len < READ_CHUNK) {
+            size_t cap = c->in_cap ? c->in_cap * 2 : 2 * READ_CHUNK;
+            if (cap > MAX_LINE + READ_CHUNK) return false;
+            char *p = (char*)realloc(c->in, cap);
+            if (!p) return false;
+            c->in = p;
+            c->in_cap = cap;
+        }
+        ssize_t n = recv(c->fd, c->in + c->in_len, c->in_cap - c->in_len, 0);
+        if (n == 0) return false;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        size_t scan = c->in_len;
+        c->in_len += (size_t)n;
+
+        size_t start = 0;
+        char *nl;
+        while ((nl = (char*)memchr(c->in + scan, '\n', c->in_len - scan)) != NULL) {
+            size_t end = (size_t)(nl - c->in);
+            juno_arena_reset(w->arena);
+            JsonNode *resp = rpc_dispatch(w->arena, c->in + start, end - start);
+            if (resp && (!juno_write(resp, conn_append, c, NULL) || !conn_append(c, "\n", 1))) return false;
+            start = scan = end + 1;
+        }
+        if (start > 0) {
+            memmove(c->in, c->in + start, c->in_len - start);
+            c->in_len -= start;
+        }
+        if (c->in_len > MAX_LINE) return false;
+    }
+    return conn_flush(w, c);
+}
+
+/* ------------------------------
+ * Server: threads
+ * ------------------------------ */
+
+static void* worker_main(void *arg) {
+    Worker *w = (Worker*)arg;
+    struct epoll_event evs[64];
+    for (;;) {
+        int n = epoll_wait(w->epfd, evs, 64, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            Conn *c = (Conn*)evs[i].data.ptr;
+            if (!c) return NULL;   /* stop pipe */
+            bool ok = true;
+            if (evs[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) ok = conn_read(w, c);
+            if (ok && (evs[i].events & EPOLLOUT)) ok = conn_flush(w, c);
+            if (!ok) conn_close(w, c);
+        }
+    }
+    return NULL;
+}
+
+static void* acceptor_main(void *arg) {
+    Server *s = (Server*)arg;
+    unsigned next = 0;
+    struct pollfd pfd[2] = { { s->listen_fd, POLLIN, 0 }, { s->stop_pipe[0], POLLIN, 0 } };
+    for (;;) {
+        if (poll(pfd, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (pfd[1].revents) break;
+        int fd = accept(s->listen_fd, NULL, NULL);
+        if (fd < 0) continue;
+        tcp_nodelay(&s->ep, fd);
+
+        Conn *c = (Conn*)calloc(1, sizeof(Conn));
+        if (!c || set_nonblock(fd) != 0) {
+            free(c);
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        /* The worker may be closing other connections of its list right now,
+         * so link under its lock, and before registering: once the fd is in
+         * the epoll set the worker may close `c` too. */
+        Worker *w = &s->workers[next++ % s->nworkers];
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = c;
+        pthread_mutex_lock(&w->lock);
+        c->next = w->conns;
+        if (w->conns) w->conns->prev = c;
+        w->conns = c;
+        pthread_mutex_unlock(&w->lock);
+        if (epoll_ctl(w->epfd, EPOLL_CTL_ADD, fd, &ev) != 0) conn_close(w, c);
+    }
+    return NULL;
+}
+
+static Server* server_start(const Endpoint *ep, unsigned threads) {
+    Server *s = (Server*)calloc(1, sizeof(Server));
+    if (!s) return NULL;
+    s->ep = *ep;
+    s->nworkers = threads ? threads : 1;
+    s->workers = (Worker*)calloc(s->nworkers, sizeof(Worker));
+    if (!s->workers || pipe(s->stop_pipe) != 0) {
+        free(s->workers);
+        free(s);
+        return NULL;
+    }
+
+    struct sockaddr_storage sa;
+    socklen_t salen;
+    s->listen_fd = ep_socket(ep, &sa, &salen);
+    int one = 1;
+    if (ep->unix_path) unlink(ep->unix_path);
+    else setsockopt(s->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (s->listen_fd < 0 || bind(s->listen_fd, (struct sockaddr*)&sa, salen) != 0 ||
+        listen(s->listen_fd, 512) != 0) {
+        perror("rpc_bench: listen");
+        exit(1);
+    }
+
+    for (unsigned i = 0; i < s->nworkers; i++) {
+        Worker *w = &s->workers[i];
+        pthread_mutex_init(&w->lock, NULL);
+        w->arena = juno_arena_new(0);
+        w->epfd = epoll_create1(0);
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = NULL;
+        if (!w->arena || w->epfd < 0 || epoll_ctl(w->epfd, EPOLL_CTL_ADD, s->stop_pipe[0], &ev) != 0 ||
+            pthread_create(&w->tid, NULL, worker_main, w) != 0) {
+            fprintf(stderr, "rpc_bench: cannot start worker %u\n", i);
+            exit(1);
+        }
+    }
+    if (pthread_create(&s->acceptor, NULL, acceptor_main, s) != 0) {
+        fprintf(stderr, "rpc_bench: cannot start acceptor\n");
+        exit(1);
+    }
+    return s;
+}
+
+static void server_stop(Server *s) {
+    char b = 0;
+    if (write(s->stop_pipe[1], &b, 1) != 1) perror("rpc_bench: stop");
+    pthread_join(s->acceptor, NULL);
+    for (unsigned i = 0; i < s->nworkers; i++) {
+        Worker *w = &s->workers[i];
+        pthread_join(w->tid, NULL);
+        while (w->conns) conn_close(w, w->conns);
+        close(w->epfd);
+        juno_arena_free(w->arena);
+        pthread_mutex_destroy(&w->lock);
+    }
+    close(s->listen_fd);
+    if (s->ep.unix_path) unlink(s->ep.unix_path);
+    close(s->stop_pipe[0]);
+    close(s->stop_pipe[1]);
+    free(s->workers);
+    free(s);
+}
+
+/* ------------------------------
+ * Load generator
+ * ------------------------------ */
+
+typedef struct {
+    const char *name;
+    const char *method;
+    void (*params)(char *buf, size_t cap);   /* JSON text of "params", or NULL */
+} Shape;
+
+static void params_sum(char *buf, size_t cap) {
+    size_t n = (size_t)snprintf(buf, cap, "[");
+    for (int i = 0; i < 256 && n < cap; i++) n += (size_t)snprintf(buf + n, cap - n, "%s%d", i ? "," : "", i * 37 - 4000);
+    snprintf(buf + n, cap - n, "]");
+}
+
+static void params_object(char *buf, size_t cap) {
+    size_t n = (size_t)snprintf(buf, cap, "{");
+    for (int i = 0; i < 54 && n < cap; i++)
+        n += (size_t)snprintf(buf + n, cap - n,
+                              "%s\"field_%02d\":{\"name\":\"value number %d with some text\",\"n\":%d.25,\"ok\":%s}",
+                              i ? "," : "", i, i, i, (i & 1) ? "true" : "false");
+    snprintf(buf + n, cap - n, "}");
+}
+
+static const Shape k_shapes[] = {
+    { "ping",   "ping", NULL },
+    { "sum256", "sum",  params_sum },
+    { "echo4k", "echo", params_object },
+};
+
+typedef struct {
+    const Endpoint *ep;
+    const char     *req;        /* request line, '\n' included */
+    size_t          req_len;
+    size_t          n;
+    uint64_t       *lat;        /* n samples, ns */
+    uint64_t        start, end;
+    bool            ok;
+} Client;
+
+static bool send_all(int fd, const char *p, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static void* client_main(void *arg) {
+    Client *cl = (Client*)arg;
+    struct sockaddr_storage sa;
+    socklen_t salen;
+    int fd = ep_socket(cl->ep, &sa, &salen);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&sa, salen) != 0) {
+        perror("rpc_bench: connect");
+        if (fd >= 0) close(fd);
+        return NULL;
+    }
+    tcp_nodelay(cl->ep, fd);
+
+    size_t cap = 64 << 10, len = 0;
+    char *buf = (char*)malloc(cap);
+    cl->start = now_ns();
+    for (size_t i = 0; buf && i < cl->n; i++) {
+        uint64_t t0 = now_ns();
+        if (!send_all(fd, cl->req, cl->req_len)) goto done;
+        /* One request in flight: the response is everything up to '\n'. */
+        for (;;) {
+            if (len == cap) {
+                char *p = (char*)realloc(buf, cap *= 2);
+                if (!p) goto done;
+                buf = p;
+            }
+            ssize_t n = recv(fd, buf + len, cap - len, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) goto done;
+            len += (size_t)n;
+            if (buf[len - 1] == '\n') break;
+        }
+        cl->lat[i] = now_ns() - t0;
+
+        if (i == 0) {
+            JunoError err;
+            JsonNode *resp = juno_parse_ex(buf, len - 1, &err);
+            bool good = resp && juno_obj_get(resp, "result") != NULL;
+            juno_free_ast(resp);
+            if (!good) {
+                fprintf(stderr, "rpc_bench: unexpected response: %.*s\n", (int)(len > 200 ? 200 : len), buf);
+                goto done;
+            }
+        }
+        len = 0;
+    }
+    cl->ok = true;
+done:
+    cl->end = now_ns();
+    free(buf);
+    close(fd);
+    return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static double pct_us(const uint64_t *sorted, size_t n, double p) {
+    size_t i = (size_t)(p * (double)(n - 1) + 0.5);
+    return (double)sorted[i] / 1000.0;
+}
+
+static bool run_load(const Endpoint *ep, const Shape *shape, unsigned clients, size_t per_client) {
+    static char params[64 << 10];
+    char *req = (char*)malloc(sizeof(params) + 256);
+    if (!req) return false;
+    if (shape->params) shape->params(params, sizeof(params));
+    int req_len = snprintf(req, sizeof(params) + 256, "{\"jsonrpc\":\"2.0\",\"method\":\"%s\"%s%s,\"id\":1}\n",
+                           shape->method, shape->params ? ",\"params\":" : "", shape->params ? params : "");
+
+    Client *cl = (Client*)calloc(clients, sizeof(Client));
+    pthread_t *tids = (pthread_t*)calloc(clients, sizeof(pthread_t));
+    uint64_t *lat = (uint64_t*)calloc((size_t)clients * per_client, sizeof(uint64_t));
+    bool ok = cl && tids && lat;
+    for (unsigned i = 0; ok && i < clients; i++) {
+        cl[i].ep = ep;
+        cl[i].req = req;
+        cl[i].req_len = (size_t)req_len;
+        cl[i].n = per_client;
+        cl[i].lat = lat + (size_t)i * per_client;
+        ok = pthread_create(&tids[i], NULL, client_main, &cl[i]) == 0;
+        if (!ok) clients = i;
+    }
+    for (unsigned i = 0; i < clients; i++) pthread_join(tids[i], NULL);
+
+    uint64_t start = UINT64_MAX, end = 0;
+    for (unsigned i = 0; ok && i < clients; i++) {
+        ok = cl[i].ok;
+        if (cl[i].start < start) start = cl[i].start;
+        if (cl[i].end > end) end = cl[i].end;
+    }
+    if (ok) {
+        size_t total = (size_t)clients * per_client;
+        qsort(lat, total, sizeof(uint64_t), cmp_u64);
+        printf("%-8s %7d %8u %12.0f %9.1f %9.1f %9.1f\n", shape->name, req_len - 1, clients,
+               (double)total * 1e9 / (double)(end - start),
+               pct_us(lat, total, 0.50), pct_us(lat, total, 0.99), pct_us(lat, total, 0.999));
+    } else {
+        fprintf(stderr, "rpc_bench: %s with %u clients failed\n", shape->name, clients);
+    }
+    free(lat);
+    free(tids);
+    free(cl);
+    free(req);
+    return ok;
+}
+
+static void print_header(void) {
+    printf("%-8s %7s %8s %12s %9s %9s %9s\n", "shape", "bytes", "clients", "req/s", "p50 us", "p99 us", "p999 us");
+}
+
+/* ------------------------------
+ * Command line
+ * ------------------------------ */
+
+static void usage(void) {
+    fprintf(stderr,
+            "usage: rpc_bench [server|client] [-u PATH | -p PORT] [-t THREADS]\n"
+            "                 [-c CLIENTS] [-n REQUESTS] [-s ping|sum256|echo4k]\n");
+    exit(2);
+}
+
+int main(int argc, char *argv[]) {
+    Endpoint ep = { DEFAULT_SOCKET, 0 };
+    unsigned threads = 4, clients = 0;
+    size_t requests = 0;
+    const char *shape_name = NULL;
+    const char *mode = "bench";
+
+    int i = 1;
+    if (argc > 1 && argv[1][0] != '-') mode = argv[i++];
+    for (; i < argc; i++) {
+        if (i + 1 >= argc) usage();
+        const char *opt = argv[i], *val = argv[++i];
+        if (strcmp(opt, "-u") == 0) ep.unix_path = val;
+        else if (strcmp(opt, "-p") == 0) { ep.unix_path = NULL; ep.port = atoi(val); }
+        else if (strcmp(opt, "-t") == 0) threads = (unsigned)atoi(val);
+        else if (strcmp(opt, "-c") == 0) clients = (unsigned)atoi(val);
+        else if (strcmp(opt, "-n") == 0) requests = (size_t)strtoull(val, NULL, 10);
+        else if (strcmp(opt, "-s") == 0) shape_name = val;
+        else usage();
+    }
+
+    if (strcmp(mode, "server") == 0) {
+        if (!server_start(&ep, threads)) return 1;
+        if (ep.unix_path) printf("rpc_bench: serving on %s\n", ep.unix_path);
+        else printf("rpc_bench: serving on 127.0.0.1:%d\n", ep.port);
+        fflush(stdout);
+        for (;;) pause();
+    }
+
+    bool client_only = strcmp(mode, "client") == 0;
+    if (!client_only && strcmp(mode, "bench") != 0) usage();
+
+    Server *s = client_only ? NULL : server_start(&ep, threads);
+    if (!client_only && !s) return 1;
+
+    static const unsigned k_clients[] = { 1, 4, 16 };
+    bool ok = true;
+    print_header();
+    for (size_t si = 0; si < sizeof(k_shapes) / sizeof(k_shapes[0]); si++) {
+        if (shape_name && strcmp(shape_name, k_shapes[si].name) != 0) continue;
+        for (size_t ci = 0; ci < sizeof(k_clients) / sizeof(k_clients[0]); ci++) {
+            unsigned c = clients ? clients : k_clients[ci];
+            size_t n = requests ? requests : (c < 8 ? 20000 / c : 2500);
+            ok = run_load(&ep, &k_shapes[si], c, n) && ok;
+            if (clients) break;
+        }
+    }
+    if (s) server_stop(s);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#ifndef JUNO_BASE64_H
+#define JUNO_BASE64_H
+
+/* Base64 payloads (C).
+ *
+ * Binary data travels in JSON as base64 strings. The decoder here turns one
+ * straight into bytes: on x86 CPUs with SSSE3 (checked at run time) it
+ * translates and packs 16 characters per step, elsewhere it falls back to a
+ * table-driven scalar loop with the same results.
+ *
+ * Parsing with JunoParseOptions.base64_keys decodes the string values of the
+ * named members during the parse, without building the intermediate string:
+ * they become binary nodes (JND_STRING with JND_FLAG_BINARY) whose bytes are
+ * read with juno_binary. Writers re-encode them (standard alphabet padded,
+ * base64url unpadded); hashing and equality compare their bytes.
+ *
+ * Both RFC 4648 alphabets are supported. Padding is optional, whitespace is
+ * not allowed, and unused trailing bits must be zero, so every byte string
+ * has exactly one accepted encoding per alphabet and padding style.
+ */
+
+#include <juno/juno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Flags for the functions below and JUNO_PARSE_BASE64URL. */
+#define JUNO_BASE64_URL 0x1u   /* '-' and '_' instead of '+' and '/' (RFC 4648 section 5) */
+
+/* Upper bound of the decoded size of `len` characters. */
+static inline size_t juno_base64_decoded_max(size_t len) {
+    return len / 4 * 3 + (len % 4 ? len % 4 - 1 : 0);
+}
+
+/* Encoded size of `len` bytes (padded for the standard alphabet only). */
+size_t juno_base64_encoded_len(size_t len, unsigned flags);
+
+/* Decode `len` characters into `out` (juno_base64_decoded_max(len) bytes).
+ * On failure err (may be NULL) is JUNO_ERR_INVALID_STRING with the offset
+ * of the offending character in `src`. */
+bool juno_base64_decode(const char *src, size_t len, unsigned flags,
+                        uint8_t *out, size_t *out_len, JunoError *err);
+
+/* Encode `len` bytes into `out` (juno_base64_encoded_len bytes, no NUL).
+ * Returns the number of characters written. */
+size_t juno_base64_encode(const uint8_t *src, size_t len, unsigned flags, char *out);
+
+/* Bytes of a binary node (NULL for anything else). Valid as long as the node. */
+const uint8_t* juno_binary(const JsonNode *node, size_t *len);
+
+/* Bytes of a binary node, or of a string node decoded as base64, in a
+ * malloc'd buffer (free it). NULL with err set for other nodes or invalid
+ * base64 (offset into the string). */
+uint8_t* juno_binary_dup(const JsonNode *node, unsigned flags, size_t *len, JunoError *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_BASE64_H */
@@ -0,0 +1,47 @@
+#ifndef JUNO_BATCH_H
+#define JUNO_BATCH_H
+
+/* Batch parsing of many small documents (C).
+ *
+ * A JunoBatch owns one arena and one parser context that are reused across
+ * calls: every document of a batch is parsed into the same arena, so the
+ * per-message cost of node allocation and parser setup is paid once per
+ * chunk rather than once per node.
+ */
+
+#include <juno/juno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct JunoBatch JunoBatch;
+
+/* One input document. */
+typedef struct {
+    const char *data;
+    size_t      len;
+} JunoBuffer;
+
+/* `chunk_size` is forwarded to the batch arena (0 selects a default). */
+JunoBatch* juno_batch_new(size_t chunk_size);
+
+/* Parse `n` documents. roots[i] receives the tree (NULL on failure) and, when
+ * `errs` is not NULL, errs[i] the per-item error. Trees stay valid until the
+ * next juno_batch_parse / juno_batch_free on this batch and must not be passed
+ * to juno_free_ast. Returns the number of documents parsed successfully. */
+size_t juno_batch_parse(JunoBatch *batch, const JunoBuffer *items, size_t n,
+                        JsonNode **roots, JunoError *errs);
+
+/* Options applied to every document of the batch (the arena field is
+ * ignored: the batch always uses its own). `opts` is copied. The parser is
+ * chosen as juno_parse_opts chooses it, so `mode` applies here too. */
+void juno_batch_set_options(JunoBatch *batch, const JunoParseOptions *opts);
+
+void juno_batch_free(JunoBatch *batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_BATCH_H */
@@ -0,0 +1,76 @@
+#ifndef JUNO_BINARY_H
+#define JUNO_BINARY_H
+
+/* Binary on-disk format for parsed documents (C).
+ *
+ * juno_save_binary writes a JsonNode tree as a flat, versioned and
+ * checksummed image: a fixed header, an array of fixed-size node records in
+ * depth-first order and a pool of NUL-terminated strings. juno_load_binary
+ * mmaps such a file and the juno_bin_* accessors navigate it in place:
+ * nothing is deserialized and no per-node memory is allocated.
+ *
+ * Images are native-endian; loading an image written on a host with a
+ * different byte order fails with JUNO_ERR_BINARY_FORMAT.
+ */
+
+#include <juno/juno.h>
+
+#define JUNO_BIN_VERSION 1
+
+/* juno_load_binary / juno_open_binary flags */
+#define JUNO_BIN_VERIFY 0x1u  /* verify the checksum (reads the whole image once) */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct JunoBinDoc JunoBinDoc;
+
+/* Reference to a node inside a JunoBinDoc (its depth-first index). */
+typedef uint32_t JunoBinRef;
+#define JUNO_BIN_NONE ((JunoBinRef)0xFFFFFFFFu)
+
+/* Encode `root` into a malloc'd image of *size bytes. */
+void* juno_encode_binary(const JsonNode *root, size_t *size, JunoError *err);
+
+/* Encode `root` and write it to `path`. */
+bool juno_save_binary(const JsonNode *root, const char *path, JunoError *err);
+
+/* mmap an image file. Close with juno_binary_close. */
+JunoBinDoc* juno_load_binary(const char *path, unsigned flags, JunoError *err);
+
+/* Wrap an image that is already in memory (no copy; `data` must stay valid
+ * and 8-byte aligned until juno_binary_close). */
+JunoBinDoc* juno_open_binary(const void *data, size_t size, unsigned flags, JunoError *err);
+
+void juno_binary_close(JunoBinDoc *doc);
+
+/* Navigation. Every accessor is bounds-checked and tolerates JUNO_BIN_NONE. */
+JunoBinRef  juno_bin_root(const JunoBinDoc *doc);
+size_t      juno_bin_node_count(const JunoBinDoc *doc);
+JNodeType   juno_bin_type(const JunoBinDoc *doc, JunoBinRef ref);
+JunoBinRef  juno_bin_first_child(const JunoBinDoc *doc, JunoBinRef ref);
+JunoBinRef  juno_bin_next_sibling(const JunoBinDoc *doc, JunoBinRef ref);
+size_t      juno_bin_child_count(const JunoBinDoc *doc, JunoBinRef ref);
+
+/* Member name of an object member (NULL otherwise). */
+const char* juno_bin_key(const JunoBinDoc *doc, JunoBinRef ref, size_t *len);
+
+/* Scalar values; each returns a zero value on type mismatch. */
+const char* juno_bin_string(const JunoBinDoc *doc, JunoBinRef ref, size_t *len);
+bool        juno_bin_is_integer(const JunoBinDoc *doc, JunoBinRef ref);
+int64_t     juno_bin_int(const JunoBinDoc *doc, JunoBinRef ref);
+double      juno_bin_double(const JunoBinDoc *doc, JunoBinRef ref);
+bool        juno_bin_bool(const JunoBinDoc *doc, JunoBinRef ref);
+
+/* First member of object `obj` named `key`, or JUNO_BIN_NONE. */
+JunoBinRef  juno_bin_get(const JunoBinDoc *doc, JunoBinRef obj, const char *key);
+
+/* Element `index` of array `arr`, or JUNO_BIN_NONE. */
+JunoBinRef  juno_bin_at(const JunoBinDoc *doc, JunoBinRef arr, size_t index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_BINARY_H */
@@ -0,0 +1,75 @@
+#ifndef JUNO_BUILDER_H
+#define JUNO_BUILDER_H
+
+/* Building and editing JsonNode trees (C).
+ *
+ * Every constructor takes the JunoArena the node should live in, or NULL
+ * for the heap, exactly like JunoParseOptions.arena: builder nodes and
+ * parsed nodes are interchangeable and released the same way.
+ *
+ * Keep one allocator per tree. A heap subtree linked under an arena node is
+ * never freed (juno_free_ast stops at arena nodes), and an arena subtree
+ * linked under a heap node dangles once the arena is reset. To move a
+ * subtree between documents with different allocators, juno_clone it into
+ * the destination and free the original.
+ *
+ * Appending is O(1): containers remember their last child (JND_FLAG_TAIL);
+ * a container linked by hand is walked once on its first append. Functions
+ * that take ownership of `val` require it to be detached (no parent, no
+ * siblings).
+ */
+
+#include <juno/juno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Constructors; NULL on OOM. */
+JsonNode* juno_new_object(JunoArena *arena);
+JsonNode* juno_new_array(JunoArena *arena);
+JsonNode* juno_new_string(JunoArena *arena, const char *s, size_t len);  /* copies `s` */
+JsonNode* juno_new_int(JunoArena *arena, int64_t v);
+JsonNode* juno_new_double(JunoArena *arena, double v);
+JsonNode* juno_new_bool(JunoArena *arena, bool v);
+JsonNode* juno_new_null(JunoArena *arena);
+
+/* Raw number (JND_FLAG_RAW_NUMBER) from its JSON text, e.g. a decimal or an
+ * integer wider than 64 bits; serialized byte for byte. NULL if `text` is
+ * not exactly one valid JSON number. */
+JsonNode* juno_new_number_text(JunoArena *arena, const char *text, size_t len);
+
+/* Binary node (JND_FLAG_BINARY, juno/base64.h) holding a copy of `data`;
+ * `flags` is 0 or JUNO_BASE64_URL, the alphabet writers encode it with. */
+JsonNode* juno_new_binary(JunoArena *arena, const void *data, size_t len, unsigned flags);
+
+/* Deep copy of `node` (its key is not copied). */
+JsonNode* juno_clone(JunoArena *arena, const JsonNode *node);
+
+/* Append `val` to array `arr`. Any member name `val` still carries is dropped. */
+bool juno_array_append(JsonNode *arr, JsonNode *val);
+
+/* Append member `key` to object `obj` without checking for duplicates.
+ * The key is copied into `arena`, which must be the allocator of `val`. */
+bool juno_obj_append(JunoArena *arena, JsonNode *obj, const char *key, JsonNode *val);
+
+/* Replace the first member named `key` in place (the old value is freed) or
+ * append it when there is none. Same allocator rules as juno_obj_append. */
+bool juno_obj_set(JunoArena *arena, JsonNode *obj, const char *key, JsonNode *val);
+
+/* First member named `key`, or NULL. */
+JsonNode* juno_obj_get(const JsonNode *obj, const char *key);
+
+/* Unlink the first member named `key` and return it (NULL if absent). The
+ * caller owns the result: re-attach it elsewhere or juno_free_ast it. */
+JsonNode* juno_obj_remove(JsonNode *obj, const char *key);
+
+/* Unlink `child` from container `parent` and return it (NULL if `child` is
+ * not a child of `parent`). Its member name is kept. */
+JsonNode* juno_detach(JsonNode *parent, JsonNode *child);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_BUILDER_H */
@@ -0,0 +1,66 @@
+#ifndef JUNO_CACHE_H
+#define JUNO_CACHE_H
+
+/* Content-addressed parse cache (C).
+ *
+ * juno_cache_parse hashes the input bytes and, when an identical input was
+ * parsed before, returns the same immutable JunoDoc (juno/doc.h) with a new
+ * reference instead of parsing again: a hit costs one hash, a lookup and a
+ * memcmp against the cached copy of the text, so hash collisions can never
+ * return the wrong document.
+ *
+ * The cache is split into shards, each behind a reader-writer lock: hits only
+ * take the read lock, so concurrent lookups do not serialize. Every shard
+ * holds a fixed share of the entry and byte budgets and evicts with CLOCK
+ * (a hit sets the entry's reference bit, the hand clears it or evicts).
+ * Evicted documents stay valid for callers that still hold a reference.
+ */
+
+#include <juno/juno.h>
+#include <juno/doc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef JUNO_CACHE_DEFAULT_ENTRIES
+#define JUNO_CACHE_DEFAULT_ENTRIES 4096
+#endif
+
+#ifndef JUNO_CACHE_DEFAULT_BYTES
+#define JUNO_CACHE_DEFAULT_BYTES (64u << 20)
+#endif
+
+typedef struct JunoCache JunoCache;
+
+typedef struct {
+    size_t hits;
+    size_t misses;      /* parses, including failed ones */
+    size_t evictions;
+    size_t entries;     /* currently cached */
+    size_t bytes;       /* input copies plus document footprints */
+} JunoCacheStats;
+
+/* Cache holding at most `max_entries` documents and `max_bytes` bytes
+ * (0 selects JUNO_CACHE_DEFAULT_ENTRIES / JUNO_CACHE_DEFAULT_BYTES).
+ * NULL on OOM. */
+JunoCache* juno_cache_new(size_t max_entries, size_t max_bytes);
+
+/* Document for `json_str` with one reference for the caller (release it with
+ * juno_doc_release). Parsed with juno_doc_parse and cached on a miss; inputs
+ * that fail to parse are not cached. Safe to call from any thread. */
+JunoDoc* juno_cache_parse(JunoCache *cache, const char *json_str, size_t len, JunoError *err);
+
+void juno_cache_stats(JunoCache *cache, JunoCacheStats *out);
+
+/* Drop every entry (documents still referenced elsewhere stay alive). */
+void juno_cache_clear(JunoCache *cache);
+
+/* No thread may use the cache afterwards (safe on NULL). */
+void juno_cache_free(JunoCache *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_CACHE_H */
@@ -0,0 +1,69 @@
+#ifndef JUNO_DOC_H
+#define JUNO_DOC_H
+
+/* Immutable, reference-counted documents (C).
+ *
+ * A JunoDoc owns a tree stored in a private arena. Once created it is never
+ * modified, so any number of threads may read it concurrently without
+ * locking. Each holder keeps one reference (juno_doc_retain); the last
+ * juno_doc_release frees the whole document at once.
+ *
+ * JunoDocSlot publishes the current version of a document for RCU-style hot
+ * reloading: readers juno_doc_slot_acquire a snapshot and keep using it for
+ * as long as they like, while a writer juno_doc_slot_publish-es a new
+ * version; the old one is freed when its last reader releases it.
+ */
+
+#include <juno/juno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct JunoDoc JunoDoc;
+typedef struct JunoDocSlot JunoDocSlot;
+
+/* Parse `json_str` into a new document holding one reference. */
+JunoDoc* juno_doc_parse(const char *json_str, size_t len, JunoError *err);
+
+/* Same, loading the text from a file. */
+JunoDoc* juno_doc_parse_file(const char *filename, JunoError *err);
+
+/* Freeze a copy of an existing tree (heap or arena; `root` is not consumed). */
+JunoDoc* juno_doc_freeze(const JsonNode *root, JunoError *err);
+
+/* Copy a tree (heap, arena or document; not consumed) into a new document
+ * stored in one contiguous block: every node in depth-first order, so a
+ * traversal walks memory forwards, then all strings packed together. Meant
+ * for long-lived trees that were edited or assembled piecemeal and ended up
+ * scattered across the heap; the result is freed in one step by the last
+ * juno_doc_release. */
+JunoDoc* juno_compact(const JsonNode *root, JunoError *err);
+
+/* Root of the document; valid while the caller holds a reference. The tree
+ * must not be modified or passed to juno_free_ast. */
+const JsonNode* juno_doc_root(const JunoDoc *doc);
+
+/* Add / drop a reference (both safe on NULL and from any thread). */
+JunoDoc* juno_doc_retain(JunoDoc *doc);
+void     juno_doc_release(JunoDoc *doc);
+
+/* Create a slot publishing `doc` (may be NULL); the slot takes over the
+ * caller's reference. */
+JunoDocSlot* juno_doc_slot_new(JunoDoc *doc);
+
+/* The current document with a new reference for the caller (NULL if none). */
+JunoDoc* juno_doc_slot_acquire(JunoDocSlot *slot);
+
+/* Replace the current document; the slot takes over the caller's reference
+ * to `doc` and drops its reference to the previous version. */
+void juno_doc_slot_publish(JunoDocSlot *slot, JunoDoc *doc);
+
+/* Drop the slot and its reference. No thread may use the slot afterwards. */
+void juno_doc_slot_free(JunoDocSlot *slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_DOC_H */
@@ -0,0 +1,57 @@
+#ifndef JUNO_FILES_H
+#define JUNO_FILES_H
+
+/* Loading many files at once (C).
+ *
+ * juno_parse_files spreads a list of paths over a small pool of threads
+ * (the caller's thread included). On Linux each loader sets up its own
+ * io_uring and keeps several reads in flight, parsing every file as its read
+ * completes while the others proceed in the kernel; opens stay blocking.
+ * Where io_uring is missing or refused (old kernels, seccomp), or with
+ * JUNO_FILES_THREADS, each loader reads one file at a time with plain
+ * open/read and I/O overlaps with parsing across the threads instead.
+ * Text buffers are reused from file to file, not allocated per file.
+ * Build with -DJUNO_ENABLE_URING=0 to leave io_uring out.
+ */
+
+#include <juno/juno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef JUNO_FILES_MAX_THREADS
+#define JUNO_FILES_MAX_THREADS 64
+#endif
+
+#define JUNO_FILES_QUEUE_DEPTH     8
+#define JUNO_FILES_MAX_QUEUE_DEPTH 256
+
+typedef enum {
+    JUNO_FILES_AUTO = 0,   /* io_uring where available, else blocking reads */
+    JUNO_FILES_THREADS     /* blocking reads on the thread pool only */
+} JunoFilesBackend;
+
+/* Zero-initialize and set the fields you need. */
+typedef struct {
+    unsigned                threads;      /* concurrent loaders (0: online CPUs), capped at JUNO_FILES_MAX_THREADS */
+    const JunoParseOptions *parse;        /* applied to every file; NULL: defaults */
+    JunoFilesBackend        backend;
+    unsigned                queue_depth;  /* io_uring reads in flight per loader (0: JUNO_FILES_QUEUE_DEPTH),
+                                             capped at JUNO_FILES_MAX_QUEUE_DEPTH */
+} JunoFilesOptions;
+
+/* Parse the `n` files in `paths`. roots[i] receives the tree, heap-allocated
+ * (free with juno_free_ast), or NULL on failure; when `errs` is not NULL,
+ * errs[i] receives the per-file error (JUNO_ERR_IO for unreadable files).
+ * parse->arena and parse->stats are ignored, parse->limits->max_input is
+ * checked against the file size before reading, and parse->hooks are called
+ * from the worker threads. Returns the number of files parsed successfully. */
+size_t juno_parse_files(const char *const *paths, size_t n, const JunoFilesOptions *opts,
+                        JsonNode **roots, JunoError *errs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_FILES_H */
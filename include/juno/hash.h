@@ -0,0 +1,47 @@
+#ifndef JUNO_HASH_H
+#define JUNO_HASH_H
+
+/* Structural hashing and deep equality (C).
+ *
+ * Hashes describe content, not representation: object members are combined
+ * order-independently, numbers are hashed by value (1, 1.0 and 1e0 agree),
+ * and a document hashes the same whether it is a JsonNode tree (heap, arena,
+ * lazy numbers), a binary image or raw text fed to juno_hash_buffer.
+ * Hashes are 64-bit, unkeyed and native-endian: fine for caches and
+ * deduplication, not for persisting or for hostile inputs.
+ *
+ * Equality follows the same rules. Objects compare as multisets of members,
+ * so key order does not matter. Numbers compare by their double value once
+ * they are beyond int64, however they were parsed: lazy 10000000000000000000
+ * and 10000000000000000001 are equal, as they are parsed eagerly and as each
+ * is to 1e19. Only numbers a double cannot hold (lazy 1e400) compare by their
+ * text. Binary nodes (juno/base64.h) compare by their bytes and never equal a
+ * text string.
+ */
+
+#include <juno/juno.h>
+#include <juno/binary.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Hash of `len` bytes (the primitive behind the structural hashes). */
+uint64_t juno_hash_bytes(const void *data, size_t len, uint64_t seed);
+
+uint64_t juno_hash(const JsonNode *root);
+bool     juno_equal(const JsonNode *a, const JsonNode *b);
+
+/* Same for a node of a binary image. */
+uint64_t juno_bin_hash(const JunoBinDoc *doc, JunoBinRef ref);
+bool     juno_bin_equal(const JunoBinDoc *a, JunoBinRef ra, const JunoBinDoc *b, JunoBinRef rb);
+
+/* Hash the single JSON document in `json_str` without building a tree.
+ * Returns false (details in `err`) if the text is not valid JSON. */
+bool juno_hash_buffer(const char *json_str, size_t len, uint64_t *out, JunoError *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_HASH_H */
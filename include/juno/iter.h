@@ -0,0 +1,84 @@
+#ifndef JUNO_ITER_H
+#define JUNO_ITER_H
+
+/* Depth-first, non-recursive traversal of JsonNode trees and binary images (C).
+ *
+ * juno_iter_next reports containers twice (ENTER, then LEAVE after their
+ * children) and scalars once (VALUE), in document order. The iterator
+ * lives on the caller's stack and keeps its path in an inline stack deep
+ * enough for anything the parser accepts (JUNO_MAX_NESTING); only deeper,
+ * hand-built trees make it allocate. Nothing is allocated per node.
+ *
+ *     JunoIter it;
+ *     juno_iter_init(&it, root);
+ *     for (JunoIterEvent ev; (ev = juno_iter_next(&it)) != JUNO_ITER_END; ) {
+ *         if (ev == JUNO_ITER_ENTER && it.key && strcmp(it.key, "skip") == 0)
+ *             juno_iter_skip(&it);
+ *         ...
+ *     }
+ *     juno_iter_free(&it);
+ *
+ * The tree must not be modified while it is being iterated.
+ */
+
+#include <juno/juno.h>
+#include <juno/binary.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    JUNO_ITER_ENTER,   /* object or array, before its children */
+    JUNO_ITER_LEAVE,   /* the same container, after its children */
+    JUNO_ITER_VALUE,   /* string, number, bool, null or error node */
+    JUNO_ITER_END,     /* traversal finished */
+    JUNO_ITER_ERROR    /* out of memory growing the path (past JUNO_MAX_NESTING) */
+} JunoIterEvent;
+
+/* A node of either representation. */
+typedef union {
+    const JsonNode *node;
+    JunoBinRef      ref;
+} JunoIterPos;
+
+#define JUNO_ITER_INLINE_DEPTH (JUNO_MAX_NESTING + 1)
+
+typedef struct {
+    /* Current node, valid after ENTER / LEAVE / VALUE. */
+    JunoIterPos  pos;       /* .node for trees, .ref for binary images */
+    JNodeType    type;      /* JND_ROOT_OBJ is reported as JND_OBJ */
+    const char  *key;       /* member name inside objects ("" if unnamed), NULL elsewhere */
+    size_t       key_len;
+    unsigned     depth;     /* 0 for the root, children of a depth-d container at d + 1 */
+
+    /* Private. */
+    const JunoBinDoc *doc;  /* NULL when iterating a tree */
+    JunoIterPos  next;      /* node to report next, unless has_next is false */
+    bool         has_next;
+    unsigned     sp, cap;
+    JunoIterPos *heap;      /* path once it outgrows `path` */
+    JunoIterPos  path[JUNO_ITER_INLINE_DEPTH];
+} JunoIter;
+
+/* Iterate the tree under `root` (NULL: the iteration is empty). */
+void juno_iter_init(JunoIter *it, const JsonNode *root);
+
+/* Iterate a binary image from `root` (e.g. juno_bin_root(doc)). */
+void juno_iter_init_bin(JunoIter *it, const JunoBinDoc *doc, JunoBinRef root);
+
+JunoIterEvent juno_iter_next(JunoIter *it);
+
+/* After ENTER: do not descend; the next event is the container's LEAVE.
+ * No effect after other events. */
+void juno_iter_skip(JunoIter *it);
+
+/* Release the path if it grew onto the heap and end the iteration
+ * (safe to call on any initialized iterator, more than once). */
+void juno_iter_free(JunoIter *it);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_ITER_H */
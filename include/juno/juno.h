@@ -13,6 +13,9 @@
 
 #include <juno/version.h>
 
+/* Deepest container nesting accepted: arrays and objects count one level
+ * each, whatever encloses them. Objects used to count two levels (an object
+ * limit of about 32); see "Changes" in README.md. */
 #ifndef JUNO_MAX_NESTING
 #define JUNO_MAX_NESTING 64
 #endif
@@ -40,6 +43,9 @@ typedef struct JsonNode {
         int64_t ivalue;
         char   *svalue;
         char   *err_msg;
+        /* JND_OBJ / JND_ARRAY: last child, library-internal tail cache for
+         * O(1) appends. Only meaningful while JND_FLAG_TAIL is set. */
+        struct JsonNode *last_child;
     } value;
 
     struct JsonNode *first_child;
@@ -52,14 +58,212 @@ typedef struct JsonNode {
 
     /* Valid only for JND_NUMBER: true => ivalue is set, false => nvalue is set */
     bool is_integer;
+
+    /* JND_FLAG_* bits describing how the node is stored */
+    uint8_t flags;
 } JsonNode;
 
+/* Node (and its strings) live in a JunoArena: juno_free_ast leaves it alone. */
+#define JND_FLAG_ARENA 0x01u
+
+/* JND_NUMBER holding its source text in value.svalue instead of a converted
+ * value (JUNO_PARSE_LAZY_NUMBERS); read it through the juno_number_* getters.
+ * `is_integer` then only says the text has no fraction or exponent. */
+#define JND_FLAG_RAW_NUMBER 0x02u
+
+/* JND_STRING holding decoded base64 bytes instead of text (parse option
+ * JunoParseOptions.base64_keys); read them with juno_binary (juno/base64.h).
+ * JND_FLAG_BASE64URL records the alphabet the writers re-encode with. */
+#define JND_FLAG_BINARY    0x04u
+#define JND_FLAG_BASE64URL 0x08u
+
+/* Container whose value.last_child the library keeps up to date (parsers,
+ * builder, patch, juno_compact). Appends to containers without it walk from
+ * first_child. Code that relinks the children of a flagged container through
+ * first_child / next_sibling by hand must clear this bit. */
+#define JND_FLAG_TAIL 0x10u
+
+/* Chunked bump allocator. Trees parsed into an arena are released all at
+ * once by juno_arena_reset / juno_arena_free, never by juno_free_ast. */
+typedef struct JunoArena JunoArena;
+
+/* Error codes reported through JunoError. */
+typedef enum {
+    JUNO_OK = 0,
+    JUNO_ERR_INVALID_ARG,      /* NULL input / filename */
+    JUNO_ERR_OOM,              /* allocation failed */
+    JUNO_ERR_IO,               /* file could not be opened or read */
+    JUNO_ERR_UNEXPECTED_TOKEN, /* grammar violation (missing ',' / ':' / ...) */
+    JUNO_ERR_UNEXPECTED_EOF,   /* input ended inside a value */
+    JUNO_ERR_INVALID_STRING,   /* bad escape, control char, unterminated string */
+    JUNO_ERR_INVALID_NUMBER,   /* number that violates the RFC 8259 grammar */
+    JUNO_ERR_INVALID_LITERAL,  /* misspelled true / false / null, stray character */
+    JUNO_ERR_NESTING,          /* depth exceeded JUNO_MAX_NESTING */
+    JUNO_ERR_TOKEN_TOO_LARGE,  /* streaming: a single token does not fit the reader window */
+    JUNO_ERR_BINARY_FORMAT,    /* binary image: bad magic, version, size or checksum */
+    JUNO_ERR_PATH_NOT_FOUND,   /* JSON Pointer names a location that does not exist */
+    JUNO_ERR_TEST_FAILED,      /* JSON Patch "test" operation did not match */
+    JUNO_ERR_DUPLICATE_KEY,    /* repeated member name under JUNO_DUP_REJECT */
+    JUNO_ERR_INPUT_TOO_LARGE,  /* JunoLimits.max_input */
+    JUNO_ERR_TOO_MANY_NODES,   /* JunoLimits.max_nodes */
+    JUNO_ERR_STRING_TOO_LONG,  /* JunoLimits.max_string */
+    JUNO_ERR_ALLOC_LIMIT,      /* JunoLimits.max_alloc */
+    JUNO_ERR_TOO_MANY_MEMBERS, /* JunoLimits.max_members */
+    JUNO_ERR_NUMBER_TOO_LONG,  /* JunoLimits.max_digits */
+    JUNO_ERR_SCHEMA            /* value violates a JunoSchema (juno/schema.h) */
+} JunoErrorCode;
+
+/* Structured parse error, filled by the *_ex entry points without allocating.
+ * `msg` always points to a static string. `offset` is the byte offset of the
+ * offending token in the input and `depth` the container depth at which the
+ * innermost error was detected. Use juno_error_format() to get line, column
+ * and a source snippet only when a human-readable message is actually needed. */
+typedef struct {
+    JunoErrorCode code;
+    size_t        offset;
+    unsigned      depth;
+    const char   *msg;
+} JunoError;
+
 /* Parse JSON from a buffer (not necessarily NUL-terminated). */
 JsonNode* juno_parse(const char *json_str, size_t len);
 
 /* Parse JSON from file (loads whole file). Returns JND_ERROR on failure. */
 JsonNode* juno_parse_file(const char *filename);
 
+/* Same as juno_parse, but errors are reported through `err` (may be NULL)
+ * and the function returns NULL instead of allocating a JND_ERROR node. */
+JsonNode* juno_parse_ex(const char *json_str, size_t len, JunoError *err);
+
+/* Same as juno_parse_file, with errors reported through `err` (may be NULL). */
+JsonNode* juno_parse_file_ex(const char *filename, JunoError *err);
+
+/* Counters filled during a parse when JunoParseOptions.stats is set. The
+ * library must be built with JUNO_ENABLE_STATS (the default); with
+ * -DJUNO_ENABLE_STATS=0 the instrumentation is compiled out and the struct
+ * is left zeroed. Cycle counts come from the CPU timestamp counter where
+ * available (rdtsc / cntvct_el0) and include the cost of reading it. */
+typedef struct {
+    size_t   bytes_consumed;          /* input bytes the parser advanced over */
+    size_t   nodes[JND_ERROR + 1];    /* nodes created, indexed by JNodeType */
+    unsigned max_depth;               /* deepest container nesting reached */
+    size_t   string_bytes;            /* decoded UTF-8 bytes (values and keys) */
+    size_t   escaped_strings;         /* strings that contained escapes */
+    size_t   integers;                /* numbers stored as int64 */
+    size_t   doubles;                 /* numbers stored as double */
+    size_t   alloc_count;             /* allocations made by the parser */
+    size_t   alloc_bytes;
+    uint64_t lex_cycles;              /* tokenizing */
+    uint64_t decode_cycles;           /* string decoding and number conversion */
+    uint64_t build_cycles;            /* everything else (node building, bookkeeping) */
+    uint64_t total_cycles;
+} JunoStats;
+
+/* Tracing hooks invoked around every parse that carries them. */
+typedef struct {
+    void (*on_begin)(void *ud, const char *json_str, size_t len);
+    void (*on_end)(void *ud, const JunoStats *stats, const JunoError *err);
+    void *ud;
+} JunoHooks;
+
+/* JunoParseOptions.flags */
+#define JUNO_PARSE_LAZY_NUMBERS 0x1u  /* keep number text, convert on access (JND_FLAG_RAW_NUMBER) */
+#define JUNO_PARSE_BASE64URL    0x2u  /* base64_keys use the base64url alphabet */
+
+/* Repeated member names within one object (RFC 8259 only says they SHOULD
+ * be unique). Detection costs a short scan for small objects and a hash set
+ * on a per-parse scratch stack for wide ones, so it stays linear. */
+typedef enum {
+    JUNO_DUP_ALLOW = 0,   /* keep every member (default) */
+    JUNO_DUP_REJECT,      /* fail with JUNO_ERR_DUPLICATE_KEY */
+    JUNO_DUP_FIRST,       /* keep the first value; later ones are parsed and dropped */
+    JUNO_DUP_LAST         /* keep the last value, at the position of the first member */
+} JunoDupPolicy;
+
+/* Parser variant. Each is generated from one parser core with its checks
+ * fixed at compile time, so the hot loops carry no option tests and no
+ * line/column tracking. The specialized variants serve plain parses: with
+ * stats, hooks, limits, a duplicate policy, base64_keys or lazy numbers the
+ * default parser runs whatever the mode. */
+typedef enum {
+    JUNO_PARSE_MODE_FULL = 0,  /* the default parser, every option supported */
+    JUNO_PARSE_MODE_STRICT,    /* same results and errors (code, offset, depth) as FULL */
+    JUNO_PARSE_MODE_TRUSTED,   /* input known to be valid: raw control characters in
+                                  unescaped strings and leading zeros are let through */
+    JUNO_PARSE_MODE_DOUBLES    /* strict, but every number is stored as a double */
+} JunoParseMode;
+
+/* Per-parse resource limits for untrusted input; a zero field is no limit.
+ * Each limit has its own error code and is checked as the parse goes, so a
+ * hostile document fails as soon as it crosses one, before the work is done. */
+typedef struct {
+    size_t max_input;     /* input bytes, checked before parsing starts */
+    size_t max_nodes;     /* nodes created */
+    size_t max_string;    /* decoded bytes of one string or member name */
+    size_t max_alloc;     /* bytes allocated for nodes and strings */
+    size_t max_members;   /* members of one object / elements of one array */
+    size_t max_digits;    /* characters of one number token (sign and exponent included) */
+} JunoLimits;
+
+/* Parse options; zero-initialize and set the fields you need. */
+typedef struct {
+    JunoArena        *arena;       /* allocate nodes and strings from this arena (NULL: malloc) */
+    JunoStats        *stats;       /* filled (after being zeroed) when not NULL */
+    const JunoHooks  *hooks;       /* begin/end callbacks; on_end gets stats even if `stats` is NULL */
+    unsigned          flags;       /* JUNO_PARSE_* */
+    JunoDupPolicy     duplicates;  /* repeated member names */
+    const JunoLimits *limits;      /* NULL: only JUNO_MAX_NESTING applies */
+    const char *const *base64_keys; /* NULL-terminated member names whose string values
+                                       are decoded to binary nodes (JND_FLAG_BINARY) */
+    JunoParseMode     mode;        /* parser variant (see JunoParseMode) */
+} JunoParseOptions;
+
+/* juno_parse_ex with options (`opts` may be NULL). */
+JsonNode* juno_parse_opts(const char *json_str, size_t len, const JunoParseOptions *opts, JunoError *err);
+
+/* juno_parse_file_ex with options (`opts` may be NULL). */
+JsonNode* juno_parse_file_opts(const char *filename, const JunoParseOptions *opts, JunoError *err);
+
+/* Create an arena whose chunks are `chunk_size` bytes (0 selects a default). */
+JunoArena* juno_arena_new(size_t chunk_size);
+
+/* Invalidate everything allocated from the arena but keep its chunks for reuse. */
+void juno_arena_reset(JunoArena *arena);
+
+/* Release the arena and all of its chunks (safe on NULL). */
+void juno_arena_free(JunoArena *arena);
+
+/* Bytes currently handed out by the arena. */
+size_t juno_arena_used(const JunoArena *arena);
+
+/* Static, human-readable name of an error code. */
+const char* juno_error_str(JunoErrorCode code);
+
+/* Compute the 1-based line and column of `err->offset` inside `src`. */
+void juno_error_position(const JunoError *err, const char *src, size_t len,
+                         unsigned *line, unsigned *column);
+
+/* Format `err` as "Parse error at L:C" plus a caret snippet of the offending
+ * line into `out` (always NUL-terminated when out_len > 0). `src` may be NULL,
+ * in which case only the byte offset is reported. Returns the number of
+ * characters that would have been written, like snprintf. */
+int juno_error_format(const JunoError *err, const char *src, size_t len,
+                      char *out, size_t out_len);
+
+/* Typed number getters, valid for converted and raw (lazy) JND_NUMBER nodes.
+ * Raw nodes are converted on every call; nothing is cached in the node, so
+ * shared documents stay read-only. The integer getters fail for numbers with
+ * a fraction or exponent and for values out of range; juno_number_double
+ * fails when the value overflows a double (1e400) or underflows to a
+ * subnormal or zero (1e-400, 4.9e-324), the numbers the default parser
+ * rejects as invalid. */
+bool juno_number_int64(const JsonNode *node, int64_t *out);
+bool juno_number_uint64(const JsonNode *node, uint64_t *out);
+bool juno_number_double(const JsonNode *node, double *out);
+
+/* Source text of a raw number node (NULL for converted numbers). */
+const char* juno_number_raw(const JsonNode *node, size_t *len);
+
 /* Free an AST returned by juno_parse / juno_parse_file (safe on NULL). */
 void juno_free_ast(JsonNode *root);
 
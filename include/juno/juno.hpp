@@ -0,0 +1,335 @@
+#ifndef JUNO_HPP
+#define JUNO_HPP
+
+/* Header-only C++17 layer over the C API.
+ *
+ * juno::Document owns a parsed tree (move-only, frees it on destruction);
+ * juno::Value is a non-owning, pointer-sized view of one node. Neither copies
+ * strings or allocates: get<std::string_view>() points into the tree, child
+ * iteration follows the sibling links, and a missing member or element gives
+ * an empty Value, so lookups chain without checks in between:
+ *
+ *     using namespace juno::literals;
+ *     auto doc = juno::Document::parse(text);
+ *     if (!doc) return doc.error().code;
+ *     int64_t id = (*doc)["user"_k]["id"_k].get_or<int64_t>(-1);
+ *     for (juno::Value tag : (*doc)["tags"_k])
+ *         if (auto s = tag.get<std::string_view>()) use(*s);
+ *
+ * Fallible calls return juno::Result<T>, which is std::expected<T, JunoError>
+ * when the standard library has it (C++23) and a minimal stand-in with the
+ * same has_value / value / error / operator* interface otherwise.
+ *
+ * Views are valid as long as the Document (or arena) holding the tree.
+ */
+
+#include <juno/juno.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if __cplusplus > 202002L && __has_include(<expected>)
+#include <expected>
+#endif
+
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+#define JUNO_HPP_STD_EXPECTED 1
+#else
+#include <cassert>
+#include <optional>
+#endif
+
+namespace juno {
+
+using Error = JunoError;
+
+/* ------------------------------
+ * Result<T>
+ * ------------------------------ */
+
+#ifdef JUNO_HPP_STD_EXPECTED
+
+template <class T>
+using Result = std::expected<T, Error>;
+
+inline std::unexpected<Error> fail(const Error &e) noexcept { return std::unexpected<Error>(e); }
+
+#else
+
+struct Failure {
+    Error err;
+};
+
+inline Failure fail(const Error &e) noexcept { return Failure{e}; }
+
+template <class T>
+class Result {
+public:
+    Result(T v) noexcept(std::is_nothrow_move_constructible_v<T>) : v_(std::move(v)) {}
+    Result(Failure f) noexcept : err_(f.err) {}
+
+    bool has_value() const noexcept { return v_.has_value(); }
+    explicit operator bool() const noexcept { return v_.has_value(); }
+
+    /* Requires has_value(). */
+    T &value() & noexcept { assert(v_); return *v_; }
+    const T &value() const & noexcept { assert(v_); return *v_; }
+    T &&value() && noexcept { assert(v_); return std::move(*v_); }
+    T &operator*() & noexcept { return value(); }
+    const T &operator*() const & noexcept { return value(); }
+    T &&operator*() && noexcept { return std::move(*this).value(); }
+    T *operator->() noexcept { return &value(); }
+    const T *operator->() const noexcept { return &value(); }
+
+    template <class U>
+    T value_or(U &&fallback) const & { return v_ ? *v_ : static_cast<T>(std::forward<U>(fallback)); }
+
+    /* Requires !has_value(). */
+    const Error &error() const noexcept { return err_; }
+
+private:
+    std::optional<T> v_;
+    Error err_{};
+};
+
+#endif
+
+namespace detail {
+
+template <class>
+inline constexpr bool always_false = false;
+
+inline Error make_error(JunoErrorCode code, const char *msg) noexcept {
+    Error e{};
+    e.code = code;
+    e.msg = msg;
+    return e;
+}
+
+} // namespace detail
+
+/* ------------------------------
+ * Keys
+ * ------------------------------ */
+
+/* A member name with its length fixed up front. Built from a literal (or
+ * with "name"_k) the length is a compile-time constant, so a lookup costs
+ * one strncmp per candidate member and never a strlen of the key. */
+class Key {
+public:
+    constexpr Key(const char *s, std::size_t len) noexcept : s_(s), len_(len) {}
+    constexpr Key(std::string_view s) noexcept : s_(s.data()), len_(s.size()) {}
+    constexpr Key(const char *s) noexcept : s_(s), len_(std::char_traits<char>::length(s)) {}
+
+    constexpr const char *data() const noexcept { return s_; }
+    constexpr std::size_t size() const noexcept { return len_; }
+
+    /* True if the NUL-terminated member name `name` equals this key. */
+    bool matches(const char *name) const noexcept {
+        return std::strncmp(name, s_, len_) == 0 && name[len_] == '\0';
+    }
+
+private:
+    const char *s_;
+    std::size_t len_;
+};
+
+namespace literals {
+constexpr Key operator""_k(const char *s, std::size_t len) noexcept { return Key(s, len); }
+} // namespace literals
+
+/* ------------------------------
+ * Value
+ * ------------------------------ */
+
+class Value {
+public:
+    class iterator {
+    public:
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using reference = Value;
+        using pointer = void;
+        using iterator_category = std::forward_iterator_tag;
+
+        constexpr iterator() noexcept = default;
+        constexpr explicit iterator(const JsonNode *n) noexcept : n_(n) {}
+
+        Value operator*() const noexcept { return Value(n_); }
+        iterator &operator++() noexcept { n_ = n_->next_sibling; return *this; }
+        iterator operator++(int) noexcept { iterator t = *this; n_ = n_->next_sibling; return t; }
+        friend bool operator==(iterator a, iterator b) noexcept { return a.n_ == b.n_; }
+        friend bool operator!=(iterator a, iterator b) noexcept { return a.n_ != b.n_; }
+
+    private:
+        const JsonNode *n_ = nullptr;
+    };
+
+    constexpr Value() noexcept = default;
+    constexpr explicit Value(const JsonNode *n) noexcept : n_(n) {}
+
+    const JsonNode *node() const noexcept { return n_; }
+    explicit operator bool() const noexcept { return n_ != nullptr; }
+
+    /* JND_ROOT_OBJ is reported as JND_OBJ; an empty Value reports JND_ERROR. */
+    JNodeType type() const noexcept {
+        if (!n_) return JND_ERROR;
+        return n_->type == JND_ROOT_OBJ ? JND_OBJ : n_->type;
+    }
+    bool is_object() const noexcept { return type() == JND_OBJ; }
+    bool is_array() const noexcept  { return type() == JND_ARRAY; }
+    bool is_string() const noexcept { return type() == JND_STRING; }
+    bool is_number() const noexcept { return type() == JND_NUMBER; }
+    bool is_bool() const noexcept   { return type() == JND_BOOL; }
+    bool is_null() const noexcept   { return n_ && n_->type == JND_NULL; }
+
+    /* Member name when this is an object member, "" otherwise. */
+    std::string_view key() const noexcept {
+        return n_ && n_->key ? std::string_view(n_->key) : std::string_view();
+    }
+
+    /* Children of an object or array; empty for anything else. */
+    iterator begin() const noexcept { return iterator(is_container() ? n_->first_child : nullptr); }
+    iterator end() const noexcept { return iterator(); }
+    std::size_t size() const noexcept {
+        std::size_t n = 0;
+        for (iterator it = begin(); it != end(); ++it) n++;
+        return n;
+    }
+
+    /* First member named `k` (empty Value if absent or not an object). */
+    Value operator[](Key k) const noexcept {
+        if (!is_object()) return Value();
+        for (const JsonNode *c = n_->first_child; c; c = c->next_sibling)
+            if (c->key && k.matches(c->key)) return Value(c);
+        return Value();
+    }
+
+    /* Element `i` of an array (empty Value if out of range or not an array). */
+    Value operator[](std::size_t i) const noexcept {
+        if (!is_array()) return Value();
+        const JsonNode *c = n_->first_child;
+        while (c && i--) c = c->next_sibling;
+        return Value(c);
+    }
+
+    /* Typed access: bool, any arithmetic type (range-checked), std::string_view
+     * and const char* (both pointing into the tree). Fails with
+     * JUNO_ERR_PATH_NOT_FOUND on an empty Value, JUNO_ERR_INVALID_ARG on a type
+     * mismatch and JUNO_ERR_INVALID_NUMBER when the number does not fit T. */
+    template <class T>
+    Result<T> get() const noexcept {
+        if (!n_) return fail(detail::make_error(JUNO_ERR_PATH_NOT_FOUND, "no such value"));
+
+        if constexpr (std::is_same_v<T, bool>) {
+            if (n_->type == JND_BOOL) return n_->value.bvalue;
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            if (is_text())
+                return n_->value.svalue ? std::string_view(n_->value.svalue) : std::string_view();
+        } else if constexpr (std::is_same_v<T, const char *>) {
+            if (is_text()) return static_cast<const char *>(n_->value.svalue ? n_->value.svalue : "");
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            int64_t v;
+            if (n_->type == JND_NUMBER) {
+                if (juno_number_int64(n_, &v) && v >= std::numeric_limits<T>::min() &&
+                    v <= std::numeric_limits<T>::max())
+                    return static_cast<T>(v);
+                return fail(detail::make_error(JUNO_ERR_INVALID_NUMBER, "number does not fit the type"));
+            }
+        } else if constexpr (std::is_integral_v<T>) {
+            uint64_t v;
+            if (n_->type == JND_NUMBER) {
+                if (juno_number_uint64(n_, &v) && v <= std::numeric_limits<T>::max())
+                    return static_cast<T>(v);
+                return fail(detail::make_error(JUNO_ERR_INVALID_NUMBER, "number does not fit the type"));
+            }
+        } else if constexpr (std::is_floating_point_v<T>) {
+            double v;
+            if (n_->type == JND_NUMBER) {
+                if (juno_number_double(n_, &v)) return static_cast<T>(v);
+                return fail(detail::make_error(JUNO_ERR_INVALID_NUMBER, "number does not fit the type"));
+            }
+        } else {
+            static_assert(detail::always_false<T>, "juno::Value::get: unsupported type");
+        }
+        return fail(detail::make_error(JUNO_ERR_INVALID_ARG, "type mismatch"));
+    }
+
+    template <class T>
+    T get_or(T fallback) const noexcept {
+        Result<T> r = get<T>();
+        return r ? *r : fallback;
+    }
+
+private:
+    bool is_container() const noexcept {
+        JNodeType t = type();
+        return t == JND_OBJ || t == JND_ARRAY;
+    }
+
+    /* Strings holding text (binary nodes keep bytes, see juno/base64.h). */
+    bool is_text() const noexcept { return n_->type == JND_STRING && !(n_->flags & JND_FLAG_BINARY); }
+
+    const JsonNode *n_ = nullptr;
+};
+
+/* ------------------------------
+ * Document
+ * ------------------------------ */
+
+class Document {
+public:
+    Document() noexcept = default;
+    /* Adopts a tree from juno_parse_* or the builder (heap or arena). */
+    explicit Document(JsonNode *root) noexcept : root_(root) {}
+    ~Document() { juno_free_ast(root_); }
+
+    Document(Document &&o) noexcept : root_(std::exchange(o.root_, nullptr)) {}
+    Document &operator=(Document &&o) noexcept {
+        if (this != &o) {
+            juno_free_ast(root_);
+            root_ = std::exchange(o.root_, nullptr);
+        }
+        return *this;
+    }
+    Document(const Document &) = delete;
+    Document &operator=(const Document &) = delete;
+
+    /* juno_parse_opts / juno_parse_file_opts; `opts` may be nullptr. With an
+     * arena in `opts` the Document only borrows the tree (the arena owns it). */
+    static Result<Document> parse(std::string_view text, const JunoParseOptions *opts = nullptr) noexcept {
+        Error err;
+        JsonNode *root = juno_parse_opts(text.data(), text.size(), opts, &err);
+        if (!root) return fail(err);
+        return Document(root);
+    }
+    static Result<Document> parse_file(const char *path, const JunoParseOptions *opts = nullptr) noexcept {
+        Error err;
+        JsonNode *root = juno_parse_file_opts(path, opts, &err);
+        if (!root) return fail(err);
+        return Document(root);
+    }
+
+    Value root() const noexcept { return Value(root_); }
+    JsonNode *get() const noexcept { return root_; }
+    JsonNode *release() noexcept { return std::exchange(root_, nullptr); }
+    explicit operator bool() const noexcept { return root_ != nullptr; }
+
+    Value operator[](Key k) const noexcept { return root()[k]; }
+    Value operator[](std::size_t i) const noexcept { return root()[i]; }
+    Value::iterator begin() const noexcept { return root().begin(); }
+    Value::iterator end() const noexcept { return root().end(); }
+
+private:
+    JsonNode *root_ = nullptr;
+};
+
+} // namespace juno
+
+#endif /* JUNO_HPP */
@@ -0,0 +1,59 @@
+#ifndef JUNO_PATCH_H
+#define JUNO_PATCH_H
+
+/* JSON Patch (RFC 6902), JSON Merge Patch (RFC 7386) and tree diff (C).
+ *
+ * Patches edit a JsonNode tree in place. Every JSON Pointer step is a member
+ * or element lookup; with a JunoIndex those are O(1) on large containers, so
+ * applying a patch costs in proportion to the patch, not to the document.
+ * Same allocator rules as juno/builder.h: `arena` is the arena the target
+ * tree lives in (NULL for a heap tree) and receives every node the patch adds.
+ *
+ * Application is atomic: when an operation fails, the operations before it
+ * are rolled back and the tree is left exactly as it was. Errors report the
+ * zero-based index of the failing operation in `err->offset`.
+ */
+
+#include <juno/juno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Lookup tables for the containers of one tree, built lazily for objects
+ * and arrays with many children and kept up to date by the functions below.
+ * After editing the tree any other way (builder, hand linking, freeing
+ * subtrees), call juno_index_clear before using the index again. */
+typedef struct JunoIndex JunoIndex;
+
+JunoIndex* juno_index_new(void);               /* NULL on OOM */
+void       juno_index_clear(JunoIndex *idx);
+void       juno_index_free(JunoIndex *idx);    /* safe on NULL */
+
+/* Value at JSON Pointer `ptr` ("" is the root), or NULL. `idx` may be NULL. */
+JsonNode* juno_pointer_get(JunoIndex *idx, const JsonNode *root, const char *ptr);
+
+/* Apply the RFC 6902 operation array `patch` to *root (which "add" / "replace"
+ * at "" may swap for a new root). `idx` may be NULL. Fails with
+ * JUNO_ERR_PATH_NOT_FOUND, JUNO_ERR_TEST_FAILED, JUNO_ERR_INVALID_ARG
+ * (malformed operation or pointer) or JUNO_ERR_OOM. */
+bool juno_patch_apply(JunoArena *arena, JsonNode **root, const JsonNode *patch,
+                      JunoIndex *idx, JunoError *err);
+
+/* Apply the RFC 7386 merge patch `patch` to *root. Fails with JUNO_ERR_OOM,
+ * or JUNO_ERR_INVALID_ARG for a NULL root or patch and for an arena tree
+ * passed without its arena. */
+bool juno_merge_patch(JunoArena *arena, JsonNode **root, const JsonNode *patch,
+                      JunoIndex *idx, JunoError *err);
+
+/* RFC 6902 patch turning `from` into `to`, allocated in `arena` (NULL: heap).
+ * Objects are diffed member by member and arrays after trimming their common
+ * prefix and suffix, so single-run inserts and deletes give one operation
+ * per element. Values compare like juno_equal. NULL on OOM. */
+JsonNode* juno_diff(JunoArena *arena, const JsonNode *from, const JsonNode *to, JunoError *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_PATCH_H */
@@ -0,0 +1,44 @@
+#ifndef JUNO_PROJECTION_H
+#define JUNO_PROJECTION_H
+
+/* Projection parsing (C).
+ *
+ * A projection is a compiled set of key paths. juno_parse_projected builds a
+ * JsonNode tree that only contains the values reachable through those paths;
+ * everything else is skipped without decoding strings or converting numbers.
+ * Skipped values are still checked against the grammar (separators, literals,
+ * number syntax, string escapes), so input juno_parse rejects is rejected
+ * here too, with the same error code and offset.
+ *
+ * Path syntax: member names separated by '.', and "[*]" for every element of
+ * an array, e.g. "params.user.id", "params.items[*].sku" or "[*].id" for a
+ * root array. The value at the end of a path is materialized in full.
+ */
+
+#include <juno/juno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct JunoProjection JunoProjection;
+
+/* Compile `n` paths. On a malformed path returns NULL and sets err->offset to
+ * the offending byte within that path and err->depth to its index. */
+JunoProjection* juno_projection_new(const char *const *paths, size_t n, JunoError *err);
+
+void juno_projection_free(JunoProjection *proj);
+
+/* Parse `json_str` keeping only the projected paths. Containers on a path are
+ * kept even when none of their projected members is present; array elements
+ * whose type does not match the rest of the path are dropped. If the root
+ * value itself does not match, a JND_NULL node is returned. Returns NULL on
+ * error (see `err`). Free the result with juno_free_ast. */
+JsonNode* juno_parse_projected(const char *json_str, size_t len,
+                               const JunoProjection *proj, JunoError *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_PROJECTION_H */
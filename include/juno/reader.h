@@ -0,0 +1,124 @@
+#ifndef JUNO_READER_H
+#define JUNO_READER_H
+
+/* Bounded-memory streaming reader (C).
+ *
+ * A JunoReader pulls input from a file descriptor, a FILE*, a user callback
+ * or a memory buffer through a fixed-size window and produces either pull
+ * events (SAX/cursor style) or a sequence of whole documents (NDJSON and
+ * concatenated JSON). Only one window of input is held at a time; tokens
+ * that straddle the window boundary are carried over when it is refilled.
+ */
+
+#include <stdio.h>
+
+#include <juno/juno.h>
+#include <juno/writer.h>
+
+#ifndef JUNO_READER_DEFAULT_BUFSIZE
+#define JUNO_READER_DEFAULT_BUFSIZE (64 * 1024)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct JunoReader JunoReader;
+
+/* Input callback: fill up to `cap` bytes of `buf`. Returns the number of
+ * bytes read, 0 at end of input, or a negative value on error. */
+typedef ptrdiff_t (*JunoReadFn)(void *ud, char *buf, size_t cap);
+
+typedef enum {
+    JEV_ERROR = 0,  /* see juno_reader_error() */
+    JEV_OBJ_BEGIN,
+    JEV_OBJ_END,
+    JEV_ARR_BEGIN,
+    JEV_ARR_END,
+    JEV_KEY,        /* object member name, in `str` */
+    JEV_STRING,
+    JEV_NUMBER,     /* raw text in `raw`, see juno_event_int64/juno_event_double */
+    JEV_BOOL,
+    JEV_NULL,
+    JEV_DOC_END,    /* a top-level value has been completed */
+    JEV_EOF,        /* clean end of input between documents */
+    JEV_STRING_PART /* leading part of a long string value, see juno_reader_set_string_parts */
+} JunoEventType;
+
+/* A single reader event. Pointers are valid until the next call on the reader. */
+typedef struct {
+    JunoEventType type;
+    unsigned      depth;     /* container depth: 1 for the root container and its direct members */
+    size_t        offset;    /* absolute byte offset of the token in the stream */
+    const char   *str;       /* KEY / STRING: decoded, NUL-terminated UTF-8 */
+    size_t        str_len;
+    const char   *raw;       /* token text as it appears in the input (strings include quotes) */
+    size_t        raw_len;
+    bool          bvalue;    /* BOOL */
+} JunoEvent;
+
+/* Create a reader. `bufsize` is the window size in bytes (0 selects
+ * JUNO_READER_DEFAULT_BUFSIZE) and bounds the largest single token.
+ * The fd / FILE* is not closed by juno_reader_free. */
+JunoReader* juno_reader_new_fd(int fd, size_t bufsize);
+JunoReader* juno_reader_new_file(FILE *fp, size_t bufsize);
+JunoReader* juno_reader_new_cb(JunoReadFn read_fn, void *ud, size_t bufsize);
+
+/* Reader over an in-memory buffer (no copy; `data` must outlive the reader). */
+JunoReader* juno_reader_new_mem(const char *data, size_t len);
+
+void juno_reader_free(JunoReader *r);
+
+/* Pull the next event. Returns ev->type. After JEV_ERROR or JEV_EOF every
+ * further call returns the same type. */
+JunoEventType juno_reader_next(JunoReader *r, JunoEvent *ev);
+
+/* Deliver string values in parts of at most `max_part` decoded bytes (0, the
+ * default, restores whole strings). A longer value, or one that does not fit
+ * the window, arrives as one or more JEV_STRING_PART events followed by a
+ * JEV_STRING carrying the last part (possibly empty); the value is the
+ * concatenation of their `str`. Escapes and UTF-8 sequences are never split
+ * between parts, so strings of any size stream through the window. `raw` of a
+ * part is its source text without quotes; a string delivered whole keeps the
+ * usual raw token. Member names and juno_reader_next_document are unaffected.
+ * `max_part` is raised to 16 and capped at half the window. */
+void juno_reader_set_string_parts(JunoReader *r, size_t max_part);
+
+/* After JEV_OBJ_BEGIN / JEV_ARR_BEGIN: consume events up to and including the
+ * matching end event. Returns false on error. */
+bool juno_reader_skip(JunoReader *r);
+
+/* Build the next top-level value of the stream into a JsonNode tree (free it
+ * with juno_free_ast). Returns NULL at end of input (err->code == JUNO_OK)
+ * or on error. */
+JsonNode* juno_reader_next_document(JunoReader *r, JunoError *err);
+
+/* Error that stopped the reader (code == JUNO_OK if none). */
+const JunoError* juno_reader_error(const JunoReader *r);
+
+/* Re-emit every document of the stream through `fn` without building a
+ * tree: minified when `indent` is 0, otherwise pretty-printed with `indent`
+ * spaces per level ("key": value, empty containers as {} and []). Input is
+ * fully validated; string and number tokens are copied verbatim, so escapes
+ * and number spellings survive unchanged (strings are checked, never
+ * decoded). Documents are separated by a
+ * newline. Memory stays at the reader window plus O(depth); with
+ * juno_reader_set_string_parts, strings longer than the window pass as well.
+ * On failure `err` (may be NULL) holds the reader's error (offset in the
+ * input) or JUNO_ERR_IO if the sink refused. */
+bool juno_reformat(JunoReader *r, unsigned indent, JunoWriteFn fn, void *ud, JunoError *err);
+
+/* juno_reformat over an in-memory buffer. */
+bool juno_reformat_buffer(const char *json_str, size_t len, unsigned indent,
+                          JunoWriteFn fn, void *ud, JunoError *err);
+
+/* Convert a JEV_NUMBER event. juno_event_int64 fails for fractions, exponents
+ * and values outside int64. */
+bool juno_event_int64(const JunoEvent *ev, int64_t *out);
+bool juno_event_double(const JunoEvent *ev, double *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_READER_H */
@@ -0,0 +1,67 @@
+#ifndef JUNO_SCHEMA_H
+#define JUNO_SCHEMA_H
+
+/* Compiled JSON Schema validation (C).
+ *
+ * juno_schema_compile turns a schema document into a compact program: per
+ * subschema a type mask, numeric bounds and, for objects, a hash table of
+ * member names with the required ones numbered as bits. juno_schema_parse
+ * runs it inside the parser, so a document is rejected at the first value
+ * that violates it, before the rest is read: a wrong container type before
+ * its contents, a member that additionalProperties forbids before its value,
+ * an array as soon as it exceeds maxItems. juno_schema_validate runs the same
+ * checks over a tree that is already parsed.
+ *
+ * Supported keywords: type (name or list of names), properties, required,
+ * additionalProperties (boolean or schema), items (one schema), enum,
+ * minimum, maximum, exclusiveMinimum, exclusiveMaximum (numbers), minLength,
+ * maxLength, minItems, maxItems, and the boolean schemas true / false.
+ * Annotations ($schema, $id, $comment, title, description, default,
+ * examples) are ignored; any other keyword fails the compile rather than
+ * being silently skipped.
+ */
+
+#include <juno/juno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef JUNO_SCHEMA_POINTER_MAX
+#define JUNO_SCHEMA_POINTER_MAX 256
+#endif
+
+typedef struct JunoSchema JunoSchema;
+
+/* A failed compile, parse or validation. `error` is JUNO_ERR_SCHEMA for a
+ * violation, with the offset of the failing value in the input (0 for
+ * juno_schema_validate), or the parse / compile error otherwise. */
+typedef struct JunoSchemaError {
+    JunoError   error;
+    char        pointer[JUNO_SCHEMA_POINTER_MAX];  /* RFC 6901 pointer of the failing value ("" for
+                                                      the root); into the schema for compile errors */
+    bool        truncated;  /* outer segments did not fit and were left out */
+    const char *member;     /* the missing member for a `required` violation, else NULL */
+} JunoSchemaError;
+
+/* Compile a schema (the tree is not kept). NULL with err set if the schema
+ * uses an unsupported keyword or an invalid value for one. */
+JunoSchema* juno_schema_compile(const JsonNode *schema, JunoSchemaError *err);
+
+/* Safe on NULL. */
+void juno_schema_free(JunoSchema *schema);
+
+/* juno_parse_opts, validating as it goes (`opts` may be NULL; its mode is
+ * ignored, the default parser runs). NULL with err set on a parse error or
+ * the first violation. */
+JsonNode* juno_schema_parse(const JunoSchema *schema, const char *json_str, size_t len,
+                            const JunoParseOptions *opts, JunoSchemaError *err);
+
+/* Check an existing tree. */
+bool juno_schema_validate(const JunoSchema *schema, const JsonNode *root, JunoSchemaError *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_SCHEMA_H */
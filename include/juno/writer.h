@@ -0,0 +1,54 @@
+#ifndef JUNO_WRITER_H
+#define JUNO_WRITER_H
+
+/* Serializing JsonNode trees to JSON text (C).
+ *
+ * Output is compact RFC 8259 JSON. Strings are escaped minimally (quote,
+ * backslash and control characters); integers are written exactly and
+ * doubles with the fewest digits that read back to the same value, always
+ * with a fraction or exponent so they parse back as doubles. Raw numbers
+ * (JND_FLAG_RAW_NUMBER) are copied verbatim. Non-finite doubles and
+ * JND_ERROR nodes cannot be represented and fail the write.
+ */
+
+#include <juno/juno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Output sink: consume `len` bytes, return false to abort the write. Data is
+ * staged in an internal buffer and handed over in blocks of a few KB. */
+typedef bool (*JunoWriteFn)(void *ud, const char *data, size_t len);
+
+/* Serialize `root` through `fn`. On failure `err` (may be NULL) receives
+ * JUNO_ERR_IO (sink refused), JUNO_ERR_INVALID_NUMBER (NaN / infinity),
+ * JUNO_ERR_INVALID_ARG (NULL / JND_ERROR node) or JUNO_ERR_NESTING. */
+bool juno_write(const JsonNode *root, JunoWriteFn fn, void *ud, JunoError *err);
+
+/* Serialize `root` into a malloc'd NUL-terminated string; *len (may be NULL)
+ * receives its length. Returns NULL on failure. */
+char* juno_stringify(const JsonNode *root, size_t *len, JunoError *err);
+
+/* Canonical JSON (RFC 8785, JCS): members sorted by their UTF-16 code
+ * units, no whitespace, minimal string escaping and numbers formatted as
+ * ECMAScript Number-to-String (every number is taken as a double, so
+ * integers beyond 2^53 and raw numbers are rounded). Duplicate member
+ * names, NaN and infinity fail with JUNO_ERR_INVALID_ARG /
+ * JUNO_ERR_INVALID_NUMBER. The tree is not copied or modified; members are
+ * ordered through a scratch index. */
+bool  juno_write_canonical(const JsonNode *root, JunoWriteFn fn, void *ud, JunoError *err);
+char* juno_stringify_canonical(const JsonNode *root, size_t *len, JunoError *err);
+
+/* Canonicalize JSON text without building a tree. Extra memory is bounded by
+ * the member index of the objects currently open (one entry plus the decoded
+ * name per member), not by the document size; nested values are re-scanned
+ * from the input instead of being buffered. Parse errors are reported with
+ * their byte offset in `json_str`. */
+bool  juno_canonicalize(const char *json_str, size_t len, JunoWriteFn fn, void *ud, JunoError *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JUNO_WRITER_H */
@@ -21,12 +21,313 @@
 #define JUNO_ERROR_MSG_DEFAULT "unspecified error"
 #endif
 
-void juno_error_set_msg(JsonNode *err_node, const char *err_msg);
-JsonNode* juno_error(const char *err_msg, const JToken *curr_tok);
+#ifndef JUNO_ENABLE_STATS
+#define JUNO_ENABLE_STATS 1
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t juno_cycles(void) { return __rdtsc(); }
+#elif defined(__aarch64__)
+static inline uint64_t juno_cycles(void) {
+    uint64_t v;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+}
+#else
+#include <time.h>
+static inline uint64_t juno_cycles(void) { return (uint64_t)clock(); }
+#endif
+
+#ifndef JUNO_ARENA_CHUNK_SIZE
+#define JUNO_ARENA_CHUNK_SIZE (64 * 1024)
+#endif
+
+/* ------------------------------
+ * Arena
+ * ------------------------------ */
+
+typedef struct JArenaChunk {
+    struct JArenaChunk *next;
+    size_t              size;   /* usable bytes in data[] */
+    size_t              used;
+    unsigned char       data[];
+} JArenaChunk;
+
+struct JunoArena {
+    JArenaChunk *first;
+    JArenaChunk *cur;          /* chunk currently being filled */
+    size_t       chunk_size;
+    void        *last;         /* most recent allocation, for juno_arena_shrink_last */
+};
+
+/* Position in an arena, used to drop the allocations of a failed parse. */
+typedef struct {
+    JArenaChunk *chunk;
+    size_t       used;
+} JArenaMark;
+
+/* 8-byte aligned, uninitialized memory (NULL on OOM). */
+void* juno_arena_alloc(JunoArena *a, size_t size);
+
+/* Give back the tail of the most recent allocation `p`. */
+void juno_arena_shrink_last(JunoArena *a, void *p, size_t new_size);
+
+JArenaMark juno_arena_mark(const JunoArena *a);
+void juno_arena_rewind(JunoArena *a, JArenaMark mark);
+
+/* Bytes held by the arena's chunks (what juno_arena_free gives back). */
+size_t juno_arena_footprint(const JunoArena *a);
+
+/* ------------------------------
+ * Parser
+ * ------------------------------ */
+
+/* Member of an object's duplicate-name set. */
+typedef struct {
+    uint32_t  hash;
+    JsonNode *member;   /* NULL: empty slot */
+} JKeySlot;
+
+/* Scratch stack holding the name sets of the objects being parsed: each
+ * object's set sits above its parent's and is popped when it closes, so the
+ * memory is reused across objects and only grows with the widest nesting. */
+typedef struct {
+    JKeySlot *slots;
+    size_t    len, cap;
+} JKeyStack;
+
+/* Parser state shared by the recursive descent functions. */
+typedef struct {
+    JLexer        lx;
+    JunoError     err;     /* innermost error, code == JUNO_OK while parsing succeeds */
+    JunoArena    *arena;   /* node / string storage, NULL for malloc */
+    JunoStats    *stats;   /* NULL unless statistics were requested */
+    unsigned      flags;   /* JUNO_PARSE_* */
+    JunoDupPolicy dups;
+    JKeyStack     keys;    /* used unless dups == JUNO_DUP_ALLOW */
+    JunoLimits    lim;     /* unset limits are SIZE_MAX, so checks are one compare */
+    size_t        nodes;   /* nodes created, against lim.max_nodes */
+    size_t        alloc;   /* bytes allocated, against lim.max_alloc */
+    const char *const *b64_keys;  /* JunoParseOptions.base64_keys */
+    bool          b64_next;       /* the value being parsed belongs to one of them */
+    const struct JSNode     *sch_next;  /* compiled schema of the value about to be parsed */
+    struct JunoSchemaError  *sch_err;   /* receives the JSON Pointer of a violation */
+} JParser;
+
+void juno_parser_init(JParser *ps, const char *data, size_t len);
+void juno_parser_set_options(JParser *ps, const JunoParseOptions *opts);
+
+/* Apply `lim` (NULL: none) and reset the counters checked against it. */
+void juno_parser_set_limits(JParser *ps, const JunoLimits *lim);
+
+/* Release the parser's scratch memory (the parser can be reused after). */
+void juno_parser_free_scratch(JParser *ps);
+
+/* Run `stmt` with `st_` bound to the parser's stats, if any. */
+#if JUNO_ENABLE_STATS
+#define JUNO_STAT(ps, stmt) do { JunoStats *st_ = (ps)->stats; if (st_) { stmt; } } while (0)
+#else
+#define JUNO_STAT(ps, stmt) do { } while (0)
+#endif
+
+/* Next token, with its cost charged to the lex phase when stats are on. */
+static inline JToken juno_ps_next(JParser *ps) {
+#if JUNO_ENABLE_STATS
+    if (ps->stats) {
+        uint64_t t0 = juno_cycles();
+        JToken t = jl_next(&ps->lx);
+        ps->stats->lex_cycles += juno_cycles() - t0;
+        return t;
+    }
+#endif
+    return jl_next(&ps->lx);
+}
+
+/* Parse entry/exit bookkeeping shared by every entry point: zero the stats,
+ * fire hooks, and record `consumed` bytes plus total / build cycles at the end. */
+typedef struct {
+    const JunoHooks *hooks;
+    JunoStats        local;   /* used when hooks are set but opts->stats is not */
+    uint64_t         t0;
+} JParseScope;
+
+void juno_parse_begin(JParser *ps, JParseScope *scope, const JunoParseOptions *opts,
+                      const char *json_str, size_t len);
+void juno_parse_end(JParser *ps, JParseScope *scope, size_t consumed);
+
+/* Allocation helpers honouring ps->arena and the limits. A limit they trip
+ * is recorded at `at` (the token start) and the caller's `depth`. */
+JsonNode* juno_ps_node(JParser *ps, JNodeType type, const char *at, unsigned depth);
+char* juno_ps_string(JParser *ps, const JToken *tok, const char **err_msg, unsigned depth);
+char* juno_ps_strdup(JParser *ps, const char *s, size_t len, unsigned depth);
+void  juno_ps_release(JParser *ps, void *p);
+
+/* Record an error unless one is already set (the innermost error wins).
+ * `at` points inside the input buffer, NULL means "current lexer position".
+ * Always returns NULL so callers can `return juno_fail(...)`. */
+JsonNode* juno_fail(JParser *ps, JunoErrorCode code, const char *msg, const char *at, unsigned depth);
+
+/* Count `n` bytes against lim.max_alloc; records JUNO_ERR_ALLOC_LIMIT at
+ * `at` / `depth` and returns false when they do not fit. */
+static inline bool juno_ps_charge(JParser *ps, size_t n, const char *at, unsigned depth) {
+    if (n > ps->lim.max_alloc - ps->alloc) {
+        juno_fail(ps, JUNO_ERR_ALLOC_LIMIT, NULL, at, depth);
+        return false;
+    }
+    ps->alloc += n;
+    return true;
+}
+
+/* Build a legacy JND_ERROR node (with formatted message) from `err`. */
+JsonNode* juno_error_node(const JunoError *err, const char *src, size_t len);
+
+/* Allocate a zeroed node of the given type (NULL on OOM). */
+JsonNode* juno_create_node(JNodeType type);
+
+/* Last child of container `c`: the cached tail under JND_FLAG_TAIL, else a
+ * walk from first_child (trees linked by hand). */
+static inline JsonNode* juno_last_child(const JsonNode *c) {
+    JsonNode *t = (c->flags & JND_FLAG_TAIL) ? c->value.last_child : c->first_child;
+    if (t) while (t->next_sibling) t = t->next_sibling;
+    return t;
+}
+
+/* Record `tail` as the last child of container `c`. */
+static inline void juno_set_last_child(JsonNode *c, JsonNode *tail) {
+    c->value.last_child = tail;
+    c->flags |= JND_FLAG_TAIL;
+}
+
+/* Error code for a token the grammar did not expect (lexer errors are
+ * classified by the character they start with). */
+JunoErrorCode juno_lex_error_code(const JToken *tok);
+
+/* Store a JTK_NUMBER token into a JND_NUMBER node (int64 when exact). */
+bool juno_number_from_token(JsonNode *n, const JToken *tok);
+
+/* Number token over a raw node's text (JND_FLAG_RAW_NUMBER). */
+static inline JToken juno_raw_number_token(const JsonNode *n) {
+    JToken t;
+    memset(&t, 0, sizeof(t));
+    t.type = JTK_NUMBER;
+    t.start = n->value.svalue;
+    t.length = strlen(n->value.svalue);
+    return t;
+}
+
+/* Specialized parsers (juno_fast.c): parse with a non-FULL mode, arena or
+ * malloc storage, error in err (may be NULL). Same contract as juno_parse_opts. */
+JsonNode* juno_parse_fast(const char *json_str, size_t len, JunoParseMode mode, JunoArena *arena, JunoError *err);
+
+/* True when `opts` asks for a specialized parser and sets nothing only the
+ * default parser serves (stats, hooks, limits, duplicates, base64 keys,
+ * lazy numbers). */
+static inline bool juno_parse_fast_ok(const JunoParseOptions *opts) {
+    return opts && opts->mode != JUNO_PARSE_MODE_FULL && !opts->stats && !opts->hooks && !opts->limits &&
+           opts->duplicates == JUNO_DUP_ALLOW && !opts->base64_keys && !(opts->flags & JUNO_PARSE_LAZY_NUMBERS);
+}
+
+/* ------------------------------
+ * Output (juno_writer.c)
+ * ------------------------------ */
+
+#include <juno/writer.h>
+
+#define JWRITER_BUF 4096
+
+/* Staging buffer in front of a JunoWriteFn; the first failure is kept in err. */
+typedef struct {
+    JunoWriteFn fn;
+    void       *ud;
+    JunoError   err;
+    size_t      written;   /* bytes handed to fn so far */
+    size_t      n;
+    char        buf[JWRITER_BUF];
+} JWriter;
+
+void juno_writer_init(JWriter *w, JunoWriteFn fn, void *ud);
+bool juno_w_fail(JWriter *w, JunoErrorCode code, const char *msg, unsigned depth);  /* always false */
+bool juno_w_flush(JWriter *w);
+bool juno_w_put(JWriter *w, const char *s, size_t len);
+
+/* Quoted string with minimal escaping (RFC 8785 style: short escapes where
+ * defined, \u00xx for other control characters, UTF-8 passed through). */
+bool juno_w_string(JWriter *w, const char *s, size_t len);
+
+static inline bool juno_w_char(JWriter *w, char c) {
+    if (w->n == JWRITER_BUF && !juno_w_flush(w)) return false;
+    w->buf[w->n++] = c;
+    return true;
+}
+
+/* Run a tree writer into a malloc'd NUL-terminated string (juno_stringify). */
+typedef bool (*JWriteTreeFn)(const JsonNode *root, JunoWriteFn fn, void *ud, JunoError *err);
+char* juno_stringify_with(JWriteTreeFn write, const JsonNode *root, size_t *len, JunoError *err);
+
+/* ------------------------------
+ * Streaming reader (juno_reader.c)
+ * ------------------------------ */
+
+#include <juno/reader.h>
+
+/* With `decode` false, string events are checked like the decoder checks
+ * them but not decoded (ev->str stays NULL; ev->raw is set as usual).
+ * Returns the previous setting. */
+bool juno_reader_set_decode(JunoReader *r, bool decode);
+
+/* ------------------------------
+ * Base64 (juno_base64.c)
+ * ------------------------------ */
+
+/* Storage behind value.svalue of a JND_FLAG_BINARY node: one allocation,
+ * released like any string. */
+typedef struct {
+    size_t  len;
+    uint8_t data[];
+} JBlob;
+
+/* A binary node as a quoted base64 string in its recorded alphabet. */
+bool juno_w_base64(JWriter *w, const JsonNode *n);
+
+/* ------------------------------
+ * Schemas (juno_schema.c)
+ * ------------------------------ */
+
+#include <juno/schema.h>
+
+/* One compiled subschema. */
+typedef struct JSNode JSNode;
+
+/* juno_parse_opts with a schema checked along the way (`schema` and `serr`
+ * may be NULL). Always runs the default parser. */
+JsonNode* juno_parse_run(const char *json_str, size_t len, const JunoParseOptions *opts,
+                         const JSNode *schema, JunoSchemaError *serr, JunoError *err);
+
+/* Hooks of the default parser. Each returns false after recording a
+ * JUNO_ERR_SCHEMA failure at `at`. */
+bool juno_schema_enter(JParser *ps, const JSNode *s, JNodeType type, const char *at, unsigned depth);
+bool juno_schema_member(JParser *ps, const JSNode *s, const char *key, uint64_t *seen, const char *at, unsigned depth);
+bool juno_schema_item(JParser *ps, const JSNode *s, size_t index, const char *at, unsigned depth);
+bool juno_schema_check(JParser *ps, const JSNode *s, const JsonNode *n, uint64_t seen, const char *at, unsigned depth);
+
+/* Prefix the pointer of a violation found inside member `key` / element
+ * `index` while the parse unwinds (no-op for other errors). */
+void juno_schema_unwind_key(JParser *ps, const char *key);
+void juno_schema_unwind_index(JParser *ps, size_t index);
+
+/* ------------------------------
+ * Documents (juno_doc.c)
+ * ------------------------------ */
+
+#include <juno/doc.h>
+
+/* Bytes held by a document: its header and every arena chunk. */
+size_t juno_doc_footprint(const JunoDoc *doc);
 
-/* Internal parser entry points */
-JsonNode* juno_parse_obj(JLexer *lx, unsigned short depth);
-JsonNode* juno_parse_array(JLexer *lx, unsigned short depth);
-JsonNode* juno_parse_value(JLexer *lx, unsigned short depth);
+/* Internal parser entry points: return NULL on failure, error in ps->err. */
+JsonNode* juno_parse_obj(JParser *ps, unsigned short depth);
+JsonNode* juno_parse_array(JParser *ps, unsigned short depth);
+JsonNode* juno_parse_value(JParser *ps, unsigned short depth);
 
 #endif
\ No newline at end of file
@@ -5,6 +5,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#ifndef JUNO_MAX_NESTING
+#define JUNO_MAX_NESTING 64
+#endif
+
 typedef enum {
     JTK_EOF = 0,
     JTK_ERROR,
@@ -23,6 +27,14 @@ typedef struct {
     JTokenType   type;
 } JToken;
 
+typedef enum {
+    JL_SKIP_OK = 0,
+    JL_SKIP_SYNTAX,   /* token out of place, misspelled literal or bad number */
+    JL_SKIP_STRING,   /* malformed or unterminated string */
+    JL_SKIP_EOF,      /* input ended inside the value */
+    JL_SKIP_NESTING   /* more than max_depth nested containers */
+} JSkipResult;
+
 typedef struct {
     const char *buf;
     const char *p;
@@ -42,9 +54,20 @@ void jl_init(JLexer *lx, const char *data, size_t len);
 void jl_skip_ws(JLexer *lx);
 JToken jl_next(JLexer *lx);
 
+/* Skip one value, checking it against the grammar (bracket matching, ',' and
+ * ':' placement, literal spelling, number syntax, string escapes) without
+ * decoding or converting anything: whatever jl_skip_value accepts the parser
+ * accepts too. On failure lx->p points at the offending token (the opening
+ * quote for JL_SKIP_STRING). Line/column are not maintained. */
+JSkipResult jl_skip_value(JLexer *lx, unsigned max_depth);
+
 /* Token decoding helpers used by the parser */
 char* jl_string_to_utf8(const JToken *t, const char **err_msg_out);
+bool  jl_decode_string_into(const char *s, size_t n, char *out, size_t *out_len, const char **err_msg);
+/* The checks of jl_decode_string_into (same messages) without the output. */
+bool  jl_check_string(const char *s, size_t n, const char **err_msg);
 bool  jl_number_to_double(const JToken *t, double *out);
 bool  jl_number_to_int64(const JToken *t, int64_t *out);
+bool  jl_number_to_uint64(const JToken *t, uint64_t *out);
 
 #endif
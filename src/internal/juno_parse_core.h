@@ -0,0 +1,247 @@
+/* Parser core, instantiated by juno_fast.c once per JunoParseMode (no include
+ * guard: every inclusion generates a new set of functions).
+ *
+ *   JPC(name)      name of a function of this variant
+ *   JPC_VALIDATE   1: reject raw control characters in strings and leading
+ *                  zeros in numbers, as the default parser does
+ *   JPC_INTEGERS   1: integers that fit are stored as int64; 0: doubles only
+ *
+ * Errors and tree shape match juno_parse_value and friends in juno.c, minus
+ * the options the specialized variants do not serve.
+ */
+
+static JsonNode* JPC(value)(JFast *f, unsigned depth);
+
+/* String at f->p (on its opening quote), decoded into arena or malloc'd
+ * storage. NULL with the error set on failure. */
+static char* JPC(string)(JFast *f, unsigned depth) {
+    const char *q = f->p;
+    bool escaped = false;
+    const char *close = _f_scan_string(q + 1, f->end, JPC_VALIDATE, &escaped);
+    if (!close) {
+        _f_unexpected(f, NULL, depth);
+        return NULL;
+    }
+
+    size_t n = (size_t)(close - q - 1), out_len = 0;
+    char *s = _f_alloc(f, n + 1);
+    if (!s) {
+        _f_fail(f, JUNO_ERR_OOM, "oom (string)", q, depth);
+        return NULL;
+    }
+    if (!escaped) {
+        memcpy(s, q + 1, n);
+        s[n] = '\0';
+    } else {
+        const char *msg = NULL;
+        if (!jl_decode_string_into(q + 1, n, s, &out_len, &msg)) {
+            if (!f->arena) free(s);
+            _f_fail(f, JUNO_ERR_INVALID_STRING, msg ? msg : "invalid string", q, depth);
+            return NULL;
+        }
+        if (f->arena) juno_arena_shrink_last(f->arena, s, out_len + 1);
+    }
+    f->p = close + 1;
+    return s;
+}
+
+static JsonNode* JPC(number)(JFast *f, unsigned depth) {
+    const char *start = f->p, *p = start, *end = f->end;
+    bool neg = false, is_int = true;
+    uint64_t mant = 0;
+    int ndig = 0, frac = 0, e = 0;
+
+    if (*p == '-') {
+        neg = true;
+        p++;
+    }
+    if (p >= end || !_f_digit(*p)) return _f_unexpected(f, NULL, depth);
+    if (JPC_VALIDATE && *p == '0' && p + 1 < end && _f_digit(p[1])) return _f_unexpected(f, NULL, depth);
+    for (; p < end && _f_digit(*p); p++, ndig++)
+        mant = mant * 10 + (uint64_t)(*p - '0');
+
+    if (p < end && *p == '.') {
+        is_int = false;
+        if (++p >= end || !_f_digit(*p)) return _f_unexpected(f, NULL, depth);
+        for (; p < end && _f_digit(*p); p++, ndig++, frac++)
+            mant = mant * 10 + (uint64_t)(*p - '0');
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        bool eneg = false;
+        is_int = false;
+        if (++p < end && (*p == '+' || *p == '-')) eneg = *p++ == '-';
+        if (p >= end || !_f_digit(*p)) return _f_unexpected(f, NULL, depth);
+        for (; p < end && _f_digit(*p); p++)
+            if (e < 100000) e = e * 10 + (*p - '0');
+        if (eneg) e = -e;
+    }
+    f->p = p;
+
+    JsonNode *n = _f_node(f, JND_NUMBER);
+    if (!n) return _f_fail(f, JUNO_ERR_OOM, "oom (number)", start, depth);
+
+    /* Up to 19 digits the mantissa is exact in `mant` (overflow beyond that
+     * is harmless: the token is converted from its text instead). */
+    if (ndig <= 19) {
+#if JPC_INTEGERS
+        if (is_int && mant <= (uint64_t)INT64_MAX + neg) {
+            n->is_integer = true;
+            n->value.ivalue = !neg ? (int64_t)mant : mant > (uint64_t)INT64_MAX ? INT64_MIN : -(int64_t)mant;
+            return n;
+        }
+#endif
+        if (_f_exact_double(mant, e - frac, neg, &n->value.nvalue)) return n;
+    }
+
+    JToken tok;
+    memset(&tok, 0, sizeof(tok));
+    tok.type = JTK_NUMBER;
+    tok.start = start;
+    tok.length = (size_t)(p - start);
+#if JPC_INTEGERS
+    bool ok = is_int ? juno_number_from_token(n, &tok) : jl_number_to_double(&tok, &n->value.nvalue);
+#else
+    (void)is_int;
+    bool ok = jl_number_to_double(&tok, &n->value.nvalue);
+#endif
+    if (!ok) {
+        _f_release(f, n);
+        return _f_fail(f, JUNO_ERR_INVALID_NUMBER, "invalid number", start, depth);
+    }
+    return n;
+}
+
+static JsonNode* JPC(array)(JFast *f, unsigned depth) {
+    if (depth > JUNO_MAX_NESTING) return _f_fail(f, JUNO_ERR_NESTING, NULL, f->p, depth);
+
+    const char *open = f->p++;
+    JsonNode *array = _f_node(f, JND_ARRAY), *tail = NULL;
+    if (!array) return _f_fail(f, JUNO_ERR_OOM, "oom (array)", open, depth);
+
+    _f_ws(f);
+    if (f->p < f->end && *f->p == ']') {
+        f->p++;
+        return array;
+    }
+    for (;;) {
+        JsonNode *val = JPC(value)(f, depth);
+        if (!val) goto error;
+
+        if (tail) tail->next_sibling = val;
+        else array->first_child = val;
+        tail = val;
+
+        _f_ws(f);
+        if (f->p < f->end && *f->p == ',') {
+            f->p++;
+            continue;
+        }
+        if (f->p < f->end && *f->p == ']') {
+            f->p++;
+            break;
+        }
+        _f_unexpected(f, "expected ',' or ']' while parsing array", depth);
+        goto error;
+    }
+
+    juno_set_last_child(array, tail);
+    return array;
+
+error:
+    _f_release(f, array);
+    return NULL;
+}
+
+static JsonNode* JPC(object)(JFast *f, unsigned depth) {
+    if (depth > JUNO_MAX_NESTING) return _f_fail(f, JUNO_ERR_NESTING, NULL, f->p, depth);
+
+    const char *open = f->p++;
+    JsonNode *obj = _f_node(f, JND_OBJ), *tail = NULL;
+    if (!obj) return _f_fail(f, JUNO_ERR_OOM, "oom (object)", open, depth);
+
+    _f_ws(f);
+    if (f->p < f->end && *f->p == '}') {
+        f->p++;
+        return obj;
+    }
+    for (;;) {
+        _f_ws(f);
+        if (f->p >= f->end || *f->p != '"') {
+            _f_unexpected(f, "expected string as object key", depth);
+            goto error;
+        }
+        char *key = JPC(string)(f, depth);
+        if (!key) goto error;
+
+        _f_ws(f);
+        if (f->p >= f->end || *f->p != ':') {
+            if (!f->arena) free(key);
+            _f_unexpected(f, "expected ':' after object key", depth);
+            goto error;
+        }
+        f->p++;
+
+        JsonNode *val = JPC(value)(f, depth);
+        if (!val) {
+            if (!f->arena) free(key);
+            goto error;
+        }
+        val->key = key;
+
+        if (tail) tail->next_sibling = val;
+        else obj->first_child = val;
+        tail = val;
+
+        _f_ws(f);
+        if (f->p < f->end && *f->p == ',') {
+            f->p++;
+            continue;
+        }
+        if (f->p < f->end && *f->p == '}') {
+            f->p++;
+            break;
+        }
+        _f_unexpected(f, "expected ',' between object properties", depth);
+        goto error;
+    }
+
+    juno_set_last_child(obj, tail);
+    return obj;
+
+error:
+    _f_release(f, obj);
+    return NULL;
+}
+
+static JsonNode* JPC(value)(JFast *f, unsigned depth) {
+    _f_ws(f);
+    if (f->p < f->end) {
+        switch (*f->p) {
+            case '{': return JPC(object)(f, depth + 1);
+            case '[': return JPC(array)(f, depth + 1);
+            case '"': {
+                JsonNode *n = _f_node(f, JND_STRING);
+                if (!n) return _f_fail(f, JUNO_ERR_OOM, "oom (string)", f->p, depth);
+                n->value.svalue = JPC(string)(f, depth);
+                if (!n->value.svalue) {
+                    _f_release(f, n);
+                    return NULL;
+                }
+                return n;
+            }
+            case 't': return _f_literal(f, "true", 4, JND_BOOL, true, depth);
+            case 'f': return _f_literal(f, "false", 5, JND_BOOL, false, depth);
+            case 'n': return _f_literal(f, "null", 4, JND_NULL, false, depth);
+            case '-': case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+                return JPC(number)(f, depth);
+            default:
+                break;
+        }
+    }
+    return _f_unexpected(f, "unexpected token while parsing value", depth);
+}
+
+#undef JPC
+#undef JPC_VALIDATE
+#undef JPC_INTEGERS
@@ -1,43 +1,87 @@
 #include "internal/juno_internal.h"
 
+#include <juno/base64.h>
+#include <juno/iter.h>
+
 /* ------------------------------
  * Error handling
  * ------------------------------ */
 
-static void _format_error(char *out, size_t out_len, const char *err_msg, const JToken *tok) {
-    if (!out || out_len == 0) return;
-
-    const char *reason = err_msg ? err_msg : JUNO_ERROR_MSG_DEFAULT;
-    out[0] = '\0';
+const char* juno_error_str(JunoErrorCode code) {
+    switch (code) {
+        case JUNO_OK:                   return "ok";
+        case JUNO_ERR_INVALID_ARG:      return "invalid argument";
+        case JUNO_ERR_OOM:              return "out of memory";
+        case JUNO_ERR_IO:               return "i/o error";
+        case JUNO_ERR_UNEXPECTED_TOKEN: return "unexpected token";
+        case JUNO_ERR_UNEXPECTED_EOF:   return "unexpected end of input";
+        case JUNO_ERR_INVALID_STRING:   return "invalid string";
+        case JUNO_ERR_INVALID_NUMBER:   return "invalid number";
+        case JUNO_ERR_INVALID_LITERAL:  return "invalid literal";
+        case JUNO_ERR_NESTING:          return "maximum nesting reached";
+        case JUNO_ERR_TOKEN_TOO_LARGE:  return "token larger than reader window";
+        case JUNO_ERR_BINARY_FORMAT:    return "invalid binary image";
+        case JUNO_ERR_PATH_NOT_FOUND:   return "path not found";
+        case JUNO_ERR_TEST_FAILED:      return "test failed";
+        case JUNO_ERR_DUPLICATE_KEY:    return "duplicate member name";
+        case JUNO_ERR_INPUT_TOO_LARGE:  return "input too large";
+        case JUNO_ERR_TOO_MANY_NODES:   return "too many nodes";
+        case JUNO_ERR_STRING_TOO_LONG:  return "string too long";
+        case JUNO_ERR_ALLOC_LIMIT:      return "allocation limit reached";
+        case JUNO_ERR_TOO_MANY_MEMBERS: return "too many members";
+        case JUNO_ERR_NUMBER_TOO_LONG:  return "number too long";
+        case JUNO_ERR_SCHEMA:           return "schema violation";
+    }
+    return "unknown error";
+}
 
-    if (!tok) {
-        snprintf(out, out_len, "Parse error: %s", reason);
-        return;
+void juno_error_position(const JunoError *err, const char *src, size_t len,
+                         unsigned *line, unsigned *column) {
+    unsigned l = 1;
+    size_t line_off = 0;
+
+    if (err && src) {
+        size_t off = err->offset < len ? err->offset : len;
+        const char *p = src;
+        const char *end = src + off;
+        const char *nl;
+        while (p < end && (nl = memchr(p, '\n', (size_t)(end - p))) != NULL) {
+            l++;
+            p = nl + 1;
+        }
+        line_off = (size_t)(p - src);
+        if (column) *column = (unsigned)(off - line_off + 1);
+    } else if (column) {
+        *column = 0;
     }
+    if (line) *line = l;
+}
 
-    const char *line_start = tok->line_start;
-    const char *buf_end = tok->buf_end;
+int juno_error_format(const JunoError *err, const char *src, size_t len,
+                      char *out, size_t out_len) {
+    if (!err) return 0;
 
-    if (!line_start || !buf_end || line_start > tok->start || tok->start > buf_end) {
-        snprintf(out, out_len, "Parse error at %u:%u: %s", tok->line, tok->column, reason);
-        return;
-    }
+    const char *reason = err->msg ? err->msg : juno_error_str(err->code);
+    if (out && out_len) out[0] = '\0';
+
+    if (err->code == JUNO_ERR_INVALID_ARG || err->code == JUNO_ERR_IO)
+        return snprintf(out, out_len, "Parse error: %s", reason);
+    if (!src || err->offset > len)
+        return snprintf(out, out_len, "Parse error at byte %zu: %s", err->offset, reason);
+
+    unsigned line = 0, column = 0;
+    juno_error_position(err, src, len, &line, &column);
 
-    size_t max_scan = (size_t)(buf_end - line_start);
-    const char *nl = memchr(line_start, '\n', max_scan);
+    const char *line_start = src + (err->offset - (column - 1));
+    const char *buf_end = src + len;
+    const char *nl = memchr(line_start, '\n', (size_t)(buf_end - line_start));
     const char *line_end = nl ? nl : buf_end;
-    if (line_end < line_start) {
-        snprintf(out, out_len, "Parse error at %u:%u: %s", tok->line, tok->column, reason);
-        return;
-    }
 
     size_t line_len = (size_t)(line_end - line_start);
-    if (line_len == 0) {
-        snprintf(out, out_len, "Parse error at %u:%u: %s", tok->line, tok->column, reason);
-        return;
-    }
+    if (line_len == 0)
+        return snprintf(out, out_len, "Parse error at %u:%u: %s", line, column, reason);
 
-    size_t col_idx = tok->column ? (size_t)(tok->column - 1) : 0;
+    size_t col_idx = column - 1;
     if (col_idx >= line_len) col_idx = line_len - 1;
 
     const size_t window = 70;
@@ -52,36 +96,33 @@ static void _format_error(char *out, size_t out_len, const char *err_msg, const
     size_t caret_pos = (col_idx > start_off) ? (col_idx - start_off) : 0;
     if (caret_pos >= snippet_len) caret_pos = snippet_len ? snippet_len - 1 : 0;
 
-    snprintf(out, out_len,
+    return snprintf(out, out_len,
         "Parse error at %u:%u\n  %.*s\n  %*s^\n  %s",
-        tok->line, tok->column,
+        line, column,
         (int)snippet_len, line_start + start_off,
         (int)caret_pos, "",
         reason
     );
 }
 
-void juno_error_set_msg(JsonNode *err_node, const char *err_msg) {
-    if (!err_node || !err_msg || err_node->type != JND_ERROR) return;
-    /* Ensure NUL-termination */
-    char *err_msg_buf = (char*)calloc(1, JUNO_ERROR_MSG_MAX_LEN);
-    strncpy(err_msg_buf, err_msg, JUNO_ERROR_MSG_MAX_LEN - 1);
-    err_msg_buf[JUNO_ERROR_MSG_MAX_LEN - 1] = '\0';
-    err_node->value.err_msg = err_msg_buf;
+JsonNode* juno_fail(JParser *ps, JunoErrorCode code, const char *msg, const char *at, unsigned depth) {
+    if (ps->err.code != JUNO_OK) return NULL;
+    if (!at) at = ps->lx.p;
+    ps->err.code = code;
+    ps->err.msg = msg ? msg : juno_error_str(code);
+    ps->err.offset = (size_t)(at - ps->lx.buf);
+    ps->err.depth = depth;
+    return NULL;
 }
 
-JsonNode* juno_error(const char *err_msg, const JToken *curr_tok) {
+JsonNode* juno_error_node(const JunoError *err, const char *src, size_t len) {
     JsonNode *err_node = (JsonNode*)calloc(1, sizeof(JsonNode));
     if (!err_node) return NULL;
     err_node->type = JND_ERROR;
-    err_node->value.err_msg = JUNO_ERROR_MSG_DEFAULT;
-    err_node->is_integer = false;
-
-    char buf[JUNO_ERROR_MSG_MAX_LEN] = { 0 };
-    if (curr_tok) {
-        _format_error(buf, sizeof(buf), err_msg, curr_tok);
-        juno_error_set_msg(err_node, buf);
-    } else if (err_msg) juno_error_set_msg(err_node, err_msg);
+
+    char *msg = (char*)malloc(JUNO_ERROR_MSG_MAX_LEN);
+    if (msg) juno_error_format(err, src, len, msg, JUNO_ERROR_MSG_MAX_LEN);
+    err_node->value.err_msg = msg;
     return err_node;
 }
 
@@ -89,7 +130,9 @@ JsonNode* juno_error(const char *err_msg, const JToken *curr_tok) {
  * File helper
  * ------------------------------ */
 
-static char* _read_file(const char *filename) {
+/* Whole file, NUL-terminated. Files over `max_len` bytes are not read
+ * (NULL with *too_large set). */
+static char* _read_file(const char *filename, size_t max_len, bool *too_large) {
     FILE *file = fopen(filename, "rb");
     if (!file) {
         perror("open");
@@ -105,6 +148,11 @@ static char* _read_file(const char *filename) {
         fclose(file);
         return NULL;
     }
+    if ((unsigned long)length > max_len) {
+        *too_large = true;
+        fclose(file);
+        return NULL;
+    }
     if (fseek(file, 0, SEEK_SET) != 0) {
         fclose(file);
         return NULL;
@@ -150,9 +198,7 @@ static inline const char* _nname(const JsonNode *node) {
     return "?";
 }
 
-static void _juno_print_ast_rec(JsonNode *node, unsigned depth) {
-    if (!node) return;
-
+static void _juno_print_ast_node(const JsonNode *node, unsigned depth) {
     for (unsigned i = 0; i < depth; i++) printf("%s", "   ");
     printf("%s", (const char *)(depth ? ((node->next_sibling == NULL) ? "└─ " : "├─ ") : "└─ "));
 
@@ -161,10 +207,15 @@ static void _juno_print_ast_rec(JsonNode *node, unsigned depth) {
 
     switch (node->type) {
         case JND_STRING:
-            printf(" : \"%s\"", node->value.svalue ? node->value.svalue : "");
+            if (node->flags & JND_FLAG_BINARY)
+                printf(" : <%zu bytes>", ((const JBlob*)node->value.svalue)->len);
+            else
+                printf(" : \"%s\"", node->value.svalue ? node->value.svalue : "");
             break;
         case JND_NUMBER:
-            if (node->is_integer)
+            if (node->flags & JND_FLAG_RAW_NUMBER)
+                printf(" : %s", node->value.svalue);
+            else if (node->is_integer)
                 printf(" : %lld", (long long)node->value.ivalue);
             else
                 printf(" : %g", node->value.nvalue);
@@ -182,14 +233,16 @@ static void _juno_print_ast_rec(JsonNode *node, unsigned depth) {
             break;
     }
     printf("\n");
-
-    for (JsonNode *child = node->first_child; child; child = child->next_sibling) {
-        _juno_print_ast_rec(child, depth + 1);
-    }
 }
 
 void juno_print_ast(JsonNode *root) {
-    _juno_print_ast_rec(root, 0);
+    JunoIter it;
+    JunoIterEvent ev;
+    juno_iter_init(&it, root);
+    while ((ev = juno_iter_next(&it)) != JUNO_ITER_END && ev != JUNO_ITER_ERROR) {
+        if (ev != JUNO_ITER_LEAVE) _juno_print_ast_node(it.pos.node, it.depth);
+    }
+    juno_iter_free(&it);
 }
 
 /* ------------------------------
@@ -197,7 +250,7 @@ void juno_print_ast(JsonNode *root) {
  * ------------------------------ */
 
 void juno_free_ast(JsonNode *root) {
-    if (!root) return;
+    if (!root || (root->flags & JND_FLAG_ARENA)) return;
 
     JsonNode *child = root->first_child;
     while (child) {
@@ -207,6 +260,7 @@ void juno_free_ast(JsonNode *root) {
     }
 
     if (root->type == JND_STRING && root->value.svalue) free(root->value.svalue);
+    if (root->type == JND_NUMBER && (root->flags & JND_FLAG_RAW_NUMBER)) free(root->value.svalue);
     if (root->type == JND_ERROR && root->value.err_msg) free(root->value.err_msg);
     if (root->key) free(root->key);
 
@@ -217,101 +271,432 @@ void juno_free_ast(JsonNode *root) {
  * Internal node allocator
  * ------------------------------ */
 
-static JsonNode* juno_create_node(JNodeType type) {
+JsonNode* juno_create_node(JNodeType type) {
     JsonNode *node = (JsonNode*)calloc(1, sizeof(JsonNode));
     if (!node) return NULL;
     node->type = type;
     return node;
 }
 
+JsonNode* juno_ps_node(JParser *ps, JNodeType type, const char *at, unsigned depth) {
+    JUNO_STAT(ps, st_->nodes[type]++; st_->alloc_count++; st_->alloc_bytes += sizeof(JsonNode));
+    if (++ps->nodes > ps->lim.max_nodes) return juno_fail(ps, JUNO_ERR_TOO_MANY_NODES, NULL, at, depth);
+    if (!juno_ps_charge(ps, sizeof(JsonNode), at, depth)) return NULL;
+    if (!ps->arena) return juno_create_node(type);
+
+    JsonNode *node = (JsonNode*)juno_arena_alloc(ps->arena, sizeof(JsonNode));
+    if (!node) return NULL;
+    memset(node, 0, sizeof(*node));
+    node->type = type;
+    node->flags = JND_FLAG_ARENA;
+    return node;
+}
+
+static char* _ps_string(JParser *ps, const JToken *tok, const char **err_msg, unsigned depth, size_t *len_out) {
+    if (err_msg) *err_msg = NULL;
+    if (tok->type != JTK_STRING || tok->length < 2) {
+        if (err_msg) *err_msg = "not a string token";
+        return NULL;
+    }
+
+    size_t n = tok->length - 2, out_len = 0;
+    /* Escapes shrink text at most 6:1 ("\u0041" -> "A"): reject before decoding. */
+    if (n / 6 > ps->lim.max_string) {
+        juno_fail(ps, JUNO_ERR_STRING_TOO_LONG, NULL, tok->start, depth);
+        return NULL;
+    }
+    if (!juno_ps_charge(ps, n + 1, tok->start, depth)) return NULL;
+
+    char *out = ps->arena ? (char*)juno_arena_alloc(ps->arena, n + 1) : (char*)malloc(n + 1);
+    if (!out) {
+        juno_fail(ps, JUNO_ERR_OOM, "oom (string)", tok->start, depth);
+        return NULL;
+    }
+    bool ok = jl_decode_string_into(tok->start + 1, n, out, &out_len, err_msg);
+    if (ok && out_len > ps->lim.max_string) {
+        juno_fail(ps, JUNO_ERR_STRING_TOO_LONG, NULL, tok->start, depth);
+        ok = false;
+    }
+    if (!ok) {
+        if (!ps->arena) free(out);
+        return NULL;
+    }
+    if (ps->arena) {
+        juno_arena_shrink_last(ps->arena, out, out_len + 1);
+        ps->alloc -= n - out_len;
+    }
+    if (len_out) *len_out = out_len;
+    return out;
+}
+
+char* juno_ps_string(JParser *ps, const JToken *tok, const char **err_msg, unsigned depth) {
+#if JUNO_ENABLE_STATS
+    if (ps->stats) {
+        JunoStats *st = ps->stats;
+        size_t len = 0;
+        uint64_t t0 = juno_cycles();
+        char *out = _ps_string(ps, tok, err_msg, depth, &len);
+        st->decode_cycles += juno_cycles() - t0;
+        if (out) {
+            st->string_bytes += len;
+            st->alloc_count++;
+            st->alloc_bytes += ps->arena ? len + 1 : tok->length - 1;
+            if (memchr(tok->start, '\\', tok->length)) st->escaped_strings++;
+        }
+        return out;
+    }
+#endif
+    return _ps_string(ps, tok, err_msg, depth, NULL);
+}
+
+char* juno_ps_strdup(JParser *ps, const char *s, size_t len, unsigned depth) {
+    JUNO_STAT(ps, st_->alloc_count++; st_->alloc_bytes += len + 1; st_->string_bytes += len);
+    if (!juno_ps_charge(ps, len + 1, NULL, depth)) return NULL;
+    char *d = ps->arena ? (char*)juno_arena_alloc(ps->arena, len + 1) : (char*)malloc(len + 1);
+    if (!d) return NULL;
+    memcpy(d, s, len);
+    d[len] = '\0';
+    return d;
+}
+
+void juno_ps_release(JParser *ps, void *p) {
+    if (!ps->arena) free(p);
+}
+
+/* Decode a base64 string token (a base64_keys member) straight into the
+ * node's JBlob. Tokens with escapes (encoders may write "\/") are unescaped
+ * into a temporary first. */
+static bool _ps_binary(JParser *ps, JsonNode *n, const JToken *tok, unsigned depth) {
+    const char *src = tok->start + 1;
+    size_t len = tok->length - 2;
+    char *text = NULL;
+
+    if (memchr(src, '\\', len)) {
+        const char *err_msg = NULL;
+        if ((text = (char*)malloc(len + 1)) == NULL) {
+            juno_fail(ps, JUNO_ERR_OOM, "oom (binary)", tok->start, depth);
+            return false;
+        }
+        if (!jl_decode_string_into(src, len, text, &len, &err_msg)) {
+            free(text);
+            juno_fail(ps, JUNO_ERR_INVALID_STRING, err_msg, tok->start, depth);
+            return false;
+        }
+        src = text;
+    }
+
+    unsigned flags = (ps->flags & JUNO_PARSE_BASE64URL) ? JUNO_BASE64_URL : 0;
+    size_t size = sizeof(JBlob) + juno_base64_decoded_max(len);
+    JBlob *b = NULL;
+    JunoError e;
+    bool ok = false;
+    JUNO_STAT(ps, st_->alloc_count++; st_->alloc_bytes += size);
+    if (juno_base64_decoded_max(len) > ps->lim.max_string) {
+        juno_fail(ps, JUNO_ERR_STRING_TOO_LONG, NULL, tok->start, depth);
+    } else if (!juno_ps_charge(ps, size, tok->start, depth)) {
+        /* failed with JUNO_ERR_ALLOC_LIMIT */
+    } else if ((b = (JBlob*)(ps->arena ? juno_arena_alloc(ps->arena, size) : malloc(size))) == NULL) {
+        juno_fail(ps, JUNO_ERR_OOM, "oom (binary)", tok->start, depth);
+    } else if (!juno_base64_decode(src, len, flags, b->data, &b->len, &e)) {
+        /* Offsets inside unescaped text do not map back: report the token. */
+        juno_fail(ps, JUNO_ERR_INVALID_STRING, e.msg, text ? tok->start : src + e.offset, depth);
+        juno_ps_release(ps, b);
+    } else {
+        if (ps->arena) juno_arena_shrink_last(ps->arena, b, sizeof(JBlob) + b->len);
+        n->value.svalue = (char*)b;
+        n->flags |= JND_FLAG_BINARY | (flags ? JND_FLAG_BASE64URL : 0);
+        ok = true;
+    }
+    free(text);
+    return ok;
+}
+
+static bool _b64_key(const char *const *keys, const char *key) {
+    for (; *keys; keys++) {
+        if (strcmp(*keys, key) == 0) return true;
+    }
+    return false;
+}
+
 /* ------------------------------
  * Parsing internals
  * ------------------------------ */
 
-JsonNode* juno_parse_value(JLexer *lx, unsigned short depth) {
-    if (depth > JUNO_MAX_NESTING) return juno_error("maximum nesting reached", NULL);
+void juno_parser_init(JParser *ps, const char *data, size_t len) {
+    jl_init(&ps->lx, data, len);
+    memset(&ps->err, 0, sizeof(ps->err));
+    ps->arena = NULL;
+    ps->stats = NULL;
+    ps->flags = 0;
+    ps->dups = JUNO_DUP_ALLOW;
+    memset(&ps->keys, 0, sizeof(ps->keys));
+    ps->b64_keys = NULL;
+    ps->b64_next = false;
+    ps->sch_next = NULL;
+    ps->sch_err = NULL;
+    juno_parser_set_limits(ps, NULL);
+}
 
-    jl_skip_ws(lx);
-    if (jl_peek(lx) == '{') return juno_parse_obj(lx, (unsigned short)(depth + 1));
-    if (jl_peek(lx) == '[') return juno_parse_array(lx, (unsigned short)(depth + 1));
+void juno_parser_set_limits(JParser *ps, const JunoLimits *lim) {
+    static const JunoLimits none = { 0, 0, 0, 0, 0, 0 };
+    if (!lim) lim = &none;
+    ps->lim.max_input   = lim->max_input   ? lim->max_input   : SIZE_MAX;
+    ps->lim.max_nodes   = lim->max_nodes   ? lim->max_nodes   : SIZE_MAX;
+    ps->lim.max_string  = lim->max_string  ? lim->max_string  : SIZE_MAX;
+    ps->lim.max_alloc   = lim->max_alloc   ? lim->max_alloc   : SIZE_MAX;
+    ps->lim.max_members = lim->max_members ? lim->max_members : SIZE_MAX;
+    ps->lim.max_digits  = lim->max_digits  ? lim->max_digits  : SIZE_MAX;
+    ps->nodes = 0;
+    ps->alloc = 0;
+}
+
+void juno_parser_free_scratch(JParser *ps) {
+    free(ps->keys.slots);
+    memset(&ps->keys, 0, sizeof(ps->keys));
+}
 
-    JToken tok = jl_next(lx);
+void juno_parser_set_options(JParser *ps, const JunoParseOptions *opts) {
+    if (!opts) return;
+    ps->arena = opts->arena;
+    ps->stats = opts->stats;
+    ps->flags = opts->flags;
+    ps->dups = opts->duplicates;
+    ps->b64_keys = opts->base64_keys;
+    juno_parser_set_limits(ps, opts->limits);
+}
+
+void juno_parse_begin(JParser *ps, JParseScope *scope, const JunoParseOptions *opts,
+                      const char *json_str, size_t len) {
+    scope->hooks = opts ? opts->hooks : NULL;
+    if (scope->hooks && !ps->stats) ps->stats = &scope->local;
+    if (ps->stats) memset(ps->stats, 0, sizeof(*ps->stats));
+    scope->t0 = ps->stats ? juno_cycles() : 0;
+    if (scope->hooks && scope->hooks->on_begin) scope->hooks->on_begin(scope->hooks->ud, json_str, len);
+}
+
+void juno_parse_end(JParser *ps, JParseScope *scope, size_t consumed) {
+#if JUNO_ENABLE_STATS
+    JunoStats *st = ps->stats;
+    if (st) {
+        st->bytes_consumed = consumed;
+        st->total_cycles = juno_cycles() - scope->t0;
+        uint64_t phases = st->lex_cycles + st->decode_cycles;
+        st->build_cycles = st->total_cycles > phases ? st->total_cycles - phases : 0;
+    }
+#else
+    (void)consumed;
+#endif
+    if (scope->hooks && scope->hooks->on_end) scope->hooks->on_end(scope->hooks->ud, ps->stats, &ps->err);
+}
+
+JunoErrorCode juno_lex_error_code(const JToken *tok) {
+    if (tok->type == JTK_EOF) return JUNO_ERR_UNEXPECTED_EOF;
+    if (tok->type != JTK_ERROR || tok->start >= tok->buf_end) return JUNO_ERR_UNEXPECTED_TOKEN;
+    char c = *tok->start;
+    if (c == '"') return JUNO_ERR_INVALID_STRING;
+    if (c == '-' || (c >= '0' && c <= '9')) return JUNO_ERR_INVALID_NUMBER;
+    return JUNO_ERR_INVALID_LITERAL;
+}
+
+/* Fail on an unexpected token: lexer errors keep their precise reason. */
+static JsonNode* _fail_tok(JParser *ps, const JToken *tok, const char *msg, unsigned depth) {
+    if (tok->type == JTK_ERROR)
+        return juno_fail(ps, juno_lex_error_code(tok), tok->err_msg, tok->start, depth);
+    return juno_fail(ps, juno_lex_error_code(tok), msg, tok->start, depth);
+}
+
+bool juno_number_from_token(JsonNode *n, const JToken *tok) {
+    int64_t iv = 0;
+    if (jl_number_to_int64(tok, &iv)) {
+        n->is_integer = true;
+        n->value.ivalue = iv;
+        return true;
+    }
+    n->is_integer = false;
+    return jl_number_to_double(tok, &n->value.nvalue);
+}
+
+/* Lazy mode: keep the token text and classify it, convert nothing. */
+static JunoErrorCode _ps_raw_number(JParser *ps, JsonNode *n, const JToken *tok, unsigned depth) {
+    if (!juno_ps_charge(ps, tok->length + 1, tok->start, depth)) return JUNO_ERR_ALLOC_LIMIT;
+    char *text = ps->arena ? (char*)juno_arena_alloc(ps->arena, tok->length + 1)
+                           : (char*)malloc(tok->length + 1);
+    if (!text) return JUNO_ERR_OOM;
+    memcpy(text, tok->start, tok->length);
+    text[tok->length] = '\0';
+
+    n->value.svalue = text;
+    n->flags |= JND_FLAG_RAW_NUMBER;
+    n->is_integer = strpbrk(text, ".eE") == NULL;
+    JUNO_STAT(ps, st_->alloc_count++; st_->alloc_bytes += tok->length + 1;
+                  if (n->is_integer) st_->integers++; else st_->doubles++);
+    return JUNO_OK;
+}
+
+static JunoErrorCode _ps_number(JParser *ps, JsonNode *n, const JToken *tok, unsigned depth) {
+    if (ps->flags & JUNO_PARSE_LAZY_NUMBERS) return _ps_raw_number(ps, n, tok, depth);
+#if JUNO_ENABLE_STATS
+    if (ps->stats) {
+        JunoStats *st = ps->stats;
+        uint64_t t0 = juno_cycles();
+        bool ok = juno_number_from_token(n, tok);
+        st->decode_cycles += juno_cycles() - t0;
+        if (n->is_integer) st->integers++;
+        else st->doubles++;
+        return ok ? JUNO_OK : JUNO_ERR_INVALID_NUMBER;
+    }
+#endif
+    return juno_number_from_token(n, tok) ? JUNO_OK : JUNO_ERR_INVALID_NUMBER;
+}
+
+/* ------------------------------
+ * Number getters
+ * ------------------------------ */
+
+bool juno_number_int64(const JsonNode *node, int64_t *out) {
+    if (!node || node->type != JND_NUMBER || !out) return false;
+    if (node->flags & JND_FLAG_RAW_NUMBER) {
+        JToken t = juno_raw_number_token(node);
+        return jl_number_to_int64(&t, out);
+    }
+    if (!node->is_integer) return false;
+    *out = node->value.ivalue;
+    return true;
+}
+
+bool juno_number_uint64(const JsonNode *node, uint64_t *out) {
+    if (!node || node->type != JND_NUMBER || !out) return false;
+    if (node->flags & JND_FLAG_RAW_NUMBER) {
+        JToken t = juno_raw_number_token(node);
+        return jl_number_to_uint64(&t, out);
+    }
+    if (!node->is_integer || node->value.ivalue < 0) return false;
+    *out = (uint64_t)node->value.ivalue;
+    return true;
+}
 
+bool juno_number_double(const JsonNode *node, double *out) {
+    if (!node || node->type != JND_NUMBER || !out) return false;
+    if (node->flags & JND_FLAG_RAW_NUMBER) {
+        JToken t = juno_raw_number_token(node);
+        return jl_number_to_double(&t, out);
+    }
+    *out = node->is_integer ? (double)node->value.ivalue : node->value.nvalue;
+    return true;
+}
+
+const char* juno_number_raw(const JsonNode *node, size_t *len) {
+    if (!node || node->type != JND_NUMBER || !(node->flags & JND_FLAG_RAW_NUMBER)) return NULL;
+    if (len) *len = strlen(node->value.svalue);
+    return node->value.svalue;
+}
+
+static JsonNode* _parse_scalar(JParser *ps, JToken tok, bool binary, unsigned short depth) {
     switch (tok.type) {
         case JTK_STRING: {
-            JsonNode *n = juno_create_node(JND_STRING);
-            if (!n) return juno_error("oom (string)", &tok);
-            n->value.svalue = jl_string_to_utf8(&tok, NULL);
+            JsonNode *n = juno_ps_node(ps, JND_STRING, tok.start, depth);
+            if (!n) return juno_fail(ps, JUNO_ERR_OOM, "oom (string)", tok.start, depth);
+            if (binary) {
+                if (_ps_binary(ps, n, &tok, depth)) return n;
+                juno_free_ast(n);
+                return NULL;
+            }
+            const char *err_msg = NULL;
+            n->value.svalue = juno_ps_string(ps, &tok, &err_msg, depth);
             if (!n->value.svalue) {
                 juno_free_ast(n);
-                return juno_error(tok.err_msg ? tok.err_msg : "invalid string", &tok);
+                return juno_fail(ps, JUNO_ERR_INVALID_STRING, err_msg ? err_msg : "invalid string", tok.start, depth);
             }
             return n;
         }
         case JTK_NUMBER: {
-            JsonNode *n = juno_create_node(JND_NUMBER);
-            if (!n) return juno_error("oom (number)", &tok);
-            int64_t iv = 0;
-            if (jl_number_to_int64(&tok, &iv)) {
-                n->is_integer = true;
-                n->value.ivalue = iv;
-            } else {
-                n->is_integer = false;
-                if (!jl_number_to_double(&tok, &n->value.nvalue)) {
-                    juno_free_ast(n);
-                    return juno_error("invalid number", &tok);
-                }
+            if (tok.length > ps->lim.max_digits) return juno_fail(ps, JUNO_ERR_NUMBER_TOO_LONG, NULL, tok.start, depth);
+            JsonNode *n = juno_ps_node(ps, JND_NUMBER, tok.start, depth);
+            if (!n) return juno_fail(ps, JUNO_ERR_OOM, "oom (number)", tok.start, depth);
+            JunoErrorCode code = _ps_number(ps, n, &tok, depth);
+            if (code != JUNO_OK) {
+                juno_free_ast(n);
+                return juno_fail(ps, code, code == JUNO_ERR_OOM ? "oom (number)" : "invalid number", tok.start, depth);
             }
             return n;
         }
         case JTK_TRUE: {
-            JsonNode *n = juno_create_node(JND_BOOL);
-            if (!n) return juno_error("oom (bool)", &tok);
+            JsonNode *n = juno_ps_node(ps, JND_BOOL, tok.start, depth);
+            if (!n) return juno_fail(ps, JUNO_ERR_OOM, "oom (bool)", tok.start, depth);
             n->value.bvalue = true;
             return n;
         }
         case JTK_FALSE: {
-            JsonNode *n = juno_create_node(JND_BOOL);
-            if (!n) return juno_error("oom (bool)", &tok);
+            JsonNode *n = juno_ps_node(ps, JND_BOOL, tok.start, depth);
+            if (!n) return juno_fail(ps, JUNO_ERR_OOM, "oom (bool)", tok.start, depth);
             n->value.bvalue = false;
             return n;
         }
-        case JTK_NULL:
-            return juno_create_node(JND_NULL);
-        case JTK_ERROR:
-            return juno_error(tok.err_msg ? tok.err_msg : "lexer error", &tok);
+        case JTK_NULL: {
+            JsonNode *n = juno_ps_node(ps, JND_NULL, tok.start, depth);
+            if (!n) return juno_fail(ps, JUNO_ERR_OOM, "oom (null)", tok.start, depth);
+            return n;
+        }
         default:
-            return juno_error("unexpected token while parsing value", &tok);
+            return _fail_tok(ps, &tok, "unexpected token while parsing value", depth);
     }
 }
 
-JsonNode* juno_parse_array(JLexer *lx, unsigned short depth) {
-    JsonNode *array = juno_create_node(JND_ARRAY);
-    JsonNode *tail = NULL;
-    char *err_msg = NULL;
+JsonNode* juno_parse_value(JParser *ps, unsigned short depth) {
+    JLexer *lx = &ps->lx;
+    bool binary = ps->b64_next;
+    ps->b64_next = false;
+    if (depth > JUNO_MAX_NESTING) return juno_fail(ps, JUNO_ERR_NESTING, NULL, NULL, depth);
 
-    if (!array) return juno_error("oom (array)", NULL);
-    if (depth > JUNO_MAX_NESTING) {
-        err_msg = "maximum nesting reached";
-        goto error;
+    /* Containers pick their schema up from sch_next themselves. */
+    jl_skip_ws(lx);
+    if (jl_peek(lx) == '{') return juno_parse_obj(ps, (unsigned short)(depth + 1));
+    if (jl_peek(lx) == '[') return juno_parse_array(ps, (unsigned short)(depth + 1));
+
+    const JSNode *sch = ps->sch_next;
+    ps->sch_next = NULL;
+    JToken tok = juno_ps_next(ps);
+    JsonNode *n = _parse_scalar(ps, tok, binary, depth);
+    if (n && sch && !juno_schema_check(ps, sch, n, 0, tok.start, depth)) {
+        juno_free_ast(n);
+        return NULL;
     }
+    return n;
+}
 
-    JToken tok = jl_next(lx);
-    if (tok.type != JTK_LBRACK) {
-        err_msg = "expected '[' while parsing array";
-        goto error;
-    }
+JsonNode* juno_parse_array(JParser *ps, unsigned short depth) {
+    JLexer *lx = &ps->lx;
+    const JSNode *sch = ps->sch_next;
+    ps->sch_next = NULL;
+    if (depth > JUNO_MAX_NESTING) return juno_fail(ps, JUNO_ERR_NESTING, NULL, NULL, depth);
+
+    JUNO_STAT(ps, if (depth > st_->max_depth) st_->max_depth = depth);
+
+    JToken tok = juno_ps_next(ps);
+    if (tok.type != JTK_LBRACK) return _fail_tok(ps, &tok, "expected '[' while parsing array", depth);
+    if (sch && !juno_schema_enter(ps, sch, JND_ARRAY, tok.start, depth)) return NULL;
+    const char *open = tok.start;
+
+    JsonNode *array = juno_ps_node(ps, JND_ARRAY, tok.start, depth);
+    JsonNode *tail = NULL;
+    if (!array) return juno_fail(ps, JUNO_ERR_OOM, "oom (array)", tok.start, depth);
 
     jl_skip_ws(lx);
     if (jl_peek(lx) == ']') { /* [] */
-        (void)jl_next(lx);
-        return array;
+        (void)juno_ps_next(ps);
+        goto done;
     }
 
+    size_t count = 0;
     while (1) {
-        JsonNode *val = juno_parse_value(lx, depth);
-        if (!val || juno_is_error(val)) {
-            err_msg = "error while parsing array element";
+        if (++count > ps->lim.max_members) {
+            juno_fail(ps, JUNO_ERR_TOO_MANY_MEMBERS, NULL, NULL, depth);
+            goto error;
+        }
+        if (sch && !juno_schema_item(ps, sch, count - 1, open, depth)) goto error;
+        JsonNode *val = juno_parse_value(ps, depth);
+        if (!val) {
+            juno_schema_unwind_index(ps, count - 1);
             goto error;
         }
 
@@ -319,71 +704,206 @@ JsonNode* juno_parse_array(JLexer *lx, unsigned short depth) {
         else array->first_child = val;
         tail = val;
 
-        tok = jl_next(lx);
+        tok = juno_ps_next(ps);
         if (tok.type == JTK_RBRACK) break;
         if (tok.type == JTK_COMMA) continue;
 
-        err_msg = "expected ',' or ']' while parsing array";
+        _fail_tok(ps, &tok, "expected ',' or ']' while parsing array", depth);
         goto error;
     }
+    juno_set_last_child(array, tail);
 
+done:
+    if (sch && !juno_schema_check(ps, sch, array, 0, open, depth)) goto error;
     return array;
 
 error:
     juno_free_ast(array);
-    return juno_error(err_msg, &tok);
+    return NULL;
 }
 
-JsonNode* juno_parse_obj(JLexer *lx, unsigned short depth) {
-    JsonNode *obj = juno_create_node(JND_OBJ);
-    JsonNode *tail = NULL;
-    char *err_msg = NULL;
+/* ------------------------------
+ * Duplicate member names
+ * ------------------------------ */
 
-    if (!obj) return juno_error("oom (object)", NULL);
-    if (depth > JUNO_MAX_NESTING) {
-        err_msg = "maximum nesting reached";
-        goto error;
+/* Objects up to this many members are checked by scanning their children;
+ * wider ones get an open-addressing set on ps->keys. */
+#define JDUP_SCAN 8
+
+/* An object's view of its name set. */
+typedef struct {
+    size_t base;   /* first slot in ps->keys */
+    size_t cap;    /* slots, 0 while scanning */
+    size_t n;      /* members so far */
+} JDupSet;
+
+static uint32_t _dup_hash(const char *key) {
+    uint32_t h = 2166136261u;  /* FNV-1a */
+    for (const unsigned char *p = (const unsigned char*)key; *p; p++) h = (h ^ *p) * 16777619u;
+    return h;
+}
+
+static JsonNode* _dup_find(const JParser *ps, const JsonNode *obj, const JDupSet *set, const char *key) {
+    if (!set->cap) {
+        for (JsonNode *c = obj->first_child; c; c = c->next_sibling) {
+            if (strcmp(c->key, key) == 0) return c;
+        }
+        return NULL;
+    }
+    uint32_t h = _dup_hash(key);
+    const JKeySlot *slots = ps->keys.slots + set->base;
+    size_t mask = set->cap - 1;
+    for (size_t i = h & mask; slots[i].member; i = (i + 1) & mask) {
+        if (slots[i].hash == h && strcmp(slots[i].member->key, key) == 0) return slots[i].member;
+    }
+    return NULL;
+}
+
+static void _dup_put(JKeySlot *slots, size_t cap, JsonNode *member, uint32_t h) {
+    size_t i = h & (cap - 1);
+    while (slots[i].member) i = (i + 1) & (cap - 1);
+    slots[i].hash = h;
+    slots[i].member = member;
+}
+
+/* Record `member`, already linked into `obj`. The set is the top of the
+ * stack here (nested objects have popped theirs), so it can grow in place:
+ * the larger table is built just above it and slid down. */
+static bool _dup_add(JParser *ps, const JsonNode *obj, JDupSet *set, JsonNode *member) {
+    set->n++;
+    if (!set->cap && set->n <= JDUP_SCAN) return true;
+
+    if (set->n * 2 > set->cap) {
+        size_t cap = set->cap ? set->cap * 2 : 4 * JDUP_SCAN;
+        JKeyStack *ks = &ps->keys;
+        if (ks->len + cap > ks->cap) {
+            size_t kcap = ks->cap ? ks->cap : 256;
+            while (kcap < ks->len + cap) kcap *= 2;
+            JKeySlot *p = (JKeySlot*)realloc(ks->slots, kcap * sizeof(*p));
+            if (!p) return false;
+            ks->slots = p;
+            ks->cap = kcap;
+        }
+
+        JKeySlot *old = ks->slots + set->base, *fresh = ks->slots + ks->len;
+        memset(fresh, 0, cap * sizeof(*fresh));
+        if (set->cap) {
+            for (size_t i = 0; i < set->cap; i++) {
+                if (old[i].member) _dup_put(fresh, cap, old[i].member, old[i].hash);
+            }
+        } else {
+            /* Leaving scan mode: `member` is among the children. */
+            for (JsonNode *c = obj->first_child; c; c = c->next_sibling) _dup_put(fresh, cap, c, _dup_hash(c->key));
+        }
+        memmove(old, fresh, cap * sizeof(*fresh));
+        ks->len = set->base + cap;
+        bool scanned = (set->cap == 0);
+        set->cap = cap;
+        if (scanned) return true;
     }
+    _dup_put(ps->keys.slots + set->base, set->cap, member, _dup_hash(member->key));
+    return true;
+}
+
+/* Give member `dst` the value of `src`; `src` is left with the old value. */
+static void _swap_value(JsonNode *dst, JsonNode *src) {
+    JsonNode t = *dst;
+    *dst = *src;
+    dst->key = t.key;
+    dst->next_sibling = t.next_sibling;
+    t.key = src->key;
+    t.next_sibling = src->next_sibling;
+    *src = t;
+}
+
+JsonNode* juno_parse_obj(JParser *ps, unsigned short depth) {
+    const JSNode *sch = ps->sch_next;
+    ps->sch_next = NULL;
+    if (depth > JUNO_MAX_NESTING) return juno_fail(ps, JUNO_ERR_NESTING, NULL, NULL, depth);
 
-    JToken tok = jl_next(lx);
-    if (tok.type != JTK_LBRACE) return juno_error("expected '{'", &tok);
+    JUNO_STAT(ps, if (depth > st_->max_depth) st_->max_depth = depth);
 
+    JToken tok = juno_ps_next(ps);
+    if (tok.type != JTK_LBRACE) return _fail_tok(ps, &tok, "expected '{'", depth);
+    if (sch && !juno_schema_enter(ps, sch, JND_OBJ, tok.start, depth)) return NULL;
+    const char *open = tok.start;
+    uint64_t seen = 0;   /* required members met, by schema bit */
+
+    JsonNode *obj = juno_ps_node(ps, JND_OBJ, tok.start, depth);
+    JsonNode *tail = NULL;
+    if (!obj) return juno_fail(ps, JUNO_ERR_OOM, "oom (object)", tok.start, depth);
+
+    JDupSet set = { ps->keys.len, 0, 0 };
+    size_t count = 0;
     int first = 1;
     while (1) {
-        tok = jl_next(lx);
+        tok = juno_ps_next(ps);
         if (tok.type == JTK_RBRACE) break;
 
         if (!first) {
             if (tok.type != JTK_COMMA) {
-                err_msg = "expected ',' between object properties";
+                _fail_tok(ps, &tok, "expected ',' between object properties", depth);
                 goto error;
             }
-            tok = jl_next(lx);
+            tok = juno_ps_next(ps);
         }
         first = 0;
 
         if (tok.type != JTK_STRING) {
-            err_msg = "expected string as object key";
+            _fail_tok(ps, &tok, "expected string as object key", depth);
+            goto error;
+        }
+        if (++count > ps->lim.max_members) {
+            juno_fail(ps, JUNO_ERR_TOO_MANY_MEMBERS, NULL, tok.start, depth);
             goto error;
         }
 
-        char *key = jl_string_to_utf8(&tok, NULL);
+        const char *err_msg = NULL;
+        const char *key_at = tok.start;
+        char *key = juno_ps_string(ps, &tok, &err_msg, depth);
         if (!key) {
-            err_msg = "invalid object key string";
+            juno_fail(ps, JUNO_ERR_INVALID_STRING, err_msg ? err_msg : "invalid object key string", tok.start, depth);
             goto error;
         }
 
-        tok = jl_next(lx);
+        tok = juno_ps_next(ps);
         if (tok.type != JTK_COLON) {
-            free(key);
-            err_msg = "expected ':' after object key";
+            juno_ps_release(ps, key);
+            _fail_tok(ps, &tok, "expected ':' after object key", depth);
             goto error;
         }
+        ps->b64_next = ps->b64_keys && _b64_key(ps->b64_keys, key);
+        if (sch && !juno_schema_member(ps, sch, key, &seen, key_at, depth)) {
+            juno_schema_unwind_key(ps, key);
+            juno_ps_release(ps, key);
+            goto error;
+        }
+
+        JsonNode *dup = (ps->dups != JUNO_DUP_ALLOW) ? _dup_find(ps, obj, &set, key) : NULL;
+        if (dup) {
+            juno_ps_release(ps, key);
+            if (ps->dups == JUNO_DUP_REJECT) {
+                juno_fail(ps, JUNO_ERR_DUPLICATE_KEY, "duplicate member name", key_at, depth);
+                goto error;
+            }
+            JArenaMark mark = { NULL, 0 };
+            if (ps->arena) mark = juno_arena_mark(ps->arena);
+            JsonNode *val = juno_parse_value(ps, depth);
+            if (!val) {
+                juno_schema_unwind_key(ps, dup->key);
+                goto error;
+            }
+            if (ps->dups == JUNO_DUP_LAST) _swap_value(dup, val);
+            juno_free_ast(val);
+            /* Nothing else was allocated since: give the dropped value back. */
+            if (ps->arena && ps->dups == JUNO_DUP_FIRST) juno_arena_rewind(ps->arena, mark);
+            continue;
+        }
 
-        JsonNode *val = juno_parse_value(lx, (unsigned short)(depth + 1));
-        if (!val || juno_is_error(val)) {
-            free(key);
-            err_msg = "error while parsing object value";
+        JsonNode *val = juno_parse_value(ps, depth);
+        if (!val) {
+            juno_schema_unwind_key(ps, key);
+            juno_ps_release(ps, key);
             goto error;
         }
         val->key = key;
@@ -391,39 +911,129 @@ JsonNode* juno_parse_obj(JLexer *lx, unsigned short depth) {
         if (tail) tail->next_sibling = val;
         else obj->first_child = val;
         tail = val;
+
+        if (ps->dups != JUNO_DUP_ALLOW && !_dup_add(ps, obj, &set, val)) {
+            juno_fail(ps, JUNO_ERR_OOM, "oom (member names)", key_at, depth);
+            goto error;
+        }
     }
 
+    ps->keys.len = set.base;
+    juno_set_last_child(obj, tail);
+    if (sch && !juno_schema_check(ps, sch, obj, seen, open, depth)) {
+        juno_free_ast(obj);
+        return NULL;
+    }
     return obj;
 
 error:
+    ps->keys.len = set.base;
     juno_free_ast(obj);
-    return juno_error(err_msg, &tok);
-
+    return NULL;
 }
 
 /* ------------------------------
  * Public parsing entry points
  * ------------------------------ */
 
-JsonNode* juno_parse(const char *json_str, size_t len) {
-    if (!json_str) return juno_error("null input", NULL);
+JsonNode* juno_parse_opts(const char *json_str, size_t len, const JunoParseOptions *opts, JunoError *err) {
+    if (!json_str) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_INVALID_ARG;
+            err->msg = "null input";
+        }
+        return NULL;
+    }
+    if (juno_parse_fast_ok(opts)) return juno_parse_fast(json_str, len, opts->mode, opts->arena, err);
+    return juno_parse_run(json_str, len, opts, NULL, NULL, err);
+}
+
+JsonNode* juno_parse_run(const char *json_str, size_t len, const JunoParseOptions *opts,
+                         const JSNode *schema, JunoSchemaError *serr, JunoError *err) {
+    JParser ps;
+    juno_parser_init(&ps, json_str, len);
+    juno_parser_set_options(&ps, opts);
+    ps.sch_next = schema;
+    ps.sch_err = serr;
 
-    JLexer lx;
-    jl_init(&lx, json_str, len);
+    JParseScope scope;
+    juno_parse_begin(&ps, &scope, opts, json_str, len);
+
+    JArenaMark mark = { NULL, 0 };
+    if (ps.arena) mark = juno_arena_mark(ps.arena);
 
     /* We count nesting starting at 1 for the root container, so that
        depth == JUNO_MAX_NESTING is allowed and depth == JUNO_MAX_NESTING + 1 is rejected. */
-    JsonNode *root = juno_parse_value(&lx, 0);
+    JsonNode *root = NULL;
+    if (len > ps.lim.max_input) juno_fail(&ps, JUNO_ERR_INPUT_TOO_LARGE, NULL, json_str, 0);
+    else root = juno_parse_value(&ps, 0);
+    if (!root && ps.arena) juno_arena_rewind(ps.arena, mark);
+    juno_parse_end(&ps, &scope, (size_t)(ps.lx.p - ps.lx.buf));
+    juno_parser_free_scratch(&ps);
+    if (err) *err = ps.err;
     return root;
 }
 
-JsonNode* juno_parse_file(const char *filename) {
-    if (!filename) return juno_error("null filename", NULL);
+JsonNode* juno_parse_ex(const char *json_str, size_t len, JunoError *err) {
+    return juno_parse_opts(json_str, len, NULL, err);
+}
+
+JsonNode* juno_parse(const char *json_str, size_t len) {
+    JunoError err;
+    JsonNode *root = juno_parse_ex(json_str, len, &err);
+    if (!root) return juno_error_node(&err, json_str, len);
+    return root;
+}
+
+static bool _load_file(const char *filename, size_t max_len, char **content, JunoError *err) {
+    memset(err, 0, sizeof(*err));
+    if (!filename) {
+        err->code = JUNO_ERR_INVALID_ARG;
+        err->msg = "null filename";
+        return false;
+    }
+    bool too_large = false;
+    *content = _read_file(filename, max_len, &too_large);
+    if (!*content) {
+        err->code = too_large ? JUNO_ERR_INPUT_TOO_LARGE : JUNO_ERR_IO;
+        err->msg = too_large ? "file exceeds the input limit" : "failed to read file";
+        return false;
+    }
+    return true;
+}
 
-    char *content = _read_file(filename);
-    if (!content) return juno_error("failed to read file", NULL);
+JsonNode* juno_parse_file_opts(const char *filename, const JunoParseOptions *opts, JunoError *err) {
+    JunoError local;
+    char *content = NULL;
+    if (!err) err = &local;
+    size_t max_len = (opts && opts->limits && opts->limits->max_input) ? opts->limits->max_input : SIZE_MAX;
+    if (!_load_file(filename, max_len, &content, err)) return NULL;
+
+    size_t len = strlen(content);
+    JsonNode *root = juno_parse_opts(content, len, opts, err);
+#if JUNO_ENABLE_STATS
+    if (opts && opts->stats) {
+        opts->stats->alloc_count++;
+        opts->stats->alloc_bytes += len + 1;
+    }
+#endif
+    free(content);
+    return root;
+}
+
+JsonNode* juno_parse_file_ex(const char *filename, JunoError *err) {
+    return juno_parse_file_opts(filename, NULL, err);
+}
+
+JsonNode* juno_parse_file(const char *filename) {
+    JunoError err;
+    char *content = NULL;
+    if (!_load_file(filename, SIZE_MAX, &content, &err)) return juno_error_node(&err, NULL, 0);
 
-    JsonNode *root = juno_parse(content, strlen(content));
+    size_t len = strlen(content);
+    JsonNode *root = juno_parse_ex(content, len, &err);
+    if (!root) root = juno_error_node(&err, content, len);
     free(content);
     return root;
 }
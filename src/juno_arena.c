@@ -0,0 +1,207 @@
+#include "internal/juno_internal.h"
+
+#include <juno/batch.h>
+
+/* ------------------------------
+ * Arena
+ * ------------------------------ */
+
+#define JARENA_ALIGN(n) (((n) + 7u) & ~(size_t)7u)
+
+static JArenaChunk* _chunk_new(size_t size) {
+    JArenaChunk *c = (JArenaChunk*)malloc(sizeof(JArenaChunk) + size);
+    if (!c) return NULL;
+    c->next = NULL;
+    c->size = size;
+    c->used = 0;
+    return c;
+}
+
+JunoArena* juno_arena_new(size_t chunk_size) {
+    JunoArena *a = (JunoArena*)calloc(1, sizeof(JunoArena));
+    if (!a) return NULL;
+    a->chunk_size = chunk_size ? JARENA_ALIGN(chunk_size) : JUNO_ARENA_CHUNK_SIZE;
+    return a;
+}
+
+void juno_arena_reset(JunoArena *a) {
+    if (!a) return;
+    for (JArenaChunk *c = a->first; c; c = c->next) c->used = 0;
+    a->cur = a->first;
+    a->last = NULL;
+}
+
+void juno_arena_free(JunoArena *a) {
+    if (!a) return;
+    JArenaChunk *c = a->first;
+    while (c) {
+        JArenaChunk *next = c->next;
+        free(c);
+        c = next;
+    }
+    free(a);
+}
+
+size_t juno_arena_used(const JunoArena *a) {
+    size_t used = 0;
+    if (!a) return 0;
+    for (const JArenaChunk *c = a->first; c; c = c->next) used += c->used;
+    return used;
+}
+
+size_t juno_arena_footprint(const JunoArena *a) {
+    size_t bytes = 0;
+    if (!a) return 0;
+    for (const JArenaChunk *c = a->first; c; c = c->next) bytes += sizeof(JArenaChunk) + c->size;
+    return bytes;
+}
+
+void* juno_arena_alloc(JunoArena *a, size_t size) {
+    size = JARENA_ALIGN(size ? size : 1);
+
+    JArenaChunk *c = a->cur;
+    if (!c || c->size - c->used < size) {
+        /* Chunks after the cursor are empty (reset / rewind clear them). */
+        while (c && c->next && c->next->size < size) c = c->next;
+        if (c && c->next) {
+            c = c->next;
+        } else {
+            JArenaChunk *nc = _chunk_new(size > a->chunk_size ? size : a->chunk_size);
+            if (!nc) return NULL;
+            if (c) {
+                nc->next = c->next;
+                c->next = nc;
+            } else {
+                nc->next = a->first;
+                a->first = nc;
+            }
+            c = nc;
+        }
+        a->cur = c;
+    }
+
+    void *p = c->data + c->used;
+    c->used += size;
+    a->last = p;
+    return p;
+}
+
+void juno_arena_shrink_last(JunoArena *a, void *p, size_t new_size) {
+    JArenaChunk *c = a->cur;
+    if (!p || p != a->last || !c) return;
+    c->used = (size_t)((unsigned char*)p - c->data) + JARENA_ALIGN(new_size ? new_size : 1);
+}
+
+JArenaMark juno_arena_mark(const JunoArena *a) {
+    JArenaMark m;
+    m.chunk = a->cur;
+    m.used = a->cur ? a->cur->used : 0;
+    return m;
+}
+
+void juno_arena_rewind(JunoArena *a, JArenaMark mark) {
+    JArenaChunk *c = mark.chunk ? mark.chunk : a->first;
+    if (!c) return;
+    c->used = mark.chunk ? mark.used : 0;
+    for (JArenaChunk *n = c->next; n; n = n->next) n->used = 0;
+    a->cur = c;
+    a->last = NULL;
+}
+
+/* ------------------------------
+ * Batch parsing
+ * ------------------------------ */
+
+struct JunoBatch {
+    JunoArena        *arena;
+    JunoParseOptions  opts;
+};
+
+JunoBatch* juno_batch_new(size_t chunk_size) {
+    JunoBatch *b = (JunoBatch*)calloc(1, sizeof(JunoBatch));
+    if (!b) return NULL;
+    b->arena = juno_arena_new(chunk_size);
+    if (!b->arena) {
+        free(b);
+        return NULL;
+    }
+    return b;
+}
+
+void juno_batch_set_options(JunoBatch *b, const JunoParseOptions *opts) {
+    if (!b) return;
+    if (opts) b->opts = *opts;
+    else memset(&b->opts, 0, sizeof(b->opts));
+    b->opts.arena = b->arena;
+}
+
+void juno_batch_free(JunoBatch *b) {
+    if (!b) return;
+    juno_arena_free(b->arena);
+    free(b);
+}
+
+size_t juno_batch_parse(JunoBatch *b, const JunoBuffer *items, size_t n,
+                        JsonNode **roots, JunoError *errs) {
+    if (!b || !roots || (!items && n)) return 0;
+
+    juno_arena_reset(b->arena);
+    b->opts.arena = b->arena;
+
+    /* Stats and hooks cover the whole batch. */
+    JParser ps;
+    JParseScope scope;
+    size_t ok = 0, total = 0;
+    juno_parser_init(&ps, NULL, 0);
+    juno_parser_set_options(&ps, &b->opts);
+    juno_parse_begin(&ps, &scope, &b->opts, NULL, 0);
+    JunoStats *stats = ps.stats;
+    bool fast = juno_parse_fast_ok(&b->opts);
+
+    for (size_t i = 0; i < n; i++) {
+        if (!items[i].data) {
+            roots[i] = NULL;
+            if (errs) {
+                memset(&errs[i], 0, sizeof(errs[i]));
+                errs[i].code = JUNO_ERR_INVALID_ARG;
+                errs[i].msg = "null input";
+            }
+            continue;
+        }
+
+        /* Same parser selection as juno_parse_opts. */
+        if (fast) {
+            JunoError e;
+            roots[i] = juno_parse_fast(items[i].data, items[i].len, b->opts.mode, b->arena, &e);
+            if (roots[i]) ok++;
+            if (errs) errs[i] = e;
+            total += items[i].len;
+            continue;
+        }
+
+        JArenaMark mark = juno_arena_mark(b->arena);
+        JKeyStack keys = ps.keys;
+        juno_parser_init(&ps, items[i].data, items[i].len);
+        juno_parser_set_options(&ps, &b->opts);
+        ps.stats = stats;
+        ps.keys = keys;
+
+        if (items[i].len > ps.lim.max_input) {
+            juno_fail(&ps, JUNO_ERR_INPUT_TOO_LARGE, NULL, items[i].data, 0);
+            roots[i] = NULL;
+        } else {
+            roots[i] = juno_parse_value(&ps, 0);
+        }
+        if (roots[i]) ok++;
+        else juno_arena_rewind(b->arena, mark);
+        if (errs) errs[i] = ps.err;
+        total += (size_t)(ps.lx.p - ps.lx.buf);
+    }
+
+    /* Report the batch as one parse over `total` bytes. */
+    memset(&ps.err, 0, sizeof(ps.err));
+    ps.stats = stats;
+    juno_parse_end(&ps, &scope, total);
+    juno_parser_free_scratch(&ps);
+    return ok;
+}
@@ -0,0 +1,246 @@
+#include "internal/juno_internal.h"
+
+#include <juno/base64.h>
+
+#ifndef JUNO_ENABLE_SIMD
+#define JUNO_ENABLE_SIMD 1
+#endif
+
+#if JUNO_ENABLE_SIMD && (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define JB64_SSSE3 1
+#include <tmmintrin.h>
+#else
+#define JB64_SSSE3 0
+#endif
+
+static const char JB64_STD[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char JB64_URL[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+/* ------------------------------
+ * Decoding
+ * ------------------------------ */
+
+/* 6-bit value of `c`, or -1. */
+static inline int _b64_val(unsigned char c, bool url) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == (url ? '-' : '+')) return 62;
+    if (c == (url ? '_' : '/')) return 63;
+    return -1;
+}
+
+#if JB64_SSSE3
+/* 16 characters to 12 bytes per step (the nibble-lookup scheme of Muła and
+ * Lemire): two shuffles classify every byte, a third picks the offset that
+ * maps it to its 6-bit value, and two multiply-adds pack the bits. Stops at
+ * the first block holding anything else (padding, invalid characters) and
+ * leaves it to the scalar loop. Writes 16 bytes per block, so it only runs
+ * while at least 24 characters remain. Returns the characters consumed. */
+__attribute__((target("ssse3")))
+static size_t _decode_ssse3(const char *src, size_t n, bool url, uint8_t *out) {
+    const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                         0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                         0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m128i m2f = _mm_set1_epi8(0x2F);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 24 <= n; i += 16, out += 12) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        if (url) {
+            /* '+' and '/' are not part of this alphabet; '-' and '_' become them. */
+            __m128i std = _mm_or_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8('+')), _mm_cmpeq_epi8(s, m2f));
+            if (_mm_movemask_epi8(std)) break;
+            __m128i dash = _mm_and_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8('-')), _mm_set1_epi8('+' - '-'));
+            __m128i us = _mm_and_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8('_')), _mm_set1_epi8('/' - '_'));
+            s = _mm_add_epi8(s, _mm_or_si128(dash, us));
+        }
+        __m128i hi_n = _mm_and_si128(_mm_srli_epi32(s, 4), m2f);
+        __m128i lo = _mm_shuffle_epi8(lut_lo, _mm_and_si128(s, m2f));
+        __m128i hi = _mm_shuffle_epi8(lut_hi, hi_n);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), zero)) != 0xFFFF) break;
+
+        __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(s, m2f), hi_n));
+        __m128i v = _mm_add_epi8(s, roll);
+        v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+        v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(v, pack));
+    }
+    return i;
+}
+#endif
+
+static bool _b64_fail(JunoError *err, const char *msg, size_t offset) {
+    if (err) {
+        memset(err, 0, sizeof(*err));
+        err->code = JUNO_ERR_INVALID_STRING;
+        err->msg = msg;
+        err->offset = offset;
+    }
+    return false;
+}
+
+bool juno_base64_decode(const char *src, size_t len, unsigned flags,
+                        uint8_t *out, size_t *out_len, JunoError *err) {
+    if (!src || !out) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_INVALID_ARG;
+            err->msg = "null input";
+        }
+        return false;
+    }
+    bool url = (flags & JUNO_BASE64_URL) != 0;
+
+    /* Up to two '=' may complete the last quantum. */
+    size_t n = len;
+    if (n % 4 == 0 && n > 0 && src[n - 1] == '=') {
+        n--;
+        if (src[n - 1] == '=') n--;
+    }
+
+    size_t i = 0, o = 0;
+#if JB64_SSSE3
+    if (n >= 24 && __builtin_cpu_supports("ssse3")) {
+        i = _decode_ssse3(src, n, url, out);
+        o = i / 4 * 3;
+    }
+#endif
+    for (; i + 4 <= n; i += 4, o += 3) {
+        int a = _b64_val((unsigned char)src[i], url), b = _b64_val((unsigned char)src[i + 1], url);
+        int c = _b64_val((unsigned char)src[i + 2], url), d = _b64_val((unsigned char)src[i + 3], url);
+        if ((a | b | c | d) < 0) break;
+        uint32_t q = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | (uint32_t)d;
+        out[o] = (uint8_t)(q >> 16);
+        out[o + 1] = (uint8_t)(q >> 8);
+        out[o + 2] = (uint8_t)q;
+    }
+
+    uint32_t q = 0;
+    size_t rem = 0;
+    for (; i < n; i++, rem++) {
+        int v = _b64_val((unsigned char)src[i], url);
+        if (v < 0) return _b64_fail(err, "invalid base64 character", i);
+        q = (q << 6) | (uint32_t)v;
+    }
+    if (rem == 1) return _b64_fail(err, "truncated base64", n - 1);
+    if (rem == 2) {
+        if (q & 0xF) return _b64_fail(err, "non-zero base64 trailing bits", n - 1);
+        out[o++] = (uint8_t)(q >> 4);
+    } else if (rem == 3) {
+        if (q & 0x3) return _b64_fail(err, "non-zero base64 trailing bits", n - 1);
+        out[o++] = (uint8_t)(q >> 10);
+        out[o++] = (uint8_t)(q >> 2);
+    }
+    if (out_len) *out_len = o;
+    if (err) memset(err, 0, sizeof(*err));
+    return true;
+}
+
+/* ------------------------------
+ * Encoding
+ * ------------------------------ */
+
+size_t juno_base64_encoded_len(size_t len, unsigned flags) {
+    if (flags & JUNO_BASE64_URL) return len / 3 * 4 + (len % 3 ? len % 3 + 1 : 0);
+    return (len + 2) / 3 * 4;
+}
+
+size_t juno_base64_encode(const uint8_t *src, size_t len, unsigned flags, char *out) {
+    const char *alpha = (flags & JUNO_BASE64_URL) ? JB64_URL : JB64_STD;
+    char *w = out;
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        uint32_t q = ((uint32_t)src[i] << 16) | ((uint32_t)src[i + 1] << 8) | src[i + 2];
+        *w++ = alpha[q >> 18];
+        *w++ = alpha[(q >> 12) & 63];
+        *w++ = alpha[(q >> 6) & 63];
+        *w++ = alpha[q & 63];
+    }
+    if (i < len) {
+        uint32_t q = (uint32_t)src[i] << 16;
+        if (i + 1 < len) q |= (uint32_t)src[i + 1] << 8;
+        *w++ = alpha[q >> 18];
+        *w++ = alpha[(q >> 12) & 63];
+        if (i + 1 < len) *w++ = alpha[(q >> 6) & 63];
+        if (!(flags & JUNO_BASE64_URL)) {
+            if (i + 1 == len) *w++ = '=';
+            *w++ = '=';
+        }
+    }
+    return (size_t)(w - out);
+}
+
+bool juno_w_base64(JWriter *w, const JsonNode *n) {
+    size_t len = 0;
+    const uint8_t *data = juno_binary(n, &len);
+    unsigned flags = (n->flags & JND_FLAG_BASE64URL) ? JUNO_BASE64_URL : 0;
+    char chunk[1024];
+
+    if (!juno_w_char(w, '"')) return false;
+    while (len > 0) {
+        size_t k = len < 768 ? len : 768;   /* whole quanta until the last chunk */
+        if (!juno_w_put(w, chunk, juno_base64_encode(data, k, flags, chunk))) return false;
+        data += k;
+        len -= k;
+    }
+    return juno_w_char(w, '"');
+}
+
+/* ------------------------------
+ * Binary nodes
+ * ------------------------------ */
+
+const uint8_t* juno_binary(const JsonNode *node, size_t *len) {
+    if (!node || node->type != JND_STRING || !(node->flags & JND_FLAG_BINARY) || !node->value.svalue) {
+        if (len) *len = 0;
+        return NULL;
+    }
+    const JBlob *b = (const JBlob*)node->value.svalue;
+    if (len) *len = b->len;
+    return b->data;
+}
+
+static uint8_t* _binary_oom(JunoError *err) {
+    if (err) {
+        memset(err, 0, sizeof(*err));
+        err->code = JUNO_ERR_OOM;
+        err->msg = "oom (binary)";
+    }
+    return NULL;
+}
+
+uint8_t* juno_binary_dup(const JsonNode *node, unsigned flags, size_t *len, JunoError *err) {
+    size_t n = 0;
+    const uint8_t *data = juno_binary(node, &n);
+    if (data) {
+        uint8_t *copy = (uint8_t*)malloc(n ? n : 1);
+        if (!copy) return _binary_oom(err);
+        memcpy(copy, data, n);
+        if (len) *len = n;
+        if (err) memset(err, 0, sizeof(*err));
+        return copy;
+    }
+    if (!node || node->type != JND_STRING) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_INVALID_ARG;
+            err->msg = "not a string";
+        }
+        return NULL;
+    }
+
+    const char *s = node->value.svalue ? node->value.svalue : "";
+    size_t slen = strlen(s);
+    uint8_t *out = (uint8_t*)malloc(juno_base64_decoded_max(slen) + 1);
+    if (!out) return _binary_oom(err);
+    if (!juno_base64_decode(s, slen, flags, out, len, err)) {
+        free(out);
+        return NULL;
+    }
+    return out;
+}
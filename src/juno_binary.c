@@ -0,0 +1,470 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "internal/juno_internal.h"
+
+#include <juno/base64.h>
+#include <juno/binary.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ------------------------------
+ * Image layout
+ * ------------------------------
+ *
+ *   [JBinHeader, 64 bytes][JBinNode x node_count][string pool]
+ *
+ * Nodes are stored in depth-first order, so the first child of a container
+ * always follows it directly; `next` links siblings. Strings and keys are
+ * NUL-terminated inside the pool and referenced by offset.
+ */
+
+#define JBIN_MAGIC      "JUNB"
+#define JBIN_BYTE_ORDER 0x0102u
+#define JBIN_NO_KEY     0xFFFFFFFFu
+
+typedef struct {
+    char     magic[4];
+    uint16_t version;
+    uint16_t byte_order;
+    uint32_t node_size;
+    uint32_t flags;         /* reserved, 0 */
+    uint64_t node_count;
+    uint64_t strings_size;
+    uint64_t checksum;      /* over everything after the header */
+    uint64_t reserved[3];
+} JBinHeader;
+
+typedef struct {
+    uint8_t  type;          /* JNodeType */
+    uint8_t  is_integer;
+    uint16_t reserved;
+    uint32_t key_len;
+    uint32_t key_off;       /* JBIN_NO_KEY when the node is not an object member */
+    uint32_t next;          /* next sibling index, JUNO_BIN_NONE if last */
+    uint64_t value;         /* int64 / double bits / bool / string offset */
+    uint32_t count;         /* containers: children; strings: byte length */
+    uint32_t reserved2;
+} JBinNode;
+
+struct JunoBinDoc {
+    const unsigned char *base;
+    size_t               size;
+    const JBinNode      *nodes;
+    uint32_t             node_count;
+    const char          *strings;
+    size_t               strings_size;
+    bool                 mapped;
+};
+
+/* 4-lane multiplicative hash over 64-bit words: cheap enough to verify
+ * large images at memory bandwidth, strong enough to catch corruption. */
+static uint64_t _rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+static uint64_t _checksum(const unsigned char *p, size_t n) {
+    const uint64_t k = 0x9E3779B97F4A7C15ULL;
+    uint64_t h[4] = {
+        0xCBF29CE484222325ULL, 0x84222325CBF29CE4ULL,
+        0x9CE484222325CBF2ULL, 0x2325CBF29CE48422ULL
+    };
+    size_t total = n;
+
+    while (n >= 32) {
+        for (int i = 0; i < 4; i++) {
+            uint64_t w;
+            memcpy(&w, p + 8 * i, 8);
+            h[i] = _rotl64((h[i] ^ w) * k, 31);
+        }
+        p += 32;
+        n -= 32;
+    }
+
+    uint64_t r = h[0] ^ _rotl64(h[1], 17) ^ _rotl64(h[2], 29) ^ _rotl64(h[3], 47);
+    while (n--) r = (r ^ *p++) * k;
+    r ^= (uint64_t)total;
+    r ^= r >> 33;
+    r *= 0xFF51AFD7ED558CCDULL;
+    r ^= r >> 33;
+    return r;
+}
+
+/* ------------------------------
+ * Encoding
+ * ------------------------------ */
+
+typedef struct {
+    JBinNode *nodes;
+    char     *strings;
+    uint32_t  n_nodes;
+    size_t    n_str;
+} JBinWriter;
+
+/* Text length of a string node; binary nodes are stored as base64. */
+static size_t _str_len(const JsonNode *node) {
+    size_t len = 0;
+    if (juno_binary(node, &len))
+        return juno_base64_encoded_len(len, (node->flags & JND_FLAG_BASE64URL) ? JUNO_BASE64_URL : 0);
+    return strlen(node->value.svalue ? node->value.svalue : "");
+}
+
+static bool _measure(const JsonNode *node, uint64_t *nodes, uint64_t *str_bytes) {
+    if (node->type == JND_ERROR) return false;
+    (*nodes)++;
+    if (node->key) *str_bytes += strlen(node->key) + 1;
+    if (node->type == JND_STRING) *str_bytes += _str_len(node) + 1;
+    for (const JsonNode *c = node->first_child; c; c = c->next_sibling) {
+        if (!_measure(c, nodes, str_bytes)) return false;
+    }
+    return true;
+}
+
+static uint32_t _put_str(JBinWriter *w, const char *s, size_t len) {
+    uint32_t off = (uint32_t)w->n_str;
+    memcpy(w->strings + w->n_str, s, len);
+    w->strings[w->n_str + len] = '\0';
+    w->n_str += len + 1;
+    return off;
+}
+
+static void _encode(JBinWriter *w, const JsonNode *node) {
+    uint32_t idx = w->n_nodes++;
+    JBinNode *rec = &w->nodes[idx];
+
+    memset(rec, 0, sizeof(*rec));
+    rec->type = (uint8_t)(node->type == JND_ROOT_OBJ ? JND_OBJ : node->type);
+    rec->next = JUNO_BIN_NONE;
+    rec->key_off = JBIN_NO_KEY;
+    if (node->key) {
+        size_t key_len = strlen(node->key);
+        rec->key_len = (uint32_t)key_len;
+        rec->key_off = _put_str(w, node->key, key_len);
+    }
+
+    switch (node->type) {
+        case JND_STRING: {
+            size_t len = 0;
+            const uint8_t *data = juno_binary(node, &len);
+            if (data) {
+                unsigned flags = (node->flags & JND_FLAG_BASE64URL) ? JUNO_BASE64_URL : 0;
+                rec->value = (uint32_t)w->n_str;
+                rec->count = (uint32_t)juno_base64_encode(data, len, flags, w->strings + w->n_str);
+                w->strings[w->n_str + rec->count] = '\0';
+                w->n_str += rec->count + 1;
+                break;
+            }
+            const char *s = node->value.svalue ? node->value.svalue : "";
+            len = strlen(s);
+            rec->count = (uint32_t)len;
+            rec->value = _put_str(w, s, len);
+            break;
+        }
+        case JND_NUMBER: {
+            /* Raw (lazy) numbers are converted here; integers beyond int64
+             * are stored as doubles. */
+            int64_t iv = 0;
+            double dv = 0.0;
+            rec->is_integer = juno_number_int64(node, &iv);
+            if (rec->is_integer) memcpy(&rec->value, &iv, 8);
+            else if (juno_number_double(node, &dv)) memcpy(&rec->value, &dv, 8);
+            break;
+        }
+        case JND_BOOL:
+            rec->value = node->value.bvalue ? 1 : 0;
+            break;
+        default: {
+            uint32_t prev = JUNO_BIN_NONE;
+            uint32_t count = 0;
+            for (const JsonNode *c = node->first_child; c; c = c->next_sibling) {
+                uint32_t cidx = w->n_nodes;
+                _encode(w, c);
+                if (prev != JUNO_BIN_NONE) w->nodes[prev].next = cidx;
+                prev = cidx;
+                count++;
+            }
+            w->nodes[idx].count = count;
+            break;
+        }
+    }
+}
+
+void* juno_encode_binary(const JsonNode *root, size_t *size, JunoError *err) {
+    JunoError local;
+    if (!err) err = &local;
+    memset(err, 0, sizeof(*err));
+
+    uint64_t n_nodes = 0, str_bytes = 0;
+    if (!root || !size || !_measure(root, &n_nodes, &str_bytes)) {
+        err->code = JUNO_ERR_INVALID_ARG;
+        err->msg = "cannot encode a NULL or error tree";
+        return NULL;
+    }
+    if (n_nodes >= JUNO_BIN_NONE || str_bytes >= JBIN_NO_KEY) {
+        err->code = JUNO_ERR_INVALID_ARG;
+        err->msg = "document too large for the binary format";
+        return NULL;
+    }
+
+    size_t total = sizeof(JBinHeader) + (size_t)n_nodes * sizeof(JBinNode) + (size_t)str_bytes;
+    unsigned char *image = (unsigned char*)calloc(1, total);
+    if (!image) {
+        err->code = JUNO_ERR_OOM;
+        err->msg = "oom (binary image)";
+        return NULL;
+    }
+
+    JBinWriter w;
+    w.nodes = (JBinNode*)(image + sizeof(JBinHeader));
+    w.strings = (char*)(w.nodes + n_nodes);
+    w.n_nodes = 0;
+    w.n_str = 0;
+    _encode(&w, root);
+
+    JBinHeader *hdr = (JBinHeader*)image;
+    memcpy(hdr->magic, JBIN_MAGIC, 4);
+    hdr->version = JUNO_BIN_VERSION;
+    hdr->byte_order = JBIN_BYTE_ORDER;
+    hdr->node_size = sizeof(JBinNode);
+    hdr->node_count = n_nodes;
+    hdr->strings_size = str_bytes;
+    hdr->checksum = _checksum(image + sizeof(JBinHeader), total - sizeof(JBinHeader));
+
+    *size = total;
+    return image;
+}
+
+bool juno_save_binary(const JsonNode *root, const char *path, JunoError *err) {
+    JunoError local;
+    if (!err) err = &local;
+
+    size_t size = 0;
+    void *image = juno_encode_binary(root, &size, err);
+    if (!image) return false;
+
+    FILE *fp = path ? fopen(path, "wb") : NULL;
+    bool ok = fp && fwrite(image, 1, size, fp) == size;
+    if (fp && fclose(fp) != 0) ok = false;
+    free(image);
+
+    if (!ok) {
+        err->code = JUNO_ERR_IO;
+        err->msg = "failed to write binary image";
+    }
+    return ok;
+}
+
+/* ------------------------------
+ * Loading
+ * ------------------------------ */
+
+static bool _bin_fail(JunoError *err, JunoErrorCode code, const char *msg) {
+    if (err) {
+        memset(err, 0, sizeof(*err));
+        err->code = code;
+        err->msg = msg;
+    }
+    return false;
+}
+
+static bool _bin_attach(JunoBinDoc *doc, const void *data, size_t size, unsigned flags, JunoError *err) {
+    if (size < sizeof(JBinHeader)) return _bin_fail(err, JUNO_ERR_BINARY_FORMAT, "image too small");
+
+    const JBinHeader *hdr = (const JBinHeader*)data;
+    if (memcmp(hdr->magic, JBIN_MAGIC, 4) != 0) return _bin_fail(err, JUNO_ERR_BINARY_FORMAT, "bad magic");
+    if (hdr->version != JUNO_BIN_VERSION) return _bin_fail(err, JUNO_ERR_BINARY_FORMAT, "unsupported version");
+    if (hdr->byte_order != JBIN_BYTE_ORDER) return _bin_fail(err, JUNO_ERR_BINARY_FORMAT, "foreign byte order");
+    if (hdr->node_size != sizeof(JBinNode)) return _bin_fail(err, JUNO_ERR_BINARY_FORMAT, "bad node size");
+    if (hdr->node_count == 0 || hdr->node_count >= JUNO_BIN_NONE ||
+        hdr->strings_size > size ||
+        hdr->node_count > (size - sizeof(JBinHeader)) / sizeof(JBinNode) ||
+        sizeof(JBinHeader) + hdr->node_count * sizeof(JBinNode) + hdr->strings_size != size)
+        return _bin_fail(err, JUNO_ERR_BINARY_FORMAT, "inconsistent sizes");
+
+    const unsigned char *base = (const unsigned char*)data;
+    if ((flags & JUNO_BIN_VERIFY) &&
+        _checksum(base + sizeof(JBinHeader), size - sizeof(JBinHeader)) != hdr->checksum)
+        return _bin_fail(err, JUNO_ERR_BINARY_FORMAT, "checksum mismatch");
+
+    doc->base = base;
+    doc->size = size;
+    doc->nodes = (const JBinNode*)(base + sizeof(JBinHeader));
+    doc->node_count = (uint32_t)hdr->node_count;
+    doc->strings = (const char*)(doc->nodes + hdr->node_count);
+    doc->strings_size = (size_t)hdr->strings_size;
+    if (err) memset(err, 0, sizeof(*err));
+    return true;
+}
+
+JunoBinDoc* juno_open_binary(const void *data, size_t size, unsigned flags, JunoError *err) {
+    if (!data || ((uintptr_t)data & 7u) != 0) {
+        _bin_fail(err, JUNO_ERR_INVALID_ARG, "image must be non-NULL and 8-byte aligned");
+        return NULL;
+    }
+
+    JunoBinDoc *doc = (JunoBinDoc*)calloc(1, sizeof(JunoBinDoc));
+    if (!doc) {
+        _bin_fail(err, JUNO_ERR_OOM, NULL);
+        return NULL;
+    }
+    if (!_bin_attach(doc, data, size, flags, err)) {
+        free(doc);
+        return NULL;
+    }
+    return doc;
+}
+
+JunoBinDoc* juno_load_binary(const char *path, unsigned flags, JunoError *err) {
+    if (!path) {
+        _bin_fail(err, JUNO_ERR_INVALID_ARG, "null filename");
+        return NULL;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        _bin_fail(err, JUNO_ERR_IO, "failed to open binary image");
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        _bin_fail(err, JUNO_ERR_IO, "failed to stat binary image");
+        return NULL;
+    }
+    if (st.st_size <= 0) {
+        close(fd);
+        _bin_fail(err, JUNO_ERR_BINARY_FORMAT, "empty binary image");
+        return NULL;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        _bin_fail(err, JUNO_ERR_IO, "mmap failed");
+        return NULL;
+    }
+
+    JunoBinDoc *doc = (JunoBinDoc*)calloc(1, sizeof(JunoBinDoc));
+    if (!doc || !_bin_attach(doc, map, size, flags, err)) {
+        if (!doc) _bin_fail(err, JUNO_ERR_OOM, NULL);
+        munmap(map, size);
+        free(doc);
+        return NULL;
+    }
+    doc->mapped = true;
+    return doc;
+}
+
+void juno_binary_close(JunoBinDoc *doc) {
+    if (!doc) return;
+    if (doc->mapped) munmap((void*)doc->base, doc->size);
+    free(doc);
+}
+
+/* ------------------------------
+ * Navigation
+ * ------------------------------ */
+
+static const JBinNode* _bin_node(const JunoBinDoc *doc, JunoBinRef ref) {
+    if (!doc || ref >= doc->node_count) return NULL;
+    return &doc->nodes[ref];
+}
+
+static const char* _bin_str(const JunoBinDoc *doc, uint64_t off, uint32_t len, size_t *len_out) {
+    if (off >= doc->strings_size || doc->strings_size - off <= len) return NULL;
+    if (len_out) *len_out = len;
+    return doc->strings + off;
+}
+
+JunoBinRef juno_bin_root(const JunoBinDoc *doc) {
+    return (doc && doc->node_count) ? 0 : JUNO_BIN_NONE;
+}
+
+size_t juno_bin_node_count(const JunoBinDoc *doc) {
+    return doc ? doc->node_count : 0;
+}
+
+JNodeType juno_bin_type(const JunoBinDoc *doc, JunoBinRef ref) {
+    const JBinNode *n = _bin_node(doc, ref);
+    return n ? (JNodeType)n->type : JND_ERROR;
+}
+
+JunoBinRef juno_bin_first_child(const JunoBinDoc *doc, JunoBinRef ref) {
+    const JBinNode *n = _bin_node(doc, ref);
+    if (!n || (n->type != JND_OBJ && n->type != JND_ARRAY) || n->count == 0) return JUNO_BIN_NONE;
+    return (ref + 1 < doc->node_count) ? ref + 1 : JUNO_BIN_NONE;
+}
+
+JunoBinRef juno_bin_next_sibling(const JunoBinDoc *doc, JunoBinRef ref) {
+    const JBinNode *n = _bin_node(doc, ref);
+    if (!n || n->next <= ref || n->next >= doc->node_count) return JUNO_BIN_NONE;
+    return n->next;
+}
+
+size_t juno_bin_child_count(const JunoBinDoc *doc, JunoBinRef ref) {
+    const JBinNode *n = _bin_node(doc, ref);
+    if (!n || (n->type != JND_OBJ && n->type != JND_ARRAY)) return 0;
+    return n->count;
+}
+
+const char* juno_bin_key(const JunoBinDoc *doc, JunoBinRef ref, size_t *len) {
+    const JBinNode *n = _bin_node(doc, ref);
+    if (!n || n->key_off == JBIN_NO_KEY) return NULL;
+    return _bin_str(doc, n->key_off, n->key_len, len);
+}
+
+const char* juno_bin_string(const JunoBinDoc *doc, JunoBinRef ref, size_t *len) {
+    const JBinNode *n = _bin_node(doc, ref);
+    if (!n || n->type != JND_STRING) return NULL;
+    return _bin_str(doc, n->value, n->count, len);
+}
+
+bool juno_bin_is_integer(const JunoBinDoc *doc, JunoBinRef ref) {
+    const JBinNode *n = _bin_node(doc, ref);
+    return n && n->type == JND_NUMBER && n->is_integer;
+}
+
+int64_t juno_bin_int(const JunoBinDoc *doc, JunoBinRef ref) {
+    const JBinNode *n = _bin_node(doc, ref);
+    if (!n || n->type != JND_NUMBER) return 0;
+    if (!n->is_integer) return (int64_t)juno_bin_double(doc, ref);
+    int64_t v;
+    memcpy(&v, &n->value, 8);
+    return v;
+}
+
+double juno_bin_double(const JunoBinDoc *doc, JunoBinRef ref) {
+    const JBinNode *n = _bin_node(doc, ref);
+    if (!n || n->type != JND_NUMBER) return 0.0;
+    if (n->is_integer) return (double)juno_bin_int(doc, ref);
+    double v;
+    memcpy(&v, &n->value, 8);
+    return v;
+}
+
+bool juno_bin_bool(const JunoBinDoc *doc, JunoBinRef ref) {
+    const JBinNode *n = _bin_node(doc, ref);
+    return n && n->type == JND_BOOL && n->value != 0;
+}
+
+JunoBinRef juno_bin_get(const JunoBinDoc *doc, JunoBinRef obj, const char *key) {
+    if (!key || juno_bin_type(doc, obj) != JND_OBJ) return JUNO_BIN_NONE;
+
+    size_t key_len = strlen(key);
+    for (JunoBinRef c = juno_bin_first_child(doc, obj); c != JUNO_BIN_NONE; c = juno_bin_next_sibling(doc, c)) {
+        size_t len = 0;
+        const char *k = juno_bin_key(doc, c, &len);
+        if (k && len == key_len && memcmp(k, key, len) == 0) return c;
+    }
+    return JUNO_BIN_NONE;
+}
+
+JunoBinRef juno_bin_at(const JunoBinDoc *doc, JunoBinRef arr, size_t index) {
+    if (juno_bin_type(doc, arr) != JND_ARRAY || index >= juno_bin_child_count(doc, arr)) return JUNO_BIN_NONE;
+
+    JunoBinRef c = juno_bin_first_child(doc, arr);
+    while (index-- && c != JUNO_BIN_NONE) c = juno_bin_next_sibling(doc, c);
+    return c;
+}
@@ -0,0 +1,265 @@
+#include "internal/juno_internal.h"
+
+#include <juno/base64.h>
+#include <juno/builder.h>
+
+/* ------------------------------
+ * Allocation
+ * ------------------------------ */
+
+static JsonNode* _b_node(JunoArena *arena, JNodeType type) {
+    if (!arena) return juno_create_node(type);
+
+    JsonNode *node = (JsonNode*)juno_arena_alloc(arena, sizeof(JsonNode));
+    if (!node) return NULL;
+    memset(node, 0, sizeof(*node));
+    node->type = type;
+    node->flags = JND_FLAG_ARENA;
+    return node;
+}
+
+static char* _b_strdup(JunoArena *arena, const char *s, size_t len) {
+    char *d = arena ? (char*)juno_arena_alloc(arena, len + 1) : (char*)malloc(len + 1);
+    if (!d) return NULL;
+    if (len) memcpy(d, s, len);
+    d[len] = '\0';
+    return d;
+}
+
+static inline bool _is_container(const JsonNode *n) {
+    return n && (n->type == JND_OBJ || n->type == JND_ARRAY || n->type == JND_ROOT_OBJ);
+}
+
+/* Drop the member name of a node that is being re-parented. */
+static void _drop_key(JsonNode *n) {
+    if (n->key && !(n->flags & JND_FLAG_ARENA)) free(n->key);
+    n->key = NULL;
+}
+
+static void _link(JsonNode *c, JsonNode *val) {
+    JsonNode *t = juno_last_child(c);
+    if (t) t->next_sibling = val;
+    else c->first_child = val;
+    juno_set_last_child(c, val);
+}
+
+/* ------------------------------
+ * Constructors
+ * ------------------------------ */
+
+JsonNode* juno_new_object(JunoArena *arena) { return _b_node(arena, JND_OBJ); }
+JsonNode* juno_new_array(JunoArena *arena)  { return _b_node(arena, JND_ARRAY); }
+JsonNode* juno_new_null(JunoArena *arena)   { return _b_node(arena, JND_NULL); }
+
+JsonNode* juno_new_string(JunoArena *arena, const char *s, size_t len) {
+    if (!s && len) return NULL;
+    JsonNode *n = _b_node(arena, JND_STRING);
+    if (!n) return NULL;
+    if ((n->value.svalue = _b_strdup(arena, s, len)) == NULL) {
+        juno_free_ast(n);
+        return NULL;
+    }
+    return n;
+}
+
+JsonNode* juno_new_int(JunoArena *arena, int64_t v) {
+    JsonNode *n = _b_node(arena, JND_NUMBER);
+    if (!n) return NULL;
+    n->is_integer = true;
+    n->value.ivalue = v;
+    return n;
+}
+
+JsonNode* juno_new_double(JunoArena *arena, double v) {
+    JsonNode *n = _b_node(arena, JND_NUMBER);
+    if (!n) return NULL;
+    n->value.nvalue = v;
+    return n;
+}
+
+JsonNode* juno_new_number_text(JunoArena *arena, const char *text, size_t len) {
+    if (!text) return NULL;
+
+    /* Accept exactly one JSON number token. */
+    JLexer lx;
+    jl_init(&lx, text, len);
+    JToken tok = jl_next(&lx);
+    if (tok.type != JTK_NUMBER || tok.start != text || tok.length != len) return NULL;
+
+    JsonNode *n = _b_node(arena, JND_NUMBER);
+    if (!n) return NULL;
+    if ((n->value.svalue = _b_strdup(arena, text, len)) == NULL) {
+        juno_free_ast(n);
+        return NULL;
+    }
+    n->flags |= JND_FLAG_RAW_NUMBER;
+    n->is_integer = strpbrk(n->value.svalue, ".eE") == NULL;
+    return n;
+}
+
+JsonNode* juno_new_binary(JunoArena *arena, const void *data, size_t len, unsigned flags) {
+    if (!data && len) return NULL;
+    JsonNode *n = _b_node(arena, JND_STRING);
+    if (!n) return NULL;
+    JBlob *b = arena ? (JBlob*)juno_arena_alloc(arena, sizeof(JBlob) + len) : (JBlob*)malloc(sizeof(JBlob) + len);
+    if (!b) {
+        juno_free_ast(n);
+        return NULL;
+    }
+    b->len = len;
+    if (len) memcpy(b->data, data, len);
+    n->value.svalue = (char*)b;
+    n->flags |= JND_FLAG_BINARY | ((flags & JUNO_BASE64_URL) ? JND_FLAG_BASE64URL : 0);
+    return n;
+}
+
+JsonNode* juno_new_bool(JunoArena *arena, bool v) {
+    JsonNode *n = _b_node(arena, JND_BOOL);
+    if (!n) return NULL;
+    n->value.bvalue = v;
+    return n;
+}
+
+static JsonNode* _clone_rec(JunoArena *arena, const JsonNode *src) {
+    JsonNode *n = _b_node(arena, src->type);
+    if (!n) return NULL;
+    n->is_integer = src->is_integer;
+
+    switch (src->type) {
+        case JND_NUMBER:
+            if (!(src->flags & JND_FLAG_RAW_NUMBER)) {
+                n->value = src->value;
+                break;
+            }
+            n->flags |= JND_FLAG_RAW_NUMBER;
+            /* fallthrough */
+        case JND_STRING:
+            if (src->flags & JND_FLAG_BINARY) {
+                size_t len = 0;
+                juno_binary(src, &len);
+                if ((n->value.svalue = _b_strdup(arena, src->value.svalue, sizeof(JBlob) + len)) == NULL) goto error;
+                n->flags |= src->flags & (JND_FLAG_BINARY | JND_FLAG_BASE64URL);
+                break;
+            }
+            /* fallthrough */
+        case JND_ERROR: {
+            const char *s = src->value.svalue;
+            if (s && (n->value.svalue = _b_strdup(arena, s, strlen(s))) == NULL) goto error;
+            break;
+        }
+        case JND_OBJ:
+        case JND_ARRAY:
+        case JND_ROOT_OBJ:
+            for (const JsonNode *c = src->first_child; c; c = c->next_sibling) {
+                JsonNode *cc = _clone_rec(arena, c);
+                if (!cc) goto error;
+                if (c->key && (cc->key = _b_strdup(arena, c->key, strlen(c->key))) == NULL) {
+                    juno_free_ast(cc);
+                    goto error;
+                }
+                _link(n, cc);
+            }
+            break;
+        default:
+            n->value = src->value;
+            break;
+    }
+    return n;
+
+error:
+    juno_free_ast(n);
+    return NULL;
+}
+
+JsonNode* juno_clone(JunoArena *arena, const JsonNode *node) {
+    if (!node) return NULL;
+
+    JArenaMark mark = { NULL, 0 };
+    if (arena) mark = juno_arena_mark(arena);
+
+    JsonNode *n = _clone_rec(arena, node);
+    if (!n && arena) juno_arena_rewind(arena, mark);
+    return n;
+}
+
+/* ------------------------------
+ * Editing
+ * ------------------------------ */
+
+bool juno_array_append(JsonNode *arr, JsonNode *val) {
+    if (!arr || arr->type != JND_ARRAY || !val || val->next_sibling) return false;
+    _drop_key(val);
+    _link(arr, val);
+    return true;
+}
+
+/* Give `val` the member name `key`, allocated like `val` itself. */
+static bool _set_key(JunoArena *arena, JsonNode *val, const char *key) {
+    bool in_arena = (val->flags & JND_FLAG_ARENA) != 0;
+    if (in_arena && !arena) return false;
+
+    char *k = _b_strdup(in_arena ? arena : NULL, key, strlen(key));
+    if (!k) return false;
+    _drop_key(val);
+    val->key = k;
+    return true;
+}
+
+bool juno_obj_append(JunoArena *arena, JsonNode *obj, const char *key, JsonNode *val) {
+    if (!obj || (obj->type != JND_OBJ && obj->type != JND_ROOT_OBJ) || !key || !val || val->next_sibling)
+        return false;
+    if (!_set_key(arena, val, key)) return false;
+    _link(obj, val);
+    return true;
+}
+
+bool juno_obj_set(JunoArena *arena, JsonNode *obj, const char *key, JsonNode *val) {
+    if (!obj || (obj->type != JND_OBJ && obj->type != JND_ROOT_OBJ) || !key || !val || val->next_sibling)
+        return false;
+
+    JsonNode *prev = NULL, *cur = obj->first_child;
+    while (cur && !(cur->key && strcmp(cur->key, key) == 0)) {
+        prev = cur;
+        cur = cur->next_sibling;
+    }
+    if (!cur) return juno_obj_append(arena, obj, key, val);
+    if (!_set_key(arena, val, key)) return false;
+
+    val->next_sibling = cur->next_sibling;
+    if (prev) prev->next_sibling = val;
+    else obj->first_child = val;
+    if (obj->value.last_child == cur) obj->value.last_child = val;
+
+    cur->next_sibling = NULL;
+    juno_free_ast(cur);
+    return true;
+}
+
+JsonNode* juno_obj_get(const JsonNode *obj, const char *key) {
+    if (!obj || (obj->type != JND_OBJ && obj->type != JND_ROOT_OBJ) || !key) return NULL;
+    for (JsonNode *c = obj->first_child; c; c = c->next_sibling) {
+        if (c->key && strcmp(c->key, key) == 0) return c;
+    }
+    return NULL;
+}
+
+JsonNode* juno_detach(JsonNode *parent, JsonNode *child) {
+    if (!_is_container(parent) || !child) return NULL;
+
+    JsonNode *prev = NULL, *cur = parent->first_child;
+    while (cur && cur != child) {
+        prev = cur;
+        cur = cur->next_sibling;
+    }
+    if (!cur) return NULL;
+
+    if (prev) prev->next_sibling = cur->next_sibling;
+    else parent->first_child = cur->next_sibling;
+    if (parent->value.last_child == cur) parent->value.last_child = prev;
+    cur->next_sibling = NULL;
+    return cur;
+}
+
+JsonNode* juno_obj_remove(JsonNode *obj, const char *key) {
+    return juno_detach(obj, juno_obj_get(obj, key));
+}
@@ -0,0 +1,240 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "internal/juno_internal.h"
+
+#include <juno/cache.h>
+#include <juno/hash.h>
+
+#include <pthread.h>
+
+#define JCACHE_MAX_SHARDS 16
+#define JCACHE_MIN_SHARD  64    /* entries per shard before splitting further */
+#define JCACHE_SEED       0x6a756e6f63616368ull
+#define JCACHE_NONE       UINT32_MAX
+
+/* ------------------------------
+ * Shards
+ * ------------------------------ */
+
+typedef struct {
+    uint64_t  hash;
+    size_t    len;
+    char     *text;     /* copy of the input; NULL marks a free slot */
+    JunoDoc  *doc;      /* the cache's reference */
+    size_t    bytes;    /* len + document footprint */
+    uint32_t  next;     /* bucket chain, or free list for free slots */
+    bool      ref;      /* atomic: CLOCK reference bit, set by hits */
+} JCacheEntry;
+
+typedef struct {
+    pthread_rwlock_t lock;
+    JCacheEntry *entries;
+    uint32_t    *buckets;
+    uint32_t     slots, mask;     /* entry capacity, bucket count - 1 */
+    uint32_t     n, hand, free_head;
+    size_t       bytes, max_bytes;
+    size_t       hits, misses, evictions;   /* atomic */
+} JCacheShard;
+
+struct JunoCache {
+    unsigned    nshards;
+    JCacheShard shards[JCACHE_MAX_SHARDS];
+};
+
+static inline JCacheShard* _shard_of(JunoCache *c, uint64_t h) {
+    return &c->shards[(h >> 32) & (c->nshards - 1)];
+}
+
+static uint32_t _shard_find(const JCacheShard *sh, uint64_t h, const char *data, size_t len) {
+    for (uint32_t i = sh->buckets[h & sh->mask]; i != JCACHE_NONE; i = sh->entries[i].next) {
+        const JCacheEntry *e = &sh->entries[i];
+        if (e->hash == h && e->len == len && memcmp(e->text, data, len) == 0) return i;
+    }
+    return JCACHE_NONE;
+}
+
+/* Remove entry `i` (write lock held). */
+static void _shard_drop(JCacheShard *sh, uint32_t i) {
+    JCacheEntry *e = &sh->entries[i];
+    uint32_t *link = &sh->buckets[e->hash & sh->mask];
+    while (*link != i) link = &sh->entries[*link].next;
+    *link = e->next;
+
+    juno_doc_release(e->doc);
+    free(e->text);
+    sh->n--;
+    sh->bytes -= e->bytes;
+    memset(e, 0, sizeof(*e));
+    e->next = sh->free_head;
+    sh->free_head = i;
+}
+
+/* CLOCK: skip (and clear) recently hit entries, evict the first cold one.
+ * Terminates within two sweeps since the hand clears every bit it passes. */
+static void _shard_evict(JCacheShard *sh) {
+    for (;;) {
+        uint32_t i = sh->hand;
+        sh->hand = (sh->hand + 1) % sh->slots;
+        JCacheEntry *e = &sh->entries[i];
+        if (!e->text) continue;
+        if (__atomic_exchange_n(&e->ref, false, __ATOMIC_RELAXED)) continue;
+        _shard_drop(sh, i);
+        __atomic_fetch_add(&sh->evictions, 1, __ATOMIC_RELAXED);
+        return;
+    }
+}
+
+static bool _shard_init(JCacheShard *sh, size_t slots, size_t max_bytes) {
+    uint32_t nb = 2;
+    while (nb < 2 * slots) nb *= 2;
+
+    memset(sh, 0, sizeof(*sh));
+    sh->entries = (JCacheEntry*)calloc(slots, sizeof(JCacheEntry));
+    sh->buckets = (uint32_t*)malloc(nb * sizeof(uint32_t));
+    if (!sh->entries || !sh->buckets || pthread_rwlock_init(&sh->lock, NULL) != 0) {
+        free(sh->entries);
+        free(sh->buckets);
+        return false;
+    }
+    sh->slots = (uint32_t)slots;
+    sh->mask = nb - 1;
+    sh->max_bytes = max_bytes;
+    for (uint32_t b = 0; b < nb; b++) sh->buckets[b] = JCACHE_NONE;
+    for (uint32_t i = 0; i < sh->slots; i++) sh->entries[i].next = (i + 1 < sh->slots) ? i + 1 : JCACHE_NONE;
+    return true;
+}
+
+static void _shard_clear(JCacheShard *sh) {
+    for (uint32_t i = 0; i < sh->slots; i++)
+        if (sh->entries[i].text) _shard_drop(sh, i);
+}
+
+/* ------------------------------
+ * Public API
+ * ------------------------------ */
+
+JunoCache* juno_cache_new(size_t max_entries, size_t max_bytes) {
+    if (max_entries == 0) max_entries = JUNO_CACHE_DEFAULT_ENTRIES;
+    if (max_bytes == 0) max_bytes = JUNO_CACHE_DEFAULT_BYTES;
+    if (max_entries > UINT32_MAX / 4) max_entries = UINT32_MAX / 4;
+
+    JunoCache *c = (JunoCache*)calloc(1, sizeof(JunoCache));
+    if (!c) return NULL;
+    /* Small caches get fewer shards: each keeps a useful share of the budget. */
+    c->nshards = 1;
+    while (c->nshards < JCACHE_MAX_SHARDS && c->nshards * 2 * JCACHE_MIN_SHARD <= max_entries) c->nshards *= 2;
+
+    for (unsigned s = 0; s < c->nshards; s++) {
+        if (!_shard_init(&c->shards[s], max_entries / c->nshards, max_bytes / c->nshards)) {
+            c->nshards = s;
+            juno_cache_free(c);
+            return NULL;
+        }
+    }
+    return c;
+}
+
+JunoDoc* juno_cache_parse(JunoCache *cache, const char *json_str, size_t len, JunoError *err) {
+    if (!cache || !json_str) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_INVALID_ARG;
+            err->msg = "null input";
+        }
+        return NULL;
+    }
+
+    uint64_t h = juno_hash_bytes(json_str, len, JCACHE_SEED);
+    JCacheShard *sh = _shard_of(cache, h);
+    JunoDoc *doc = NULL;
+
+    pthread_rwlock_rdlock(&sh->lock);
+    uint32_t i = _shard_find(sh, h, json_str, len);
+    if (i != JCACHE_NONE) {
+        doc = juno_doc_retain(sh->entries[i].doc);
+        __atomic_store_n(&sh->entries[i].ref, true, __ATOMIC_RELAXED);
+    }
+    pthread_rwlock_unlock(&sh->lock);
+
+    if (doc) {
+        __atomic_fetch_add(&sh->hits, 1, __ATOMIC_RELAXED);
+        if (err) memset(err, 0, sizeof(*err));
+        return doc;
+    }
+
+    /* Miss: parse outside the lock. */
+    __atomic_fetch_add(&sh->misses, 1, __ATOMIC_RELAXED);
+    doc = juno_doc_parse(json_str, len, err);
+    if (!doc) return NULL;
+
+    size_t bytes = len + juno_doc_footprint(doc);
+    if (bytes > sh->max_bytes) return doc;
+    char *text = (char*)malloc(len ? len : 1);
+    if (!text) return doc;
+    memcpy(text, json_str, len);
+
+    pthread_rwlock_wrlock(&sh->lock);
+    i = _shard_find(sh, h, json_str, len);
+    if (i != JCACHE_NONE) {
+        /* Another thread inserted the same input meanwhile: share its copy. */
+        JunoDoc *cached = juno_doc_retain(sh->entries[i].doc);
+        pthread_rwlock_unlock(&sh->lock);
+        free(text);
+        juno_doc_release(doc);
+        return cached;
+    }
+    while (sh->n > 0 && (sh->n == sh->slots || sh->bytes + bytes > sh->max_bytes)) _shard_evict(sh);
+
+    i = sh->free_head;
+    JCacheEntry *e = &sh->entries[i];
+    sh->free_head = e->next;
+    e->hash = h;
+    e->len = len;
+    e->text = text;
+    e->doc = juno_doc_retain(doc);
+    e->bytes = bytes;
+    e->ref = false;
+    e->next = sh->buckets[h & sh->mask];
+    sh->buckets[h & sh->mask] = i;
+    sh->n++;
+    sh->bytes += bytes;
+    pthread_rwlock_unlock(&sh->lock);
+    return doc;
+}
+
+void juno_cache_stats(JunoCache *cache, JunoCacheStats *out) {
+    memset(out, 0, sizeof(*out));
+    if (!cache) return;
+    for (unsigned s = 0; s < cache->nshards; s++) {
+        JCacheShard *sh = &cache->shards[s];
+        pthread_rwlock_rdlock(&sh->lock);
+        out->entries += sh->n;
+        out->bytes += sh->bytes;
+        pthread_rwlock_unlock(&sh->lock);
+        out->hits += __atomic_load_n(&sh->hits, __ATOMIC_RELAXED);
+        out->misses += __atomic_load_n(&sh->misses, __ATOMIC_RELAXED);
+        out->evictions += __atomic_load_n(&sh->evictions, __ATOMIC_RELAXED);
+    }
+}
+
+void juno_cache_clear(JunoCache *cache) {
+    if (!cache) return;
+    for (unsigned s = 0; s < cache->nshards; s++) {
+        JCacheShard *sh = &cache->shards[s];
+        pthread_rwlock_wrlock(&sh->lock);
+        _shard_clear(sh);
+        pthread_rwlock_unlock(&sh->lock);
+    }
+}
+
+void juno_cache_free(JunoCache *cache) {
+    if (!cache) return;
+    for (unsigned s = 0; s < cache->nshards; s++) {
+        JCacheShard *sh = &cache->shards[s];
+        _shard_clear(sh);
+        pthread_rwlock_destroy(&sh->lock);
+        free(sh->entries);
+        free(sh->buckets);
+    }
+    free(cache);
+}
@@ -0,0 +1,474 @@
+#include "internal/juno_internal.h"
+
+#include <juno/writer.h>
+
+#include <math.h>
+
+/* ------------------------------
+ * ECMAScript number formatting
+ * ------------------------------ */
+
+/* Number::toString(d) for a finite double (RFC 8785 section 3.2.2.3):
+ * the shortest digit string that reads back as `d`, placed according to
+ * its decimal exponent. Writes at most 26 bytes plus the terminator. */
+static int _es_number(double d, char *out) {
+    if (d == 0) { /* also -0 */
+        out[0] = '0';
+        out[1] = '\0';
+        return 1;
+    }
+
+    char tmp[40];
+    for (int prec = 0; prec <= 16; prec++) {
+        snprintf(tmp, sizeof(tmp), "%.*e", prec, d);
+        if (strtod(tmp, NULL) == d) break;
+    }
+
+    /* tmp = [-]D[.DDD]e(+|-)XX */
+    const char *p = tmp;
+    bool neg = (*p == '-');
+    if (neg) p++;
+    char digits[20];
+    int k = 0;
+    for (; *p && *p != 'e'; p++) {
+        if (*p != '.') digits[k++] = *p;
+    }
+    while (k > 1 && digits[k - 1] == '0') k--;
+    int n = atoi(p + 1) + 1;   /* value = 0.digits * 10^n */
+
+    char *o = out;
+    if (neg) *o++ = '-';
+    if (k <= n && n <= 21) {
+        memcpy(o, digits, (size_t)k);
+        o += k;
+        for (int i = 0; i < n - k; i++) *o++ = '0';
+    } else if (0 < n && n <= 21) {
+        memcpy(o, digits, (size_t)n);
+        o += n;
+        *o++ = '.';
+        memcpy(o, digits + n, (size_t)(k - n));
+        o += k - n;
+    } else if (-6 < n && n <= 0) {
+        *o++ = '0';
+        *o++ = '.';
+        for (int i = 0; i < -n; i++) *o++ = '0';
+        memcpy(o, digits, (size_t)k);
+        o += k;
+    } else {
+        *o++ = digits[0];
+        if (k > 1) {
+            *o++ = '.';
+            memcpy(o, digits + 1, (size_t)(k - 1));
+            o += k - 1;
+        }
+        o += sprintf(o, "e%c%d", n - 1 < 0 ? '-' : '+', n - 1 < 0 ? 1 - n : n - 1);
+    }
+    *o = '\0';
+    return (int)(o - out);
+}
+
+static bool _canon_double(JWriter *w, double d, unsigned depth) {
+    char num[32];
+    if (!isfinite(d)) return juno_w_fail(w, JUNO_ERR_INVALID_NUMBER, "non-finite number", depth);
+    return juno_w_put(w, num, (size_t)_es_number(d, num));
+}
+
+/* ------------------------------
+ * Member ordering
+ * ------------------------------ */
+
+/* Scratch entry for one object member. `prefix` holds the first 8 key bytes
+ * big-endian so most comparisons never touch the key itself. */
+typedef struct {
+    uint64_t        prefix;
+    const char     *key;
+    size_t          key_len;
+    size_t          key_off;   /* streaming: offset of the decoded key in JCanon.keys */
+    const JsonNode *node;      /* tree mode */
+    const char     *vstart;    /* streaming: value text */
+    size_t          vlen;
+} JCanonMember;
+
+static uint64_t _key_prefix(const char *key, size_t len) {
+    uint64_t p = 0;
+    for (size_t i = 0; i < 8; i++) p = (p << 8) | (i < len ? (unsigned char)key[i] : 0);
+    return p;
+}
+
+/* Decode the UTF-8 sequence at s (lenient: a malformed byte stands for itself). */
+static uint32_t _utf8_cp(const unsigned char *s, size_t len) {
+    unsigned c = s[0];
+    size_t n = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+    if (n > len) return c;
+    uint32_t cp = n == 1 ? c : c & (0x3F >> (n - 1));
+    for (size_t i = 1; i < n; i++) cp = (cp << 6) | (s[i] & 0x3F);
+    return cp;
+}
+
+/* First UTF-16 code unit of a code point. */
+static inline uint32_t _utf16_lead(uint32_t cp) {
+    return cp < 0x10000 ? cp : 0xD800 + ((cp - 0x10000) >> 10);
+}
+
+/* Compare UTF-8 strings by their UTF-16 code units. UTF-8 byte order agrees
+ * with it except between U+E000..U+FFFF and supplementary characters, so
+ * only the first differing character needs decoding. */
+static int _cmp_utf16(const char *a, size_t la, const char *b, size_t lb) {
+    size_t n = la < lb ? la : lb, i = 0;
+    while (i < n && a[i] == b[i]) i++;
+    if (i == n) return la < lb ? -1 : la > lb;
+
+    const unsigned char *ua = (const unsigned char*)a, *ub = (const unsigned char*)b;
+    if (ua[i] < 0x80 && ub[i] < 0x80) return ua[i] < ub[i] ? -1 : 1;
+
+    while (i > 0 && (ua[i] & 0xC0) == 0x80) i--;
+    uint32_t ca = _utf8_cp(ua + i, la - i), cb = _utf8_cp(ub + i, lb - i);
+    uint32_t ea = _utf16_lead(ca), eb = _utf16_lead(cb);
+    if (ea != eb) return ea < eb ? -1 : 1;
+    return ca < cb ? -1 : ca > cb;
+}
+
+static int _member_cmp(const JCanonMember *a, const JCanonMember *b) {
+    uint64_t x = a->prefix ^ b->prefix;
+    if (x) {
+        int shift = 56 - (__builtin_clzll(x) & ~7);
+        unsigned ba = (unsigned)(a->prefix >> shift) & 0xFF, bb = (unsigned)(b->prefix >> shift) & 0xFF;
+        if (ba < 0x80 && bb < 0x80) return ba < bb ? -1 : 1;
+    }
+    return _cmp_utf16(a->key, a->key_len, b->key, b->key_len);
+}
+
+static int _member_qsort_cmp(const void *a, const void *b) {
+    return _member_cmp((const JCanonMember*)a, (const JCanonMember*)b);
+}
+
+static void _sort_members(JCanonMember *m, size_t n) {
+    if (n > 16) {
+        qsort(m, n, sizeof(JCanonMember), _member_qsort_cmp);
+        return;
+    }
+    for (size_t i = 1; i < n; i++) {
+        JCanonMember t = m[i];
+        size_t j = i;
+        for (; j > 0 && _member_cmp(&m[j - 1], &t) > 0; j--) m[j] = m[j - 1];
+        m[j] = t;
+    }
+}
+
+/* ------------------------------
+ * Canonicalizer state
+ * ------------------------------ */
+
+/* Members of every open object live on one stack: an object pushes its
+ * members, sorts that slice, writes them and pops it again. */
+typedef struct {
+    JWriter      *w;
+    JCanonMember *m;
+    size_t        m_len, m_cap;
+    char         *keys;        /* streaming: decoded member names (stack too) */
+    size_t        k_len, k_cap;
+    const char   *base;        /* streaming: input start, for error offsets */
+} JCanon;
+
+static JCanonMember* _push_member(JCanon *c) {
+    if (c->m_len == c->m_cap) {
+        size_t cap = c->m_cap ? c->m_cap * 2 : 64;
+        JCanonMember *m = (JCanonMember*)realloc(c->m, cap * sizeof(JCanonMember));
+        if (!m) return NULL;
+        c->m = m;
+        c->m_cap = cap;
+    }
+    return &c->m[c->m_len++];
+}
+
+/* Sort the members pushed since `base`. Returns a member whose name is
+ * duplicated, or NULL. */
+static const JCanonMember* _order_members(JCanon *c, size_t base) {
+    JCanonMember *m = c->m + base;
+    size_t n = c->m_len - base;
+    _sort_members(m, n);
+    for (size_t i = 1; i < n; i++) {
+        if (m[i].key_len == m[i - 1].key_len && memcmp(m[i].key, m[i - 1].key, m[i].key_len) == 0)
+            return &m[i];
+    }
+    return NULL;
+}
+
+/* ------------------------------
+ * Tree canonicalization
+ * ------------------------------ */
+
+static bool _canon_node(JCanon *c, const JsonNode *n, unsigned depth) {
+    JWriter *w = c->w;
+    switch (n->type) {
+        case JND_NULL:   return juno_w_put(w, "null", 4);
+        case JND_BOOL:   return n->value.bvalue ? juno_w_put(w, "true", 4) : juno_w_put(w, "false", 5);
+        case JND_STRING: {
+            if (n->flags & JND_FLAG_BINARY) return juno_w_base64(w, n);
+            const char *s = n->value.svalue ? n->value.svalue : "";
+            return juno_w_string(w, s, strlen(s));
+        }
+        case JND_NUMBER: {
+            double d = 0.0;
+            if (!juno_number_double(n, &d)) return juno_w_fail(w, JUNO_ERR_INVALID_NUMBER, "number out of range", depth);
+            return _canon_double(w, d, depth);
+        }
+        case JND_ERROR:
+            return juno_w_fail(w, JUNO_ERR_INVALID_ARG, "cannot serialize an error node", depth);
+        default:
+            break;
+    }
+
+    if (++depth > JUNO_MAX_NESTING) return juno_w_fail(w, JUNO_ERR_NESTING, NULL, depth);
+
+    if (n->type == JND_ARRAY) {
+        if (!juno_w_char(w, '[')) return false;
+        for (const JsonNode *ch = n->first_child; ch; ch = ch->next_sibling) {
+            if (ch != n->first_child && !juno_w_char(w, ',')) return false;
+            if (!_canon_node(c, ch, depth)) return false;
+        }
+        return juno_w_char(w, ']');
+    }
+
+    size_t base = c->m_len;
+    for (const JsonNode *ch = n->first_child; ch; ch = ch->next_sibling) {
+        JCanonMember *m = _push_member(c);
+        if (!m) return juno_w_fail(w, JUNO_ERR_OOM, "oom (member index)", depth);
+        m->key = ch->key ? ch->key : "";
+        m->key_len = strlen(m->key);
+        m->prefix = _key_prefix(m->key, m->key_len);
+        m->node = ch;
+    }
+
+    bool ok = true;
+    if (_order_members(c, base)) ok = juno_w_fail(w, JUNO_ERR_INVALID_ARG, "duplicate member name", depth);
+    ok = ok && juno_w_char(w, '{');
+    for (size_t i = base; ok && i < c->m_len; i++) {
+        /* Copy: nested objects push above this slice and may move the stack. */
+        JCanonMember m = c->m[i];
+        ok = (i == base || juno_w_char(w, ',')) && juno_w_string(w, m.key, m.key_len) &&
+             juno_w_char(w, ':') && _canon_node(c, m.node, depth);
+    }
+    c->m_len = base;
+    return ok && juno_w_char(w, '}');
+}
+
+bool juno_write_canonical(const JsonNode *root, JunoWriteFn fn, void *ud, JunoError *err) {
+    JWriter *w = (JWriter*)malloc(sizeof(JWriter));
+    if (!w) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_OOM;
+            err->msg = "oom (writer)";
+        }
+        return false;
+    }
+    juno_writer_init(w, fn, ud);
+
+    JCanon c;
+    memset(&c, 0, sizeof(c));
+    c.w = w;
+
+    bool ok;
+    if (!root || !fn) ok = juno_w_fail(w, JUNO_ERR_INVALID_ARG, "null input", 0);
+    else ok = _canon_node(&c, root, 0) && juno_w_flush(w);
+
+    if (err) *err = w->err;
+    free(c.m);
+    free(w);
+    return ok;
+}
+
+char* juno_stringify_canonical(const JsonNode *root, size_t *len, JunoError *err) {
+    return juno_stringify_with(juno_write_canonical, root, len, err);
+}
+
+/* ------------------------------
+ * Streaming canonicalization
+ * ------------------------------ */
+
+static bool _text_fail(JCanon *c, JunoErrorCode code, const char *msg, const char *at, unsigned depth) {
+    JunoError *e = &c->w->err;
+    if (e->code == JUNO_OK) {
+        e->code = code;
+        e->msg = msg;
+        e->offset = (size_t)(at - c->base);
+        e->depth = depth;
+    }
+    return false;
+}
+
+static bool _tok_fail(JCanon *c, const JToken *tok, const char *msg, unsigned depth) {
+    return _text_fail(c, juno_lex_error_code(tok), tok->type == JTK_ERROR ? tok->err_msg : msg, tok->start, depth);
+}
+
+/* Decode a string token onto the key stack; returns its offset there. */
+static bool _decode_key(JCanon *c, const JToken *tok, size_t *off, size_t *len, unsigned depth) {
+    size_t n = tok->length - 2;
+    if (n + 1 > c->k_cap - c->k_len) {
+        size_t cap = c->k_cap ? c->k_cap : 1024;
+        while (n + 1 > cap - c->k_len) cap *= 2;
+        char *k = (char*)realloc(c->keys, cap);
+        if (!k) return _text_fail(c, JUNO_ERR_OOM, "oom (key stack)", tok->start, depth);
+        c->keys = k;
+        c->k_cap = cap;
+    }
+
+    const char *msg = NULL;
+    if (!jl_decode_string_into(tok->start + 1, n, c->keys + c->k_len, len, &msg))
+        return _text_fail(c, JUNO_ERR_INVALID_STRING, msg ? msg : "invalid string", tok->start, depth);
+    *off = c->k_len;
+    c->k_len += *len + 1;
+    return true;
+}
+
+static bool _canon_text(JCanon *c, JLexer *lx, unsigned depth);
+
+static bool _canon_text_obj(JCanon *c, JLexer *lx, unsigned depth) {
+    size_t base = c->m_len, kbase = c->k_len;
+    JToken tok = jl_next(lx);  /* '{' */
+
+    tok = jl_next(lx);
+    if (tok.type != JTK_RBRACE) {
+        for (;;) {
+            if (tok.type != JTK_STRING) return _tok_fail(c, &tok, "expected string as object key", depth);
+
+            size_t off = 0, klen = 0;
+            if (!_decode_key(c, &tok, &off, &klen, depth)) return false;
+
+            tok = jl_next(lx);
+            if (tok.type != JTK_COLON) return _tok_fail(c, &tok, "expected ':' after object key", depth);
+
+            /* Only remember where the value is; it is canonicalized (and
+             * validated) when its member comes up in sorted order. */
+            jl_skip_ws(lx);
+            const char *vstart = lx->p;
+            unsigned budget = JUNO_MAX_NESTING > depth ? (unsigned)(JUNO_MAX_NESTING - depth) : 0;
+            switch (jl_skip_value(lx, budget)) {
+                case JL_SKIP_OK:      break;
+                case JL_SKIP_EOF:     return _text_fail(c, JUNO_ERR_UNEXPECTED_EOF, "unexpected end of input", lx->p, depth);
+                case JL_SKIP_NESTING: return _text_fail(c, JUNO_ERR_NESTING, NULL, lx->p, depth);
+                case JL_SKIP_STRING:  return _text_fail(c, JUNO_ERR_INVALID_STRING, "invalid string", lx->p, depth);
+                default:              return _text_fail(c, JUNO_ERR_UNEXPECTED_TOKEN, "unexpected character", lx->p, depth);
+            }
+
+            JCanonMember *m = _push_member(c);
+            if (!m) return _text_fail(c, JUNO_ERR_OOM, "oom (member index)", vstart, depth);
+            m->key_off = off;
+            m->key_len = klen;
+            m->vstart = vstart;
+            m->vlen = (size_t)(lx->p - vstart);
+
+            tok = jl_next(lx);
+            if (tok.type == JTK_RBRACE) break;
+            if (tok.type != JTK_COMMA) return _tok_fail(c, &tok, "expected ',' between object properties", depth);
+            tok = jl_next(lx);
+        }
+    }
+
+    /* The key stack is final for this object: resolve names, then sort. */
+    for (size_t i = base; i < c->m_len; i++) {
+        c->m[i].key = c->keys + c->m[i].key_off;
+        c->m[i].prefix = _key_prefix(c->m[i].key, c->m[i].key_len);
+    }
+
+    JWriter *w = c->w;
+    const JCanonMember *dup = _order_members(c, base);
+    bool ok = dup ? _text_fail(c, JUNO_ERR_INVALID_ARG, "duplicate member name", dup->vstart, depth)
+                  : juno_w_char(w, '{');
+    for (size_t i = base; ok && i < c->m_len; i++) {
+        /* Copy and re-resolve: nested objects may grow (and move) both stacks. */
+        JCanonMember m = c->m[i];
+        JLexer sub;
+        jl_init(&sub, m.vstart, m.vlen);
+        ok = (i == base || juno_w_char(w, ',')) && juno_w_string(w, c->keys + m.key_off, m.key_len) &&
+             juno_w_char(w, ':') && _canon_text(c, &sub, depth);
+    }
+    c->m_len = base;
+    c->k_len = kbase;
+    return ok && juno_w_char(w, '}');
+}
+
+static bool _canon_text(JCanon *c, JLexer *lx, unsigned depth) {
+    JWriter *w = c->w;
+    jl_skip_ws(lx);
+
+    char first = jl_peek(lx);
+    if (first == '{' || first == '[') {
+        if (++depth > JUNO_MAX_NESTING) return _text_fail(c, JUNO_ERR_NESTING, NULL, lx->p, depth);
+        if (first == '{') return _canon_text_obj(c, lx, depth);
+
+        (void)jl_next(lx);
+        if (!juno_w_char(w, '[')) return false;
+        jl_skip_ws(lx);
+        if (jl_peek(lx) == ']') {
+            (void)jl_next(lx);
+            return juno_w_char(w, ']');
+        }
+        for (;;) {
+            if (!_canon_text(c, lx, depth)) return false;
+            JToken tok = jl_next(lx);
+            if (tok.type == JTK_RBRACK) return juno_w_char(w, ']');
+            if (tok.type != JTK_COMMA) return _tok_fail(c, &tok, "expected ',' or ']' while parsing array", depth);
+            if (!juno_w_char(w, ',')) return false;
+        }
+    }
+
+    JToken tok = jl_next(lx);
+    switch (tok.type) {
+        case JTK_STRING: {
+            size_t off = 0, len = 0;
+            if (!_decode_key(c, &tok, &off, &len, depth)) return false;
+            bool ok = juno_w_string(w, c->keys + off, len);
+            c->k_len = off;
+            return ok;
+        }
+        case JTK_NUMBER: {
+            double d = 0.0;
+            if (!jl_number_to_double(&tok, &d)) return _text_fail(c, JUNO_ERR_INVALID_NUMBER, "number out of range", tok.start, depth);
+            return _canon_double(w, d, depth);
+        }
+        case JTK_TRUE:  return juno_w_put(w, "true", 4);
+        case JTK_FALSE: return juno_w_put(w, "false", 5);
+        case JTK_NULL:  return juno_w_put(w, "null", 4);
+        default:        return _tok_fail(c, &tok, "unexpected token while parsing value", depth);
+    }
+}
+
+bool juno_canonicalize(const char *json_str, size_t len, JunoWriteFn fn, void *ud, JunoError *err) {
+    JWriter *w = (JWriter*)malloc(sizeof(JWriter));
+    if (!w) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_OOM;
+            err->msg = "oom (writer)";
+        }
+        return false;
+    }
+    juno_writer_init(w, fn, ud);
+
+    JCanon c;
+    memset(&c, 0, sizeof(c));
+    c.w = w;
+    c.base = json_str;
+
+    bool ok;
+    if (!json_str || !fn) {
+        ok = juno_w_fail(w, JUNO_ERR_INVALID_ARG, "null input", 0);
+    } else {
+        JLexer lx;
+        jl_init(&lx, json_str, len);
+        ok = _canon_text(&c, &lx, 0);
+        if (ok) {
+            JToken tok = jl_next(&lx);
+            if (tok.type != JTK_EOF) ok = _tok_fail(&c, &tok, "unexpected data after document", 0);
+        }
+        ok = ok && juno_w_flush(w);
+    }
+
+    if (err) *err = w->err;
+    free(c.m);
+    free(c.keys);
+    free(w);
+    return ok;
+}
@@ -0,0 +1,285 @@
+#include "internal/juno_internal.h"
+
+#include <juno/doc.h>
+#include <juno/builder.h>
+
+/* ------------------------------
+ * Frozen documents
+ * ------------------------------ */
+
+struct JunoDoc {
+    unsigned   refs;    /* atomic */
+    JunoArena *arena;   /* owns every node and string of the tree */
+    JsonNode  *root;
+};
+
+/* Chunk size for a document parsed from `len` bytes: small configs should not
+ * pin a full default chunk each. */
+static size_t _doc_chunk_size(size_t len) {
+    size_t chunk = len * 4;
+    if (chunk < 1024) chunk = 1024;
+    if (chunk > JUNO_ARENA_CHUNK_SIZE) chunk = JUNO_ARENA_CHUNK_SIZE;
+    return chunk;
+}
+
+static JunoDoc* _doc_new(size_t chunk_size, JunoError *err) {
+    JunoDoc *doc = (JunoDoc*)calloc(1, sizeof(JunoDoc));
+    if (doc) doc->arena = juno_arena_new(chunk_size);
+    if (!doc || !doc->arena) {
+        free(doc);
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_OOM;
+            err->msg = "oom (document)";
+        }
+        return NULL;
+    }
+    doc->refs = 1;
+    return doc;
+}
+
+static void _doc_destroy(JunoDoc *doc) {
+    juno_arena_free(doc->arena);
+    free(doc);
+}
+
+/* Keep the document if `root` was built, otherwise drop it. */
+static JunoDoc* _doc_finish(JunoDoc *doc, JsonNode *root) {
+    if (!root) {
+        _doc_destroy(doc);
+        return NULL;
+    }
+    doc->root = root;
+    return doc;
+}
+
+JunoDoc* juno_doc_parse(const char *json_str, size_t len, JunoError *err) {
+    JunoDoc *doc = _doc_new(_doc_chunk_size(len), err);
+    if (!doc) return NULL;
+
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.arena = doc->arena;
+    return _doc_finish(doc, juno_parse_opts(json_str, len, &opts, err));
+}
+
+JunoDoc* juno_doc_parse_file(const char *filename, JunoError *err) {
+    JunoDoc *doc = _doc_new(0, err);
+    if (!doc) return NULL;
+
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.arena = doc->arena;
+    return _doc_finish(doc, juno_parse_file_opts(filename, &opts, err));
+}
+
+JunoDoc* juno_doc_freeze(const JsonNode *root, JunoError *err) {
+    if (!root) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_INVALID_ARG;
+            err->msg = "null input";
+        }
+        return NULL;
+    }
+
+    JunoDoc *doc = _doc_new(0, err);
+    if (!doc) return NULL;
+
+    JsonNode *copy = juno_clone(doc->arena, root);
+    if (!copy) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_OOM;
+            err->msg = "oom (document)";
+        }
+    } else if (err) {
+        memset(err, 0, sizeof(*err));
+    }
+    return _doc_finish(doc, copy);
+}
+
+/* ------------------------------
+ * Compaction
+ * ------------------------------ */
+
+/* Layout of a compacted tree, in one block: every node in depth-first order,
+ * then the binary payloads (JBlob, 8-byte aligned), then the text strings. */
+typedef struct {
+    size_t    nodes, blob_bytes, text_bytes;   /* measured */
+    JsonNode *node;                            /* next free slot of each region */
+    char     *blob, *text;
+} JCompact;
+
+static inline bool _is_blob(const JsonNode *n) {
+    return n->type == JND_STRING && (n->flags & JND_FLAG_BINARY) && n->value.svalue;
+}
+
+static inline size_t _blob_size(const JsonNode *n) {
+    return sizeof(JBlob) + ((const JBlob*)n->value.svalue)->len;
+}
+
+/* Payload in value.svalue: strings, raw numbers, error messages and blobs. */
+static inline bool _has_text(const JsonNode *n) {
+    return n->value.svalue && (n->type == JND_STRING || n->type == JND_ERROR ||
+                               (n->type == JND_NUMBER && (n->flags & JND_FLAG_RAW_NUMBER)));
+}
+
+static void _compact_measure(JCompact *c, const JsonNode *n) {
+    c->nodes++;
+    if (n->key) c->text_bytes += strlen(n->key) + 1;
+    if (_is_blob(n)) c->blob_bytes += (_blob_size(n) + 7u) & ~(size_t)7u;
+    else if (_has_text(n)) c->text_bytes += strlen(n->value.svalue) + 1;
+    if (n->type == JND_OBJ || n->type == JND_ARRAY || n->type == JND_ROOT_OBJ)
+        for (const JsonNode *ch = n->first_child; ch; ch = ch->next_sibling) _compact_measure(c, ch);
+}
+
+static char* _compact_text(JCompact *c, const char *s) {
+    size_t len = strlen(s) + 1;
+    char *out = c->text;
+    memcpy(out, s, len);
+    c->text += len;
+    return out;
+}
+
+static JsonNode* _compact_copy(JCompact *c, const JsonNode *src) {
+    JsonNode *n = c->node++;
+    memset(n, 0, sizeof(*n));
+    n->type = src->type;
+    n->is_integer = src->is_integer;
+    n->flags = JND_FLAG_ARENA | (src->flags & (JND_FLAG_RAW_NUMBER | JND_FLAG_BINARY | JND_FLAG_BASE64URL));
+    if (src->key) n->key = _compact_text(c, src->key);
+
+    if (_is_blob(src)) {
+        size_t size = _blob_size(src);
+        memcpy(c->blob, src->value.svalue, size);
+        n->value.svalue = c->blob;
+        c->blob += (size + 7u) & ~(size_t)7u;
+    } else if (_has_text(src)) {
+        n->value.svalue = _compact_text(c, src->value.svalue);
+    } else if (src->type == JND_OBJ || src->type == JND_ARRAY || src->type == JND_ROOT_OBJ) {
+        JsonNode *tail = NULL;
+        for (const JsonNode *ch = src->first_child; ch; ch = ch->next_sibling) {
+            JsonNode *cc = _compact_copy(c, ch);
+            if (tail) tail->next_sibling = cc;
+            else n->first_child = cc;
+            tail = cc;
+        }
+        juno_set_last_child(n, tail);
+    } else if (src->type != JND_STRING && src->type != JND_ERROR) {
+        n->value = src->value;
+    }
+    return n;
+}
+
+JunoDoc* juno_compact(const JsonNode *root, JunoError *err) {
+    if (!root) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_INVALID_ARG;
+            err->msg = "null input";
+        }
+        return NULL;
+    }
+
+    JCompact c;
+    memset(&c, 0, sizeof(c));
+    _compact_measure(&c, root);
+    size_t total = c.nodes * sizeof(JsonNode) + c.blob_bytes + c.text_bytes;
+
+    /* A chunk of exactly the measured size: the single allocation fills it. */
+    JunoDoc *doc = _doc_new(total, err);
+    if (!doc) return NULL;
+    char *block = (char*)juno_arena_alloc(doc->arena, total);
+    if (!block) {
+        _doc_destroy(doc);
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_OOM;
+            err->msg = "oom (document)";
+        }
+        return NULL;
+    }
+    c.node = (JsonNode*)block;
+    c.blob = block + c.nodes * sizeof(JsonNode);
+    c.text = c.blob + c.blob_bytes;
+
+    doc->root = _compact_copy(&c, root);
+    if (err) memset(err, 0, sizeof(*err));
+    return doc;
+}
+
+const JsonNode* juno_doc_root(const JunoDoc *doc) {
+    return doc ? doc->root : NULL;
+}
+
+size_t juno_doc_footprint(const JunoDoc *doc) {
+    return doc ? sizeof(*doc) + juno_arena_footprint(doc->arena) : 0;
+}
+
+JunoDoc* juno_doc_retain(JunoDoc *doc) {
+    if (doc) __atomic_fetch_add(&doc->refs, 1u, __ATOMIC_RELAXED);
+    return doc;
+}
+
+void juno_doc_release(JunoDoc *doc) {
+    if (!doc) return;
+    /* acq_rel: every reader's accesses happen before the free below. */
+    if (__atomic_sub_fetch(&doc->refs, 1u, __ATOMIC_ACQ_REL) == 0) _doc_destroy(doc);
+}
+
+/* ------------------------------
+ * Publication slot
+ * ------------------------------ */
+
+/* Loading the pointer and taking a reference must be atomic with respect to
+ * a publish dropping the last reference, so both sides hold a spinlock for
+ * the few instructions involved. Reads of the document itself never lock. */
+struct JunoDocSlot {
+    bool     lock;   /* atomic test-and-set flag */
+    JunoDoc *doc;
+};
+
+static inline void _slot_lock(JunoDocSlot *slot) {
+    while (__atomic_test_and_set(&slot->lock, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&slot->lock, __ATOMIC_RELAXED)) {
+#if defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#endif
+        }
+    }
+}
+
+static inline void _slot_unlock(JunoDocSlot *slot) {
+    __atomic_clear(&slot->lock, __ATOMIC_RELEASE);
+}
+
+JunoDocSlot* juno_doc_slot_new(JunoDoc *doc) {
+    JunoDocSlot *slot = (JunoDocSlot*)calloc(1, sizeof(JunoDocSlot));
+    if (!slot) return NULL;
+    slot->doc = doc;
+    return slot;
+}
+
+JunoDoc* juno_doc_slot_acquire(JunoDocSlot *slot) {
+    if (!slot) return NULL;
+    _slot_lock(slot);
+    JunoDoc *doc = juno_doc_retain(slot->doc);
+    _slot_unlock(slot);
+    return doc;
+}
+
+void juno_doc_slot_publish(JunoDocSlot *slot, JunoDoc *doc) {
+    if (!slot) return;
+    _slot_lock(slot);
+    JunoDoc *old = slot->doc;
+    slot->doc = doc;
+    _slot_unlock(slot);
+    juno_doc_release(old);
+}
+
+void juno_doc_slot_free(JunoDocSlot *slot) {
+    if (!slot) return;
+    juno_doc_release(slot->doc);
+    free(slot);
+}
@@ -0,0 +1,166 @@
+#include "internal/juno_internal.h"
+
+#include <float.h>
+
+/* ------------------------------
+ * Shared helpers
+ * ------------------------------ */
+
+/* Parse state of the specialized parsers: a bare cursor, no line/column. */
+typedef struct {
+    const char *buf, *p, *end;
+    JunoArena  *arena;
+    JunoError   err;
+} JFast;
+
+static JsonNode* _f_fail(JFast *f, JunoErrorCode code, const char *msg, const char *at, unsigned depth) {
+    if (f->err.code != JUNO_OK) return NULL;
+    f->err.code = code;
+    f->err.msg = msg ? msg : juno_error_str(code);
+    f->err.offset = (size_t)(at - f->buf);
+    f->err.depth = depth;
+    return NULL;
+}
+
+/* Whatever sits at f->p does not fit the grammar. Cold path: run the full
+ * lexer over it so the code, message and offset match the default parser. */
+static JsonNode* _f_unexpected(JFast *f, const char *msg, unsigned depth) {
+    JLexer lx;
+    jl_init(&lx, f->buf, (size_t)(f->end - f->buf));
+    lx.p = f->p;
+    JToken tok = jl_next(&lx);
+    return _f_fail(f, juno_lex_error_code(&tok), tok.type == JTK_ERROR ? tok.err_msg : msg, tok.start, depth);
+}
+
+static inline bool _f_digit(char c) {
+    return (unsigned)(unsigned char)c - '0' < 10;
+}
+
+static inline void _f_ws(JFast *f) {
+    const char *p = f->p;
+    while (p < f->end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) p++;
+    f->p = p;
+}
+
+static inline JsonNode* _f_node(JFast *f, JNodeType type) {
+    if (!f->arena) return juno_create_node(type);
+    JsonNode *n = (JsonNode*)juno_arena_alloc(f->arena, sizeof(JsonNode));
+    if (!n) return NULL;
+    memset(n, 0, sizeof(*n));
+    n->type = type;
+    n->flags = JND_FLAG_ARENA;
+    return n;
+}
+
+static inline char* _f_alloc(JFast *f, size_t n) {
+    return f->arena ? (char*)juno_arena_alloc(f->arena, n) : (char*)malloc(n);
+}
+
+/* Arena parses are rewound as a whole by juno_parse_fast. */
+static inline void _f_release(JFast *f, JsonNode *n) {
+    if (!f->arena) juno_free_ast(n);
+}
+
+static JsonNode* _f_literal(JFast *f, const char *lit, size_t n, JNodeType type, bool value, unsigned depth) {
+    if ((size_t)(f->end - f->p) < n || memcmp(f->p, lit, n) != 0) return _f_unexpected(f, NULL, depth);
+    JsonNode *node = _f_node(f, type);
+    if (!node) return _f_fail(f, JUNO_ERR_OOM, type == JND_NULL ? "oom (null)" : "oom (bool)", f->p, depth);
+    node->value.bvalue = value;
+    f->p += n;
+    return node;
+}
+
+#define JF_ONES  0x0101010101010101ull
+#define JF_HIGHS 0x8080808080808080ull
+/* Non-zero when some byte of `x` is below `n` (n <= 128). */
+#define JF_LESS(x, n) (((x) - JF_ONES * (n)) & ~(x) & JF_HIGHS)
+
+/* Closing quote of the string body starting at `p`, or NULL when it is
+ * unterminated or (when validating) holds a raw control character. Eight
+ * bytes at a time while none of them needs a look. */
+static inline const char* _f_scan_string(const char *p, const char *end, bool validate, bool *escaped) {
+    for (;;) {
+        while (end - p >= 8) {
+            uint64_t x;
+            memcpy(&x, p, 8);
+            uint64_t hit = JF_LESS(x ^ (JF_ONES * '"'), 1) | JF_LESS(x ^ (JF_ONES * '\\'), 1);
+            if (validate) hit |= JF_LESS(x, 0x20);
+            if (hit) break;
+            p += 8;
+        }
+        if (p >= end) return NULL;
+        unsigned char c = (unsigned char)*p;
+        if (c == '"') return p;
+        if (c == '\\') {
+            *escaped = true;
+            if (end - p < 2) return NULL;
+            p += 2;
+            continue;
+        }
+        if (validate && c < 0x20) return NULL;
+        p++;
+    }
+}
+
+/* mant * 10^exp10 when a single correctly rounded operation gives it (both
+ * operands exact: Clinger's fast path), false otherwise. */
+static inline bool _f_exact_double(uint64_t mant, int exp10, bool neg, double *out) {
+#if FLT_EVAL_METHOD == 0
+    static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    if (mant > (1ull << 53) || exp10 < -22 || exp10 > 22) return false;
+    double d = (double)mant;
+    d = exp10 < 0 ? d / pow10[-exp10] : d * pow10[exp10];
+    *out = neg ? -d : d;
+    return true;
+#else
+    (void)mant; (void)exp10; (void)neg; (void)out;
+    return false;
+#endif
+}
+
+/* ------------------------------
+ * Variants
+ * ------------------------------ */
+
+#define JPC(name)    _strict_##name
+#define JPC_VALIDATE 1
+#define JPC_INTEGERS 1
+#include "internal/juno_parse_core.h"
+
+#define JPC(name)    _trusted_##name
+#define JPC_VALIDATE 0
+#define JPC_INTEGERS 1
+#include "internal/juno_parse_core.h"
+
+#define JPC(name)    _doubles_##name
+#define JPC_VALIDATE 1
+#define JPC_INTEGERS 0
+#include "internal/juno_parse_core.h"
+
+/* ------------------------------
+ * Entry point
+ * ------------------------------ */
+
+JsonNode* juno_parse_fast(const char *json_str, size_t len, JunoParseMode mode, JunoArena *arena, JunoError *err) {
+    JFast f;
+    f.buf = f.p = json_str;
+    f.end = json_str + len;
+    f.arena = arena;
+    memset(&f.err, 0, sizeof(f.err));
+
+    JArenaMark mark = { NULL, 0 };
+    if (arena) mark = juno_arena_mark(arena);
+
+    JsonNode *root;
+    switch (mode) {
+        case JUNO_PARSE_MODE_TRUSTED: root = _trusted_value(&f, 0); break;
+        case JUNO_PARSE_MODE_DOUBLES: root = _doubles_value(&f, 0); break;
+        default:                      root = _strict_value(&f, 0); break;
+    }
+    if (!root && arena) juno_arena_rewind(arena, mark);
+    if (err) *err = f.err;
+    return root;
+}
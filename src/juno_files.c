@@ -0,0 +1,436 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE     /* syscall() */
+
+#include "internal/juno_internal.h"
+
+#include <juno/files.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef JUNO_ENABLE_URING
+#define JUNO_ENABLE_URING 1
+#endif
+
+#if JUNO_ENABLE_URING && defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define JF_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+#ifndef JF_URING
+#define JF_URING 0
+#endif
+
+/* ------------------------------
+ * Shared job
+ * ------------------------------ */
+
+typedef struct {
+    const char *const *paths;
+    size_t             n;
+    size_t             next;      /* atomic: next path to claim */
+    size_t             ok;        /* atomic: files parsed */
+    size_t             max_len;   /* limits->max_input, SIZE_MAX if unset */
+    JunoFilesBackend   backend;
+    unsigned           depth;     /* io_uring reads in flight per loader */
+    JunoParseOptions   opts;
+    JsonNode         **roots;
+    JunoError         *errs;
+} JFilesJob;
+
+/* Text buffer of a worker or ring slot, reused for every file it reads. */
+typedef struct {
+    char  *data;
+    size_t cap;
+} JFileBuf;
+
+static bool _files_fail(JunoError *err, JunoErrorCode code, const char *msg) {
+    memset(err, 0, sizeof(*err));
+    err->code = code;
+    err->msg = msg;
+    return false;
+}
+
+static bool _fbuf_reserve(JFileBuf *b, size_t need) {
+    if (need <= b->cap) return true;
+    size_t cap = b->cap ? b->cap : 4096;
+    while (cap < need) cap *= 2;
+    char *p = (char*)realloc(b->data, cap);
+    if (!p) return false;
+    b->data = p;
+    b->cap = cap;
+    return true;
+}
+
+/* ------------------------------
+ * Reading
+ * ------------------------------ */
+
+/* Open `path`; *size receives the size of a regular file, SIZE_MAX for
+ * anything else (pipes, devices), whose length is only known at EOF. */
+static int _files_open(const char *path, size_t max_len, size_t *size, JunoError *err) {
+    if (!path) {
+        _files_fail(err, JUNO_ERR_INVALID_ARG, "null filename");
+        return -1;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        _files_fail(err, JUNO_ERR_IO, "failed to open file");
+        return -1;
+    }
+
+    struct stat st;
+    *size = SIZE_MAX;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        if ((uint64_t)st.st_size > max_len) {
+            close(fd);
+            _files_fail(err, JUNO_ERR_INPUT_TOO_LARGE, "file exceeds the input limit");
+            return -1;
+        }
+        *size = (size_t)st.st_size;
+    }
+    return fd;
+}
+
+/* Whole file into b->data (NUL-terminated). Regular files are sized up front
+ * so the text arrives in one read; anything else is read until EOF. */
+static bool _files_read_fd(int fd, size_t size, size_t max_len, JFileBuf *b, size_t *len, JunoError *err) {
+    /* +2: the terminator, and room for the read that sees EOF. */
+    if (!_fbuf_reserve(b, (size == SIZE_MAX ? 0 : size) + 2))
+        return _files_fail(err, JUNO_ERR_OOM, "oom (file buffer)");
+
+    size_t n = 0;
+    for (;;) {
+        if (n + 1 == b->cap && !_fbuf_reserve(b, b->cap + 1))
+            return _files_fail(err, JUNO_ERR_OOM, "oom (file buffer)");
+        ssize_t r = read(fd, b->data + n, b->cap - 1 - n);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return _files_fail(err, JUNO_ERR_IO, "failed to read file");
+        }
+        if (r == 0) break;
+        n += (size_t)r;
+        if (n > max_len) return _files_fail(err, JUNO_ERR_INPUT_TOO_LARGE, "file exceeds the input limit");
+    }
+    b->data[n] = '\0';
+    *len = n;
+    return true;
+}
+
+/* Parse the text of file `i` (or keep the read error) and publish the result. */
+static void _files_store(JFilesJob *job, size_t i, bool read_ok, const JFileBuf *b, size_t len, JunoError *err) {
+    JsonNode *root = read_ok ? juno_parse_opts(b->data, len, &job->opts, err) : NULL;
+    job->roots[i] = root;
+    if (job->errs) job->errs[i] = *err;
+    if (root) __atomic_fetch_add(&job->ok, 1, __ATOMIC_RELAXED);
+}
+
+/* Blocking read of file `i` into `b`, then parse. */
+static void _files_load(JFilesJob *job, size_t i, JFileBuf *b) {
+    JunoError err;
+    size_t size = 0, len = 0;
+    int fd = _files_open(job->paths[i], job->max_len, &size, &err);
+    bool ok = fd >= 0 && _files_read_fd(fd, size, job->max_len, b, &len, &err);
+    if (fd >= 0) close(fd);
+    _files_store(job, i, ok, b, len, &err);
+}
+
+/* ------------------------------
+ * io_uring reads
+ * ------------------------------ */
+
+#if JF_URING
+
+/* Submission and completion rings of one loader, mapped from the kernel
+ * (raw io_uring_setup / io_uring_enter, no liburing). */
+typedef struct {
+    int                  fd;
+    unsigned            *sq_tail, *sq_mask, *sq_array;
+    unsigned            *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void                *sq_map, *cq_map;
+    size_t               sq_len, cq_len, sqe_len;
+    unsigned             queued;    /* SQEs not yet handed to the kernel */
+} JRing;
+
+/* One file being read through the ring; fd < 0 while the slot is free. */
+typedef struct {
+    size_t   i;         /* path index */
+    int      fd;
+    size_t   size;      /* fstat size */
+    size_t   len;       /* bytes read so far */
+    uint32_t req;       /* length of the read in flight */
+    JFileBuf buf;
+} JRingSlot;
+
+static void _ring_free(JRing *r) {
+    if (r->sqes != MAP_FAILED) munmap(r->sqes, r->sqe_len);
+    if (r->cq_map != MAP_FAILED) munmap(r->cq_map, r->cq_len);
+    if (r->sq_map != MAP_FAILED) munmap(r->sq_map, r->sq_len);
+    close(r->fd);
+}
+
+/* False when the kernel has no io_uring or refuses it (seccomp, limits). */
+static bool _ring_init(JRing *r, unsigned entries) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    memset(r, 0, sizeof(*r));
+    r->sq_map = r->cq_map = MAP_FAILED;
+    r->sqes = (struct io_uring_sqe*)MAP_FAILED;
+
+    r->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+    if (r->fd < 0) return false;
+
+    r->sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    r->sqe_len = p.sq_entries * sizeof(struct io_uring_sqe);
+    r->sq_map = mmap(NULL, r->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED, r->fd, IORING_OFF_SQ_RING);
+    r->cq_map = mmap(NULL, r->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED, r->fd, IORING_OFF_CQ_RING);
+    r->sqes = (struct io_uring_sqe*)mmap(NULL, r->sqe_len, PROT_READ | PROT_WRITE, MAP_SHARED, r->fd,
+                                         IORING_OFF_SQES);
+    if (r->sq_map == MAP_FAILED || r->cq_map == MAP_FAILED || r->sqes == MAP_FAILED) {
+        _ring_free(r);
+        return false;
+    }
+
+    char *sq = (char*)r->sq_map, *cq = (char*)r->cq_map;
+    r->sq_tail = (unsigned*)(sq + p.sq_off.tail);
+    r->sq_mask = (unsigned*)(sq + p.sq_off.ring_mask);
+    r->sq_array = (unsigned*)(sq + p.sq_off.array);
+    r->cq_head = (unsigned*)(cq + p.cq_off.head);
+    r->cq_tail = (unsigned*)(cq + p.cq_off.tail);
+    r->cq_mask = (unsigned*)(cq + p.cq_off.ring_mask);
+    r->cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+    return true;
+}
+
+/* Queue a read of the rest of the slot's buffer at offset s->len. Every slot
+ * has at most one read in flight, so the ring never fills. */
+static void _ring_read(JRing *r, JRingSlot *s) {
+    size_t room = s->buf.cap - 1 - s->len;
+    s->req = room > (1u << 30) ? (1u << 30) : (uint32_t)room;
+
+    unsigned tail = *r->sq_tail;
+    unsigned idx = tail & *r->sq_mask;
+    struct io_uring_sqe *sqe = &r->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = s->fd;
+    sqe->off = s->len;
+    sqe->addr = (uint64_t)(uintptr_t)(s->buf.data + s->len);
+    sqe->len = s->req;
+    sqe->user_data = (uint64_t)(uintptr_t)s;
+    r->sq_array[idx] = idx;
+    __atomic_store_n(r->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    r->queued++;
+}
+
+/* Submit what is queued and wait for at least one completion. */
+static bool _ring_enter(JRing *r) {
+    for (;;) {
+        long n = syscall(__NR_io_uring_enter, r->fd, r->queued, 1u, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (n >= 0) {
+            r->queued -= (unsigned)n;
+            return true;
+        }
+        if (errno != EINTR) return false;
+    }
+}
+
+/* Claim file `i` for slot `s`: open it and queue the first read. Files that
+ * cannot be opened, and files that are not regular, are finished here with
+ * blocking calls; returns true only when a read was queued. */
+static bool _ring_start(JFilesJob *job, JRing *r, JRingSlot *s, size_t i) {
+    JunoError err;
+    size_t size = 0;
+    int fd = _files_open(job->paths[i], job->max_len, &size, &err);
+    if (fd >= 0 && size == SIZE_MAX) {
+        size_t len = 0;
+        bool ok = _files_read_fd(fd, size, job->max_len, &s->buf, &len, &err);
+        close(fd);
+        _files_store(job, i, ok, &s->buf, len, &err);
+        return false;
+    }
+    if (fd >= 0 && !_fbuf_reserve(&s->buf, size + 2)) {
+        close(fd);
+        fd = -1;
+        _files_fail(&err, JUNO_ERR_OOM, "oom (file buffer)");
+    }
+    if (fd < 0) {
+        _files_store(job, i, false, &s->buf, 0, &err);
+        return false;
+    }
+
+    s->i = i;
+    s->fd = fd;
+    s->size = size;
+    s->len = 0;
+    _ring_read(r, s);
+    return true;
+}
+
+/* Finish slot `s`: parse the text (or keep the error) and free the slot. */
+static void _ring_finish(JFilesJob *job, JRingSlot *s, bool ok, JunoError *err) {
+    close(s->fd);
+    s->fd = -1;
+    if (ok) s->buf.data[s->len] = '\0';
+    _files_store(job, s->i, ok, &s->buf, s->len, err);
+}
+
+/* Handle the completion of a read on `s`: queue the next read, or finish the
+ * file. A file is complete at EOF, or when a short read stops exactly at
+ * the size fstat reported. */
+static void _ring_complete(JFilesJob *job, JRing *r, JRingSlot *s, int res, unsigned *busy) {
+    JunoError err;
+    if (res == -EINTR || res == -EAGAIN) {
+        _ring_read(r, s);
+        return;
+    }
+    if (res < 0) {
+        _files_fail(&err, JUNO_ERR_IO, "failed to read file");
+        goto finish;
+    }
+    s->len += (size_t)res;
+    if (s->len > job->max_len) {
+        _files_fail(&err, JUNO_ERR_INPUT_TOO_LARGE, "file exceeds the input limit");
+        goto finish;
+    }
+    if (res > 0 && ((uint32_t)res == s->req || s->len != s->size)) {
+        if (s->len + 1 == s->buf.cap && !_fbuf_reserve(&s->buf, s->buf.cap + 1)) {
+            _files_fail(&err, JUNO_ERR_OOM, "oom (file buffer)");
+            goto finish;
+        }
+        _ring_read(r, s);
+        return;
+    }
+    memset(&err, 0, sizeof(err));
+    _ring_finish(job, s, true, &err);
+    (*busy)--;
+    return;
+
+finish:
+    _ring_finish(job, s, false, &err);
+    (*busy)--;
+}
+
+/* Loader with its own ring: keeps up to job->depth reads in flight and
+ * parses each file as its read completes, while the others proceed in the
+ * kernel. Returns false, having claimed nothing, when no ring is available. */
+static bool _files_uring_worker(JFilesJob *job) {
+    JRing ring;
+    if (!_ring_init(&ring, job->depth)) return false;
+    JRingSlot *slots = (JRingSlot*)calloc(job->depth, sizeof(JRingSlot));
+    if (!slots) {
+        _ring_free(&ring);
+        return false;
+    }
+    for (unsigned k = 0; k < job->depth; k++) slots[k].fd = -1;
+
+    unsigned busy = 0;
+    bool more = true;
+    for (;;) {
+        for (unsigned k = 0; more && k < job->depth; k++) {
+            while (slots[k].fd < 0) {
+                size_t i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+                if (i >= job->n) {
+                    more = false;
+                    break;
+                }
+                if (_ring_start(job, &ring, &slots[k], i)) busy++;
+            }
+        }
+        if (busy == 0) break;
+
+        if (!_ring_enter(&ring)) {
+            /* The ring stopped working: fail what is in flight. */
+            JunoError err;
+            _files_fail(&err, JUNO_ERR_IO, "failed to read file");
+            for (unsigned k = 0; k < job->depth; k++) {
+                if (slots[k].fd >= 0) _ring_finish(job, &slots[k], false, &err);
+            }
+            break;
+        }
+
+        unsigned head = *ring.cq_head;
+        while (head != __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE)) {
+            struct io_uring_cqe *cqe = &ring.cqes[head & *ring.cq_mask];
+            JRingSlot *s = (JRingSlot*)(uintptr_t)cqe->user_data;
+            int res = cqe->res;
+            __atomic_store_n(ring.cq_head, ++head, __ATOMIC_RELEASE);
+            _ring_complete(job, &ring, s, res, &busy);
+        }
+    }
+
+    for (unsigned k = 0; k < job->depth; k++) free(slots[k].buf.data);
+    free(slots);
+    _ring_free(&ring);
+    return true;
+}
+
+#endif /* JF_URING */
+
+/* ------------------------------
+ * Workers
+ * ------------------------------ */
+
+static void* _files_worker(void *arg) {
+    JFilesJob *job = (JFilesJob*)arg;
+#if JF_URING
+    if (job->backend == JUNO_FILES_AUTO && _files_uring_worker(job)) return NULL;
+#endif
+    JFileBuf buf = { NULL, 0 };
+    for (;;) {
+        size_t i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+        if (i >= job->n) break;
+        _files_load(job, i, &buf);
+    }
+    free(buf.data);
+    return NULL;
+}
+
+static unsigned _files_default_threads(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (unsigned)cpus : 1u;
+}
+
+size_t juno_parse_files(const char *const *paths, size_t n, const JunoFilesOptions *opts,
+                        JsonNode **roots, JunoError *errs) {
+    if (n == 0 || !paths || !roots) return 0;
+
+    JFilesJob job;
+    memset(&job, 0, sizeof(job));
+    job.paths = paths;
+    job.n = n;
+    job.roots = roots;
+    job.errs = errs;
+    if (opts && opts->parse) job.opts = *opts->parse;
+    /* Workers allocate concurrently: each tree goes on the heap. */
+    job.opts.arena = NULL;
+    job.opts.stats = NULL;
+    job.max_len = (job.opts.limits && job.opts.limits->max_input) ? job.opts.limits->max_input : SIZE_MAX;
+    job.backend = opts ? opts->backend : JUNO_FILES_AUTO;
+    job.depth = (opts && opts->queue_depth) ? opts->queue_depth : JUNO_FILES_QUEUE_DEPTH;
+    if (job.depth > JUNO_FILES_MAX_QUEUE_DEPTH) job.depth = JUNO_FILES_MAX_QUEUE_DEPTH;
+
+    unsigned threads = (opts && opts->threads) ? opts->threads : _files_default_threads();
+    if (threads > JUNO_FILES_MAX_THREADS) threads = JUNO_FILES_MAX_THREADS;
+    if (threads > n) threads = (unsigned)n;
+
+    /* The calling thread is one of the workers; if threads cannot be
+     * started it simply does more of the work itself. */
+    pthread_t tids[JUNO_FILES_MAX_THREADS];
+    unsigned started = 0;
+    while (started + 1 < threads && pthread_create(&tids[started], NULL, _files_worker, &job) == 0)
+        started++;
+    _files_worker(&job);
+    for (unsigned t = 0; t < started; t++) pthread_join(tids[t], NULL);
+
+    return job.ok;
+}
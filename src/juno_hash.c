@@ -0,0 +1,522 @@
+#include "internal/juno_internal.h"
+
+#include <juno/base64.h>
+#include <juno/hash.h>
+#include <juno/reader.h>
+
+/* ------------------------------
+ * Byte hash
+ * ------------------------------ */
+
+#define JH_P1 0x9E3779B185EBCA87ull
+#define JH_P2 0xC2B2AE3D27D4EB4Full
+#define JH_P3 0x165667B19E3779F9ull
+
+/* Seeds keeping values of different types apart. */
+enum {
+    JH_NULL = 1, JH_BOOL, JH_INT, JH_DOUBLE, JH_NUMTEXT, JH_STRING, JH_ERROR,
+    JH_ARRAY, JH_OBJECT, JH_KEY, JH_BINARY
+};
+
+static inline uint64_t _jh_rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+static inline uint64_t _fmix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t juno_hash_bytes(const void *data, size_t len, uint64_t seed) {
+    const unsigned char *p = (const unsigned char*)data;
+    uint64_t h = seed ^ ((uint64_t)len * JH_P1);
+
+    for (; len >= 8; p += 8, len -= 8) {
+        uint64_t k;
+        memcpy(&k, p, 8);
+        h ^= _jh_rotl(k * JH_P2, 31) * JH_P1;
+        h = _jh_rotl(h, 27) * JH_P1 + JH_P3;
+    }
+    if (len) {
+        uint64_t k = 0;
+        memcpy(&k, p, len);
+        h ^= _jh_rotl(k * JH_P2, 31) * JH_P1;
+    }
+    return _fmix(h);
+}
+
+/* Container accumulators, shared by the tree walk and the event stream.
+ * Arrays combine in order; object members are summed so order is irrelevant. */
+static inline uint64_t _arr_add(uint64_t acc, uint64_t h) { return _jh_rotl(acc + h * JH_P2, 31) * JH_P1; }
+static inline uint64_t _arr_end(uint64_t acc, uint64_t n) { return _fmix(acc ^ JH_ARRAY ^ (n * JH_P3)); }
+static inline uint64_t _obj_add(uint64_t acc, uint64_t kh, uint64_t vh) { return acc + _fmix(kh + vh * JH_P2); }
+static inline uint64_t _obj_end(uint64_t acc, uint64_t n) { return _fmix(acc ^ JH_OBJECT ^ (n * JH_P3)); }
+
+/* ------------------------------
+ * Numbers by value
+ * ------------------------------ */
+
+typedef enum {
+    JNUM_INT,      /* fits int64 (integral doubles included) */
+    JNUM_DOUBLE,   /* anything else a double holds, integers beyond int64 too */
+    JNUM_TEXT      /* text whose value overflows a double */
+} JNumKind;
+
+typedef struct {
+    JNumKind    kind;
+    int64_t     i;
+    double      d;
+    const char *text;
+    size_t      len;
+} JNum;
+
+static JNum _num_from_double(double d) {
+    JNum n;
+    memset(&n, 0, sizeof(n));
+    if (d >= -9223372036854775808.0 && d < 9223372036854775808.0 && (double)(int64_t)d == d) {
+        n.kind = JNUM_INT;
+        n.i = (int64_t)d;
+    } else {
+        n.kind = JNUM_DOUBLE;
+        n.d = d;
+    }
+    return n;
+}
+
+static JNum _num_from_text(const char *text, size_t len) {
+    JToken t;
+    memset(&t, 0, sizeof(t));
+    t.type = JTK_NUMBER;
+    t.start = text;
+    t.length = len;
+
+    JNum n;
+    memset(&n, 0, sizeof(n));
+    if (jl_number_to_int64(&t, &n.i)) {
+        n.kind = JNUM_INT;
+        return n;
+    }
+
+    /* Beyond int64 the eager parser keeps a double: compare the same value. */
+    double d = 0.0;
+    if (jl_number_to_double(&t, &d)) return _num_from_double(d);
+    n.kind = JNUM_TEXT;
+    n.text = text;
+    n.len = len;
+    return n;
+}
+
+static JNum _num_from_node(const JsonNode *node) {
+    if (node->flags & JND_FLAG_RAW_NUMBER)
+        return _num_from_text(node->value.svalue, strlen(node->value.svalue));
+    if (!node->is_integer) return _num_from_double(node->value.nvalue);
+
+    JNum n;
+    memset(&n, 0, sizeof(n));
+    n.kind = JNUM_INT;
+    n.i = node->value.ivalue;
+    return n;
+}
+
+static uint64_t _num_hash(const JNum *n) {
+    switch (n->kind) {
+        case JNUM_INT:  return juno_hash_bytes(&n->i, sizeof(n->i), JH_INT);
+        case JNUM_TEXT: return juno_hash_bytes(n->text, n->len, JH_NUMTEXT);
+        default:        return juno_hash_bytes(&n->d, sizeof(n->d), JH_DOUBLE);
+    }
+}
+
+static bool _num_equal(const JNum *a, const JNum *b) {
+    if (a->kind == JNUM_INT || b->kind == JNUM_INT) return a->kind == b->kind && a->i == b->i;
+    if (a->kind == JNUM_TEXT || b->kind == JNUM_TEXT)
+        return a->kind == b->kind && a->len == b->len && memcmp(a->text, b->text, a->len) == 0;
+    return a->d == b->d;
+}
+
+/* ------------------------------
+ * Values: a JsonNode or a node of a binary image
+ * ------------------------------ */
+
+typedef struct {
+    const JsonNode   *node;
+    const JunoBinDoc *doc;
+    JunoBinRef        ref;
+} JVal;
+
+static inline JVal _v_node(const JsonNode *node) {
+    JVal v = { node, NULL, JUNO_BIN_NONE };
+    return v;
+}
+
+static inline JVal _v_bin(const JunoBinDoc *doc, JunoBinRef ref) {
+    JVal v = { NULL, doc, ref };
+    return v;
+}
+
+static inline bool _v_ok(JVal v) {
+    return v.node || (v.doc && v.ref != JUNO_BIN_NONE);
+}
+
+static JNodeType _v_type(JVal v) {
+    JNodeType t = v.node ? v.node->type : juno_bin_type(v.doc, v.ref);
+    return t == JND_ROOT_OBJ ? JND_OBJ : t;
+}
+
+static JVal _v_first(JVal v) {
+    return v.node ? _v_node(v.node->first_child) : _v_bin(v.doc, juno_bin_first_child(v.doc, v.ref));
+}
+
+static JVal _v_next(JVal v) {
+    return v.node ? _v_node(v.node->next_sibling) : _v_bin(v.doc, juno_bin_next_sibling(v.doc, v.ref));
+}
+
+static size_t _v_count(JVal v) {
+    if (!v.node) return juno_bin_child_count(v.doc, v.ref);
+    size_t n = 0;
+    for (const JsonNode *c = v.node->first_child; c; c = c->next_sibling) n++;
+    return n;
+}
+
+static const char* _v_key(JVal v, size_t *len) {
+    const char *k = v.node ? v.node->key : juno_bin_key(v.doc, v.ref, len);
+    if (!k) {
+        *len = 0;
+        return "";
+    }
+    if (v.node) *len = strlen(k);
+    return k;
+}
+
+/* Binary nodes (JND_FLAG_BINARY) hash and compare by their bytes. */
+static bool _v_binary(JVal v) {
+    return v.node && (v.node->flags & JND_FLAG_BINARY);
+}
+
+static const char* _v_str(JVal v, size_t *len) {
+    if (_v_binary(v)) return (const char*)juno_binary(v.node, len);
+    const char *s = v.node ? v.node->value.svalue : juno_bin_string(v.doc, v.ref, len);
+    if (!s) {
+        *len = 0;
+        return "";
+    }
+    if (v.node) *len = strlen(s);
+    return s;
+}
+
+static bool _v_bool(JVal v) {
+    return v.node ? v.node->value.bvalue : juno_bin_bool(v.doc, v.ref);
+}
+
+static JNum _v_num(JVal v) {
+    if (v.node) return _num_from_node(v.node);
+    if (!juno_bin_is_integer(v.doc, v.ref)) return _num_from_double(juno_bin_double(v.doc, v.ref));
+
+    JNum n;
+    memset(&n, 0, sizeof(n));
+    n.kind = JNUM_INT;
+    n.i = juno_bin_int(v.doc, v.ref);
+    return n;
+}
+
+/* ------------------------------
+ * Hashing
+ * ------------------------------ */
+
+static uint64_t _hash_key(JVal v) {
+    size_t len = 0;
+    const char *k = _v_key(v, &len);
+    return juno_hash_bytes(k, len, JH_KEY);
+}
+
+static uint64_t _hash_val(JVal v) {
+    size_t len = 0;
+    switch (_v_type(v)) {
+        case JND_NULL:
+            return juno_hash_bytes(NULL, 0, JH_NULL);
+        case JND_BOOL: {
+            unsigned char b = _v_bool(v) ? 1 : 0;
+            return juno_hash_bytes(&b, 1, JH_BOOL);
+        }
+        case JND_NUMBER: {
+            JNum n = _v_num(v);
+            return _num_hash(&n);
+        }
+        case JND_STRING: {
+            const char *s = _v_str(v, &len);
+            return juno_hash_bytes(s, len, _v_binary(v) ? JH_BINARY : JH_STRING);
+        }
+        case JND_ARRAY: {
+            uint64_t acc = 0, n = 0;
+            for (JVal c = _v_first(v); _v_ok(c); c = _v_next(c), n++) acc = _arr_add(acc, _hash_val(c));
+            return _arr_end(acc, n);
+        }
+        case JND_OBJ: {
+            uint64_t acc = 0, n = 0;
+            for (JVal c = _v_first(v); _v_ok(c); c = _v_next(c), n++) acc = _obj_add(acc, _hash_key(c), _hash_val(c));
+            return _obj_end(acc, n);
+        }
+        default: {
+            const char *msg = v.node && v.node->value.err_msg ? v.node->value.err_msg : "";
+            return juno_hash_bytes(msg, strlen(msg), JH_ERROR);
+        }
+    }
+}
+
+uint64_t juno_hash(const JsonNode *root) {
+    return root ? _hash_val(_v_node(root)) : 0;
+}
+
+uint64_t juno_bin_hash(const JunoBinDoc *doc, JunoBinRef ref) {
+    return (doc && ref != JUNO_BIN_NONE) ? _hash_val(_v_bin(doc, ref)) : 0;
+}
+
+/* ------------------------------
+ * Equality
+ * ------------------------------ */
+
+static bool _equal(JVal a, JVal b);
+
+static bool _key_equal(JVal a, JVal b) {
+    size_t la = 0, lb = 0;
+    const char *ka = _v_key(a, &la), *kb = _v_key(b, &lb);
+    return la == lb && memcmp(ka, kb, la) == 0;
+}
+
+/* Objects up to this size are matched pairwise; larger ones are sorted. */
+#define JH_SMALL_OBJECT 32
+
+typedef struct {
+    JVal        val;
+    const char *key;
+    size_t      key_len;
+    uint64_t    hash;
+} JMember;
+
+static int _member_cmp(const void *pa, const void *pb) {
+    const JMember *a = (const JMember*)pa, *b = (const JMember*)pb;
+    size_t n = a->key_len < b->key_len ? a->key_len : b->key_len;
+    int c = memcmp(a->key, b->key, n);
+    if (c) return c;
+    if (a->key_len != b->key_len) return a->key_len < b->key_len ? -1 : 1;
+    if (a->hash != b->hash) return a->hash < b->hash ? -1 : 1;
+    return 0;
+}
+
+static JMember* _members_sorted(JVal obj, size_t n) {
+    JMember *m = (JMember*)malloc(n * sizeof(JMember));
+    if (!m) return NULL;
+    size_t i = 0;
+    for (JVal c = _v_first(obj); _v_ok(c) && i < n; c = _v_next(c), i++) {
+        m[i].val = c;
+        m[i].key = _v_key(c, &m[i].key_len);
+        m[i].hash = _hash_val(c);
+    }
+    qsort(m, n, sizeof(JMember), _member_cmp);
+    return m;
+}
+
+/* Occurrences of member `m` (key and value) among the members of `obj`. */
+static size_t _member_count(JVal obj, JVal m) {
+    size_t k = 0;
+    for (JVal c = _v_first(obj); _v_ok(c); c = _v_next(c)) {
+        if (_key_equal(c, m) && _equal(c, m)) k++;
+    }
+    return k;
+}
+
+/* Members compared as multisets: duplicate keys must pair up one to one. */
+static bool _equal_obj(JVal a, JVal b) {
+    size_t n = _v_count(a);
+    if (n != _v_count(b)) return false;
+
+    if (n > JH_SMALL_OBJECT) {
+        JMember *ma = _members_sorted(a, n);
+        JMember *mb = ma ? _members_sorted(b, n) : NULL;
+        if (mb) {
+            bool eq = true;
+            for (size_t i = 0; i < n && eq; i++) {
+                eq = ma[i].hash == mb[i].hash && _key_equal(ma[i].val, mb[i].val) &&
+                     _equal(ma[i].val, mb[i].val);
+            }
+            free(ma);
+            free(mb);
+            return eq;
+        }
+        free(ma);
+        /* Out of memory: same answer without allocating, in O(n^2). Every
+         * member must occur as often in `b` as in `a`. */
+        for (JVal ca = _v_first(a); _v_ok(ca); ca = _v_next(ca)) {
+            if (_member_count(a, ca) != _member_count(b, ca)) return false;
+        }
+        return true;
+    }
+
+    bool used[JH_SMALL_OBJECT] = { false };
+    for (JVal ca = _v_first(a); _v_ok(ca); ca = _v_next(ca)) {
+        size_t j = 0;
+        bool found = false;
+        for (JVal cb = _v_first(b); _v_ok(cb) && !found; cb = _v_next(cb), j++) {
+            if (used[j]) continue;
+            if (_key_equal(ca, cb) && _equal(ca, cb)) {
+                used[j] = true;
+                found = true;
+            }
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+static bool _equal(JVal a, JVal b) {
+    JNodeType t = _v_type(a);
+    if (t != _v_type(b)) return false;
+
+    size_t la = 0, lb = 0;
+    switch (t) {
+        case JND_NULL:
+            return true;
+        case JND_BOOL:
+            return _v_bool(a) == _v_bool(b);
+        case JND_NUMBER: {
+            JNum na = _v_num(a), nb = _v_num(b);
+            return _num_equal(&na, &nb);
+        }
+        case JND_STRING: {
+            const char *sa = _v_str(a, &la), *sb = _v_str(b, &lb);
+            return _v_binary(a) == _v_binary(b) && la == lb && memcmp(sa, sb, la) == 0;
+        }
+        case JND_ARRAY: {
+            JVal ca = _v_first(a), cb = _v_first(b);
+            for (; _v_ok(ca) && _v_ok(cb); ca = _v_next(ca), cb = _v_next(cb)) {
+                if (!_equal(ca, cb)) return false;
+            }
+            return !_v_ok(ca) && !_v_ok(cb);
+        }
+        case JND_OBJ:
+            return _equal_obj(a, b);
+        default:
+            return a.node == b.node;
+    }
+}
+
+bool juno_equal(const JsonNode *a, const JsonNode *b) {
+    if (a == b) return true;
+    if (!a || !b) return false;
+    return _equal(_v_node(a), _v_node(b));
+}
+
+bool juno_bin_equal(const JunoBinDoc *a, JunoBinRef ra, const JunoBinDoc *b, JunoBinRef rb) {
+    JVal va = _v_bin(a, ra), vb = _v_bin(b, rb);
+    if (!_v_ok(va) || !_v_ok(vb)) return !_v_ok(va) && !_v_ok(vb);
+    return _equal(va, vb);
+}
+
+/* ------------------------------
+ * Streaming hash
+ * ------------------------------ */
+
+typedef struct {
+    uint64_t acc;
+    uint64_t n;
+    uint64_t key;    /* hash of the pending member name */
+    bool     is_obj;
+} JHashFrame;
+
+static void _frame_add(JHashFrame *f, uint64_t h) {
+    if (f->is_obj) f->acc = _obj_add(f->acc, f->key, h);
+    else f->acc = _arr_add(f->acc, h);
+    f->n++;
+}
+
+static bool _hash_fail(JunoError *err, JunoErrorCode code, const char *msg, size_t offset) {
+    if (err) {
+        memset(err, 0, sizeof(*err));
+        err->code = code;
+        err->msg = msg;
+        err->offset = offset;
+    }
+    return false;
+}
+
+bool juno_hash_buffer(const char *json_str, size_t len, uint64_t *out, JunoError *err) {
+    if (!json_str || !out) return _hash_fail(err, JUNO_ERR_INVALID_ARG, "null input", 0);
+
+    JunoReader *r = juno_reader_new_mem(json_str, len);
+    if (!r) return _hash_fail(err, JUNO_ERR_OOM, "oom (reader)", 0);
+
+    /* frames[0] receives the top-level value. */
+    JHashFrame frames[JUNO_MAX_NESTING + 1];
+    memset(&frames[0], 0, sizeof(frames[0]));
+    bool done = false, ok = false;
+    JunoEvent ev;
+
+    while (!done) {
+        uint64_t h;
+        unsigned parent = 0;
+        switch (juno_reader_next(r, &ev)) {
+            case JEV_ERROR:
+                if (err) *err = *juno_reader_error(r);
+                goto out;
+            case JEV_EOF:
+                _hash_fail(err, JUNO_ERR_UNEXPECTED_EOF, "empty input", ev.offset);
+                goto out;
+            case JEV_DOC_END:
+                done = true;
+                continue;
+            case JEV_OBJ_BEGIN:
+            case JEV_ARR_BEGIN:
+                memset(&frames[ev.depth], 0, sizeof(frames[ev.depth]));
+                frames[ev.depth].is_obj = (ev.type == JEV_OBJ_BEGIN);
+                continue;
+            case JEV_KEY:
+                frames[ev.depth].key = juno_hash_bytes(ev.str, ev.str_len, JH_KEY);
+                continue;
+            case JEV_OBJ_END:
+                h = _obj_end(frames[ev.depth].acc, frames[ev.depth].n);
+                parent = ev.depth - 1;
+                break;
+            case JEV_ARR_END:
+                h = _arr_end(frames[ev.depth].acc, frames[ev.depth].n);
+                parent = ev.depth - 1;
+                break;
+            case JEV_STRING:
+                h = juno_hash_bytes(ev.str, ev.str_len, JH_STRING);
+                parent = ev.depth;
+                break;
+            case JEV_NUMBER: {
+                JNum n = _num_from_text(ev.raw, ev.raw_len);
+                h = _num_hash(&n);
+                parent = ev.depth;
+                break;
+            }
+            case JEV_BOOL: {
+                unsigned char b = ev.bvalue ? 1 : 0;
+                h = juno_hash_bytes(&b, 1, JH_BOOL);
+                parent = ev.depth;
+                break;
+            }
+            default: /* JEV_NULL */
+                h = juno_hash_bytes(NULL, 0, JH_NULL);
+                parent = ev.depth;
+                break;
+        }
+
+        if (parent == 0) *out = h;
+        else _frame_add(&frames[parent], h);
+    }
+
+    /* Exactly one document. */
+    if (juno_reader_next(r, &ev) != JEV_EOF) {
+        if (ev.type == JEV_ERROR && err) *err = *juno_reader_error(r);
+        else _hash_fail(err, JUNO_ERR_UNEXPECTED_TOKEN, "unexpected data after document", ev.offset);
+        goto out;
+    }
+    if (err) memset(err, 0, sizeof(*err));
+    ok = true;
+
+out:
+    juno_reader_free(r);
+    return ok;
+}
@@ -0,0 +1,136 @@
+#include "internal/juno_internal.h"
+
+#include <juno/iter.h>
+
+/* ------------------------------
+ * Node access (tree or binary image)
+ * ------------------------------ */
+
+static inline JNodeType _it_type(const JunoIter *it, JunoIterPos p) {
+    JNodeType t = it->doc ? juno_bin_type(it->doc, p.ref) : p.node->type;
+    return t == JND_ROOT_OBJ ? JND_OBJ : t;
+}
+
+static inline bool _it_first(const JunoIter *it, JunoIterPos p, JunoIterPos *out) {
+    if (it->doc) {
+        out->ref = juno_bin_first_child(it->doc, p.ref);
+        return out->ref != JUNO_BIN_NONE;
+    }
+    out->node = p.node->first_child;
+    return out->node != NULL;
+}
+
+static inline bool _it_sibling(const JunoIter *it, JunoIterPos p, JunoIterPos *out) {
+    if (it->doc) {
+        out->ref = juno_bin_next_sibling(it->doc, p.ref);
+        return out->ref != JUNO_BIN_NONE;
+    }
+    out->node = p.node->next_sibling;
+    return out->node != NULL;
+}
+
+static inline bool _it_same(const JunoIter *it, JunoIterPos a, JunoIterPos b) {
+    return it->doc ? a.ref == b.ref : a.node == b.node;
+}
+
+/* ------------------------------
+ * Path stack
+ * ------------------------------ */
+
+static inline JunoIterPos* _it_path(JunoIter *it) {
+    return it->heap ? it->heap : it->path;
+}
+
+static bool _it_push(JunoIter *it, JunoIterPos p) {
+    if (it->sp == it->cap) {
+        unsigned cap = it->cap * 2;
+        JunoIterPos *h = (JunoIterPos*)realloc(it->heap, cap * sizeof(*h));
+        if (!h) return false;
+        if (!it->heap) memcpy(h, it->path, it->sp * sizeof(*h));
+        it->heap = h;
+        it->cap = cap;
+    }
+    _it_path(it)[it->sp++] = p;
+    return true;
+}
+
+/* Key of `p`, whose parent is the top of the path. */
+static void _it_key(JunoIter *it, JunoIterPos p) {
+    it->key = NULL;
+    it->key_len = 0;
+    if (it->sp == 0 || _it_type(it, _it_path(it)[it->sp - 1]) != JND_OBJ) return;
+
+    if (it->doc) {
+        it->key = juno_bin_key(it->doc, p.ref, &it->key_len);
+    } else if (p.node->key) {
+        it->key = p.node->key;
+        it->key_len = strlen(p.node->key);
+    }
+    if (!it->key) it->key = "";
+}
+
+/* ------------------------------
+ * Public API
+ * ------------------------------ */
+
+static void _it_init(JunoIter *it, const JunoBinDoc *doc) {
+    memset(it, 0, offsetof(JunoIter, path));
+    it->doc = doc;
+    it->cap = JUNO_ITER_INLINE_DEPTH;
+}
+
+void juno_iter_init(JunoIter *it, const JsonNode *root) {
+    _it_init(it, NULL);
+    it->next.node = root;
+    it->has_next = (root != NULL);
+}
+
+void juno_iter_init_bin(JunoIter *it, const JunoBinDoc *doc, JunoBinRef root) {
+    _it_init(it, doc);
+    it->next.ref = root;
+    it->has_next = (doc != NULL && root != JUNO_BIN_NONE);
+}
+
+JunoIterEvent juno_iter_next(JunoIter *it) {
+    JunoIterPos p;
+
+    if (it->has_next) {
+        p = it->next;
+        it->pos = p;
+        it->type = _it_type(it, p);
+        it->depth = it->sp;
+        _it_key(it, p);
+
+        if (it->type == JND_OBJ || it->type == JND_ARRAY) {
+            if (!_it_push(it, p)) return JUNO_ITER_ERROR;
+            it->has_next = _it_first(it, p, &it->next);
+            return JUNO_ITER_ENTER;
+        }
+        it->has_next = it->sp > 0 && _it_sibling(it, p, &it->next);
+        return JUNO_ITER_VALUE;
+    }
+
+    if (it->sp == 0) return JUNO_ITER_END;
+
+    p = _it_path(it)[--it->sp];
+    it->pos = p;
+    it->type = _it_type(it, p);
+    it->depth = it->sp;
+    _it_key(it, p);
+    it->has_next = it->sp > 0 && _it_sibling(it, p, &it->next);
+    return JUNO_ITER_LEAVE;
+}
+
+void juno_iter_skip(JunoIter *it) {
+    /* Right after ENTER the current node is still the top of the path. */
+    if (it->sp > 0 && _it_same(it, _it_path(it)[it->sp - 1], it->pos)) it->has_next = false;
+}
+
+void juno_iter_free(JunoIter *it) {
+    if (!it) return;
+    free(it->heap);
+    it->heap = NULL;
+    it->cap = JUNO_ITER_INLINE_DEPTH;
+    it->sp = 0;
+    it->has_next = false;
+}
@@ -54,15 +54,12 @@ static int hex_val(char c) {
     return -1;
 }
 
-/* Decode a JSON string slice (without quotes) into malloc'd UTF-8. */
-static char* json_decode_string(const char *s, size_t n, const char **err_msg) {
-    size_t cap = n * 4 + 4;
-    char *out = (char*)malloc(cap);
-    if (!out) {
-        if (err_msg) *err_msg = "oom";
-        return NULL;
-    }
+#define JL_DECODE_FAIL(msg) do { if (err_msg) *err_msg = (msg); return false; } while (0)
 
+/* Decode a JSON string slice (without quotes) into `out`, which must hold at
+ * least n + 1 bytes: every escape decodes to fewer bytes than it occupies, so
+ * the UTF-8 output is never longer than the input. */
+bool jl_decode_string_into(const char *s, size_t n, char *out, size_t *out_len, const char **err_msg) {
     char *w = out;
     const char *end = s + n;
 
@@ -70,11 +67,7 @@ static char* json_decode_string(const char *s, size_t n, const char **err_msg) {
         unsigned char c = (unsigned char)*s++;
 
         if (c == '\\') {
-            if (s >= end) {
-                if (err_msg) *err_msg = "trailing backslash";
-                free(out);
-                return NULL;
-            }
+            if (s >= end) JL_DECODE_FAIL("trailing backslash");
             char esc = *s++;
             switch (esc) {
                 case '"': *w++ = '"'; break;
@@ -86,77 +79,111 @@ static char* json_decode_string(const char *s, size_t n, const char **err_msg) {
                 case 'r': *w++ = '\r'; break;
                 case 't': *w++ = '\t'; break;
                 case 'u': {
-                    if (end - s < 4) {
-                        if (err_msg) *err_msg = "short \\u";
-                        free(out);
-                        return NULL;
-                    }
+                    if (end - s < 4) JL_DECODE_FAIL("short \\u");
                     int h0 = hex_val(s[0]), h1 = hex_val(s[1]), h2 = hex_val(s[2]), h3 = hex_val(s[3]);
-                    if (h0 < 0 || h1 < 0 || h2 < 0 || h3 < 0) {
-                        if (err_msg) *err_msg = "bad hex";
-                        free(out);
-                        return NULL;
-                    }
+                    if (h0 < 0 || h1 < 0 || h2 < 0 || h3 < 0) JL_DECODE_FAIL("bad hex");
                     uint32_t code = (uint32_t)((h0 << 12) | (h1 << 8) | (h2 << 4) | h3);
                     s += 4;
 
                     /* Surrogate pair */
                     if (code >= 0xD800 && code <= 0xDBFF) {
-                        if (end - s < 6 || s[0] != '\\' || s[1] != 'u') {
-                            if (err_msg) *err_msg = "high surrogate without pair";
-                            free(out);
-                            return NULL;
-                        }
+                        if (end - s < 6 || s[0] != '\\' || s[1] != 'u') JL_DECODE_FAIL("high surrogate without pair");
                         s += 2;
                         int g0 = hex_val(s[0]), g1 = hex_val(s[1]), g2 = hex_val(s[2]), g3 = hex_val(s[3]);
-                        if (g0 < 0 || g1 < 0 || g2 < 0 || g3 < 0) {
-                            if (err_msg) *err_msg = "bad hex (low)";
-                            free(out);
-                            return NULL;
-                        }
+                        if (g0 < 0 || g1 < 0 || g2 < 0 || g3 < 0) JL_DECODE_FAIL("bad hex (low)");
                         uint32_t low = (uint32_t)((g0 << 12) | (g1 << 8) | (g2 << 4) | g3);
                         s += 4;
-                        if (low < 0xDC00 || low > 0xDFFF) {
-                            if (err_msg) *err_msg = "invalid low surrogate";
-                            free(out);
-                            return NULL;
-                        }
+                        if (low < 0xDC00 || low > 0xDFFF) JL_DECODE_FAIL("invalid low surrogate");
                         code = 0x10000 + (((code - 0xD800) << 10) | (low - 0xDC00));
                     }
 
                     utf8_emit(code, &w);
                 } break;
                 default:
-                    if (err_msg) *err_msg = "bad escape";
-                    free(out);
-                    return NULL;
+                    JL_DECODE_FAIL("bad escape");
             }
         } else {
             /* Reject raw control chars */
-            if (c < 0x20) {
-                if (err_msg) *err_msg = "control char in string";
-                free(out);
-                return NULL;
-            }
+            if (c < 0x20) JL_DECODE_FAIL("control char in string");
             *w++ = (char)c;
         }
+    }
 
-        /* Grow output buffer if needed */
-        if ((size_t)(w - out) + 4 >= cap) {
-            size_t used = (size_t)(w - out);
-            cap *= 2;
-            char *nw = (char*)realloc(out, cap);
-            if (!nw) {
-                if (err_msg) *err_msg = "oom";
-                free(out);
-                return NULL;
-            }
-            out = nw;
-            w = out + used;
+    *w = '\0';
+    if (out_len) *out_len = (size_t)(w - out);
+    return true;
+}
+
+/* Just past the escape whose backslash precedes `p`, or NULL with the
+ * message jl_decode_string_into would report. */
+static const char* jl_check_escape(const char *p, const char *end, const char **msg) {
+    if (p >= end) {
+        *msg = "trailing backslash";
+        return NULL;
+    }
+    switch (*p++) {
+        case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+            return p;
+        case 'u':
+            break;
+        default:
+            *msg = "bad escape";
+            return NULL;
+    }
+    if (end - p < 4) {
+        *msg = "short \\u";
+        return NULL;
+    }
+    int h0 = hex_val(p[0]), h1 = hex_val(p[1]), h2 = hex_val(p[2]), h3 = hex_val(p[3]);
+    if (h0 < 0 || h1 < 0 || h2 < 0 || h3 < 0) {
+        *msg = "bad hex";
+        return NULL;
+    }
+    p += 4;
+    /* A high surrogate must be followed by an escaped low one. */
+    if (h0 == 0xD && h1 >= 0x8 && h1 <= 0xB) {
+        if (end - p < 6 || p[0] != '\\' || p[1] != 'u') {
+            *msg = "high surrogate without pair";
+            return NULL;
+        }
+        int g0 = hex_val(p[2]), g1 = hex_val(p[3]), g2 = hex_val(p[4]), g3 = hex_val(p[5]);
+        if (g0 < 0 || g1 < 0 || g2 < 0 || g3 < 0) {
+            *msg = "bad hex (low)";
+            return NULL;
         }
+        if (g0 != 0xD || g1 < 0xC) {
+            *msg = "invalid low surrogate";
+            return NULL;
+        }
+        p += 6;
     }
+    return p;
+}
 
-    *w = '\0';
+bool jl_check_string(const char *s, size_t n, const char **err_msg) {
+    const char *end = s + n, *msg = NULL;
+    while (s < end) {
+        unsigned char c = (unsigned char)*s++;
+        if (c == '\\') {
+            if ((s = jl_check_escape(s, end, &msg)) == NULL) JL_DECODE_FAIL(msg);
+        } else if (c < 0x20) {
+            JL_DECODE_FAIL("control char in string");
+        }
+    }
+    return true;
+}
+
+/* Decode a JSON string slice (without quotes) into malloc'd UTF-8. */
+static char* json_decode_string(const char *s, size_t n, const char **err_msg) {
+    char *out = (char*)malloc(n + 1);
+    if (!out) {
+        if (err_msg) *err_msg = "oom";
+        return NULL;
+    }
+    if (!jl_decode_string_into(s, n, out, NULL, err_msg)) {
+        free(out);
+        return NULL;
+    }
     return out;
 }
 
@@ -338,6 +365,136 @@ JToken jl_next(JLexer *lx) {
     }
 }
 
+/* Just past the closing quote of the string body starting at `p`, or NULL
+ * when it is unterminated or malformed: the control character and escape
+ * checks jl_decode_string_into makes, without writing anything. */
+static const char* jl_skip_string(const char *p, const char *end) {
+    const char *msg;
+    while (p < end) {
+        unsigned char c = (unsigned char)*p++;
+        if (c == '"') return p;
+        if (c < 0x20) return NULL;
+        if (c == '\\' && (p = jl_check_escape(p, end, &msg)) == NULL) return NULL;
+    }
+    return NULL;
+}
+
+/* End of the number starting at `p`, NULL when it breaks the grammar. */
+static const char* jl_skip_number(const char *p, const char *end) {
+    if (p < end && *p == '-') p++;
+    if (p >= end || !isdigit((unsigned char)*p)) return NULL;
+    if (*p == '0') {
+        if (++p < end && isdigit((unsigned char)*p)) return NULL;
+    } else {
+        while (p < end && isdigit((unsigned char)*p)) p++;
+    }
+    if (p < end && *p == '.') {
+        if (++p >= end || !isdigit((unsigned char)*p)) return NULL;
+        while (p < end && isdigit((unsigned char)*p)) p++;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        if (++p < end && (*p == '+' || *p == '-')) p++;
+        if (p >= end || !isdigit((unsigned char)*p)) return NULL;
+        while (p < end && isdigit((unsigned char)*p)) p++;
+    }
+    return p;
+}
+
+typedef enum {
+    JL_SK_VALUE,        /* a value */
+    JL_SK_VALUE_OR_END, /* a value or ']' (just after '[') */
+    JL_SK_KEY,          /* a member name */
+    JL_SK_KEY_OR_END,   /* a member name or '}' (just after '{') */
+    JL_SK_COLON,        /* ':' after a member name */
+    JL_SK_NEXT          /* ',' or the closing bracket */
+} JSkipState;
+
+JSkipResult jl_skip_value(JLexer *lx, unsigned max_depth) {
+    char stack[JUNO_MAX_NESTING + 1];
+    unsigned depth = 0;
+    JSkipState state = JL_SK_VALUE;
+
+    if (max_depth > JUNO_MAX_NESTING + 1) max_depth = JUNO_MAX_NESTING + 1;
+
+    const char *p = lx->p;
+    const char *end = lx->end;
+    JSkipResult res = JL_SKIP_SYNTAX;
+
+    for (;;) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+        if (p >= end) {
+            res = JL_SKIP_EOF;
+            goto fail;
+        }
+        char c = *p;
+
+        if (state == JL_SK_NEXT) {
+            char close = stack[depth - 1] == '{' ? '}' : ']';
+            if (c == ',') {
+                p++;
+                state = stack[depth - 1] == '{' ? JL_SK_KEY : JL_SK_VALUE;
+                continue;
+            }
+            if (c != close) goto fail;
+            p++;
+            if (--depth == 0) break;
+            continue;
+        }
+        if (state == JL_SK_COLON) {
+            if (c != ':') goto fail;
+            p++;
+            state = JL_SK_VALUE;
+            continue;
+        }
+        if ((state == JL_SK_VALUE_OR_END && c == ']') || (state == JL_SK_KEY_OR_END && c == '}')) {
+            p++;
+            if (--depth == 0) break;
+            state = JL_SK_NEXT;
+            continue;
+        }
+        if (state == JL_SK_KEY || state == JL_SK_KEY_OR_END) {
+            if (c != '"') goto fail;
+        }
+
+        /* A value (or a member name, which is a string). */
+        const char *q;
+        switch (c) {
+            case '{':
+            case '[':
+                if (depth >= max_depth) {
+                    res = JL_SKIP_NESTING;
+                    goto fail;
+                }
+                stack[depth++] = c;
+                p++;
+                state = c == '{' ? JL_SK_KEY_OR_END : JL_SK_VALUE_OR_END;
+                continue;
+            case '"':
+                if ((q = jl_skip_string(p + 1, end)) == NULL) {
+                    res = JL_SKIP_STRING;
+                    goto fail;
+                }
+                break;
+            case 't': q = (end - p >= 4 && memcmp(p, "true", 4) == 0) ? p + 4 : NULL; break;
+            case 'f': q = (end - p >= 5 && memcmp(p, "false", 5) == 0) ? p + 5 : NULL; break;
+            case 'n': q = (end - p >= 4 && memcmp(p, "null", 4) == 0) ? p + 4 : NULL; break;
+            default:  q = (c == '-' || isdigit((unsigned char)c)) ? jl_skip_number(p, end) : NULL; break;
+        }
+        if (!q) goto fail;
+        p = q;
+        if (state == JL_SK_KEY || state == JL_SK_KEY_OR_END) state = JL_SK_COLON;
+        else if (depth == 0) break;
+        else state = JL_SK_NEXT;
+    }
+
+    lx->p = p;
+    return JL_SKIP_OK;
+
+fail:
+    lx->p = p;
+    return res;
+}
+
 char* jl_string_to_utf8(const JToken *t, const char **err_msg_out) {
     if (err_msg_out) *err_msg_out = NULL;
     if (!t || t->type != JTK_STRING) {
@@ -361,8 +518,13 @@ char* jl_string_to_utf8(const JToken *t, const char **err_msg_out) {
 bool jl_number_to_double(const JToken *t, double *out) {
     if (!t || t->type != JTK_NUMBER || !out) return false;
 
-    char *tmp = (char*)malloc(t->length + 1);
-    if (!tmp) return false;
+    /* strtod needs a terminator; numbers rarely need the heap copy. */
+    char stackbuf[64];
+    char *tmp = stackbuf;
+    if (t->length >= sizeof(stackbuf)) {
+        tmp = (char*)malloc(t->length + 1);
+        if (!tmp) return false;
+    }
     memcpy(tmp, t->start, t->length);
     tmp[t->length] = '\0';
 
@@ -371,33 +533,52 @@ bool jl_number_to_double(const JToken *t, double *out) {
     double v = strtod(tmp, &endp);
     bool ok = (errno == 0) && endp && (*endp == '\0');
 
-    free(tmp);
+    if (tmp != stackbuf) free(tmp);
     if (!ok) return false;
     *out = v;
     return true;
 }
 
+/* Magnitude of an integer token (digits only after an optional '-'), or
+ * false on fraction / exponent / overflow of `limit`. */
+static bool jl_number_magnitude(const JToken *t, uint64_t limit, bool *neg, uint64_t *out) {
+    const char *p = t->start, *end = t->start + t->length;
+
+    *neg = (p < end && *p == '-');
+    if (*neg) p++;
+    if (p == end) return false;
+
+    uint64_t v = 0;
+    for (; p < end; p++) {
+        unsigned d = (unsigned)(unsigned char)*p - '0';
+        if (d > 9) return false;
+        if (v > (limit - d) / 10) return false;
+        v = v * 10 + d;
+    }
+    *out = v;
+    return true;
+}
+
 bool jl_number_to_int64(const JToken *t, int64_t *out) {
     if (!t || t->type != JTK_NUMBER || !out) return false;
 
-    /* Reject if contains '.' or exponent */
-    for (size_t i = 0; i < t->length; ++i) {
-        char c = t->start[i];
-        if (c == '.' || c == 'e' || c == 'E') return false;
-    }
+    bool neg = false;
+    uint64_t v = 0;
+    if (!jl_number_magnitude(t, (uint64_t)INT64_MAX + 1, &neg, &v)) return false;
+    if (!neg && v > (uint64_t)INT64_MAX) return false;
 
-    char *tmp = (char*)malloc(t->length + 1);
-    if (!tmp) return false;
-    memcpy(tmp, t->start, t->length);
-    tmp[t->length] = '\0';
+    if (!neg) *out = (int64_t)v;
+    else if (v == (uint64_t)INT64_MAX + 1) *out = INT64_MIN;
+    else *out = -(int64_t)v;
+    return true;
+}
 
-    errno = 0;
-    char *endp = NULL;
-    long long v = strtoll(tmp, &endp, 10);
-    bool ok = (errno == 0) && endp && (*endp == '\0');
+bool jl_number_to_uint64(const JToken *t, uint64_t *out) {
+    if (!t || t->type != JTK_NUMBER || !out) return false;
 
-    free(tmp);
-    if (!ok) return false;
-    *out = (int64_t)v;
+    bool neg = false;
+    uint64_t v = 0;
+    if (!jl_number_magnitude(t, UINT64_MAX, &neg, &v) || (neg && v != 0)) return false;
+    *out = v;
     return true;
 }
@@ -0,0 +1,984 @@
+#include "internal/juno_internal.h"
+
+#include <juno/patch.h>
+#include <juno/builder.h>
+#include <juno/hash.h>
+
+static inline bool _is_obj(const JsonNode *n) {
+    return n && (n->type == JND_OBJ || n->type == JND_ROOT_OBJ);
+}
+
+static inline bool _is_container(const JsonNode *n) {
+    return _is_obj(n) || (n && n->type == JND_ARRAY);
+}
+
+static inline const char* _key(const JsonNode *n) { return n->key ? n->key : ""; }
+
+static inline uint64_t _key_hash(const char *key) { return juno_hash_bytes(key, strlen(key), 0); }
+
+static inline void _free_key(const JsonNode *n, char *key) {
+    if (!(n->flags & JND_FLAG_ARENA)) free(key);
+}
+
+/* ------------------------------
+ * Index
+ * ------------------------------ */
+
+/* Containers with fewer children are scanned; a table would not pay off. */
+#define JIDX_MIN 16
+
+typedef struct {
+    uint64_t  h;
+    JsonNode *node;   /* NULL: empty, JIDX_GONE: deleted */
+    JsonNode *prev;   /* sibling before `node`, so members unlink in O(1) */
+} JIdxSlot;
+
+typedef struct {
+    const JsonNode *owner;   /* NULL: empty, JIDX_GONE: deleted */
+    bool            off;     /* not indexable (object with duplicate names) */
+    size_t          n;       /* live members / elements */
+    size_t          cap;
+    size_t          used;    /* objects: live + deleted slots */
+    JIdxSlot       *slots;   /* objects: open addressing on the key hash */
+    JsonNode      **elems;   /* arrays: children in order */
+} JIdxTable;
+
+struct JunoIndex {
+    JIdxTable *t;            /* open addressing on the container address */
+    size_t     n, cap, used;
+};
+
+static JsonNode jidx_gone;
+#define JIDX_GONE (&jidx_gone)
+
+static inline uint64_t _ptr_hash(const void *p) {
+    uint64_t x = (uint64_t)(uintptr_t)p;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static inline bool _live(const void *p) { return p && p != (const void*)JIDX_GONE; }
+
+JunoIndex* juno_index_new(void) {
+    return (JunoIndex*)calloc(1, sizeof(JunoIndex));
+}
+
+static void _table_release(JIdxTable *t) {
+    free(t->slots);
+    free(t->elems);
+}
+
+void juno_index_clear(JunoIndex *idx) {
+    if (!idx) return;
+    for (size_t i = 0; i < idx->cap; i++) {
+        if (_live(idx->t[i].owner)) _table_release(&idx->t[i]);
+    }
+    free(idx->t);
+    memset(idx, 0, sizeof(*idx));
+}
+
+void juno_index_free(JunoIndex *idx) {
+    juno_index_clear(idx);
+    free(idx);
+}
+
+static JIdxTable* _idx_find(const JunoIndex *idx, const JsonNode *c) {
+    if (!idx || !idx->n) return NULL;
+    size_t mask = idx->cap - 1;
+    for (size_t i = _ptr_hash(c) & mask;; i = (i + 1) & mask) {
+        JIdxTable *t = &idx->t[i];
+        if (t->owner == c) return t;
+        if (!t->owner) return NULL;
+    }
+}
+
+static bool _idx_grow(JunoIndex *idx) {
+    size_t cap = 16;
+    while (cap < idx->n * 4) cap *= 2;
+    JIdxTable *t = (JIdxTable*)calloc(cap, sizeof(*t));
+    if (!t) return false;
+
+    for (size_t i = 0; i < idx->cap; i++) {
+        if (!_live(idx->t[i].owner)) continue;
+        size_t j = _ptr_hash(idx->t[i].owner) & (cap - 1);
+        while (t[j].owner) j = (j + 1) & (cap - 1);
+        t[j] = idx->t[i];
+    }
+    free(idx->t);
+    idx->t = t;
+    idx->cap = cap;
+    idx->used = idx->n;
+    return true;
+}
+
+/* New, empty table for `c` (not present yet). */
+static JIdxTable* _idx_insert(JunoIndex *idx, const JsonNode *c) {
+    if ((idx->used + 1) * 4 > idx->cap * 3 && !_idx_grow(idx)) return NULL;
+    size_t mask = idx->cap - 1, i = _ptr_hash(c) & mask;
+    while (_live(idx->t[i].owner)) i = (i + 1) & mask;
+    if (!idx->t[i].owner) idx->used++;
+    memset(&idx->t[i], 0, sizeof(idx->t[i]));
+    idx->t[i].owner = c;
+    idx->n++;
+    return &idx->t[i];
+}
+
+static void _idx_drop(JunoIndex *idx, const JsonNode *c) {
+    JIdxTable *t = _idx_find(idx, c);
+    if (!t) return;
+    _table_release(t);
+    memset(t, 0, sizeof(*t));
+    t->owner = JIDX_GONE;
+    idx->n--;
+}
+
+/* Drop the tables of a subtree that is about to be freed. */
+static void _idx_forget(JunoIndex *idx, const JsonNode *n) {
+    if (!idx || !idx->n || !_is_container(n)) return;
+    _idx_drop(idx, n);
+    for (const JsonNode *c = n->first_child; c; c = c->next_sibling) _idx_forget(idx, c);
+}
+
+static JIdxSlot* _slot_find(const JIdxTable *t, uint64_t h, const char *key) {
+    size_t mask = t->cap - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        JIdxSlot *s = &t->slots[i];
+        if (!s->node) return NULL;
+        if (s->node != JIDX_GONE && s->h == h && strcmp(_key(s->node), key) == 0) return s;
+    }
+}
+
+static JIdxSlot* _slot_of(const JIdxTable *t, const JsonNode *node) {
+    size_t mask = t->cap - 1;
+    for (size_t i = _key_hash(_key(node)) & mask;; i = (i + 1) & mask) {
+        JIdxSlot *s = &t->slots[i];
+        if (s->node == node) return s;
+        if (!s->node) return NULL;
+    }
+}
+
+static bool _slots_resize(JIdxTable *t, size_t want) {
+    size_t cap = 16;
+    while (cap < want * 2) cap *= 2;
+    JIdxSlot *slots = (JIdxSlot*)calloc(cap, sizeof(*slots));
+    if (!slots) return false;
+
+    for (size_t i = 0; i < t->cap; i++) {
+        if (!_live(t->slots[i].node)) continue;
+        size_t j = t->slots[i].h & (cap - 1);
+        while (slots[j].node) j = (j + 1) & (cap - 1);
+        slots[j] = t->slots[i];
+    }
+    free(t->slots);
+    t->slots = slots;
+    t->cap = cap;
+    t->used = t->n;
+    return true;
+}
+
+static bool _slot_add(JIdxTable *t, uint64_t h, JsonNode *node, JsonNode *prev) {
+    if ((t->used + 1) * 4 > t->cap * 3 && !_slots_resize(t, t->n + 1)) return false;
+    size_t mask = t->cap - 1, i = h & mask;
+    while (_live(t->slots[i].node)) i = (i + 1) & mask;
+    if (!t->slots[i].node) t->used++;
+    t->slots[i].h = h;
+    t->slots[i].node = node;
+    t->slots[i].prev = prev;
+    t->n++;
+    return true;
+}
+
+static bool _build(JIdxTable *t, JsonNode *c) {
+    size_t n = 0;
+    for (JsonNode *ch = c->first_child; ch; ch = ch->next_sibling) n++;
+
+    if (c->type == JND_ARRAY) {
+        t->cap = n + n / 2;
+        if ((t->elems = (JsonNode**)malloc(t->cap * sizeof(*t->elems))) == NULL) return false;
+        for (JsonNode *ch = c->first_child; ch; ch = ch->next_sibling) t->elems[t->n++] = ch;
+        return true;
+    }
+
+    if (!_slots_resize(t, n)) return false;
+    JsonNode *prev = NULL;
+    for (JsonNode *ch = c->first_child; ch; prev = ch, ch = ch->next_sibling) {
+        uint64_t h = _key_hash(_key(ch));
+        if (_slot_find(t, h, _key(ch))) {
+            t->off = true;
+            return false;
+        }
+        _slot_add(t, h, ch, prev);
+    }
+    return true;
+}
+
+/* Table of container `c`, built on first use once it is large enough.
+ * NULL means "scan the children". */
+static JIdxTable* _idx_table(JunoIndex *idx, JsonNode *c) {
+    if (!idx) return NULL;
+    JIdxTable *t = _idx_find(idx, c);
+    if (t) return t->off ? NULL : t;
+
+    size_t n = 0;
+    for (JsonNode *ch = c->first_child; ch && n < JIDX_MIN; ch = ch->next_sibling) n++;
+    if (n < JIDX_MIN || (t = _idx_insert(idx, c)) == NULL) return NULL;
+
+    if (_build(t, c)) return t;
+    if (t->off) {
+        /* Remember not to try again. */
+        _table_release(t);
+        t->slots = NULL;
+        t->elems = NULL;
+    } else {
+        _idx_drop(idx, c);
+    }
+    return NULL;
+}
+
+/* Keep the table of `c` in step with a link / unlink. A table that cannot
+ * be updated is dropped: the index is only a cache. */
+static void _idx_linked(JunoIndex *idx, JsonNode *c, JsonNode *prev, JsonNode *node, size_t pos) {
+    JIdxTable *t = _idx_find(idx, c);
+    if (!t || t->off) return;
+
+    if (c->type == JND_ARRAY) {
+        if (t->n == t->cap) {
+            size_t cap = t->cap * 2 + 8;
+            JsonNode **e = (JsonNode**)realloc(t->elems, cap * sizeof(*e));
+            if (!e) {
+                _idx_drop(idx, c);
+                return;
+            }
+            t->elems = e;
+            t->cap = cap;
+        }
+        memmove(t->elems + pos + 1, t->elems + pos, (t->n - pos) * sizeof(*t->elems));
+        t->elems[pos] = node;
+        t->n++;
+        return;
+    }
+
+    if (!_slot_add(t, _key_hash(_key(node)), node, prev)) {
+        _idx_drop(idx, c);
+        return;
+    }
+    JIdxSlot *s = node->next_sibling ? _slot_of(t, node->next_sibling) : NULL;
+    if (s) s->prev = node;
+}
+
+static void _idx_unlinked(JunoIndex *idx, JsonNode *c, JsonNode *prev, JsonNode *node, JsonNode *next, size_t pos) {
+    JIdxTable *t = _idx_find(idx, c);
+    if (!t || t->off) return;
+
+    if (c->type == JND_ARRAY) {
+        t->n--;
+        memmove(t->elems + pos, t->elems + pos + 1, (t->n - pos) * sizeof(*t->elems));
+        return;
+    }
+
+    JIdxSlot *s = _slot_of(t, node);
+    if (s) {
+        s->node = JIDX_GONE;
+        t->n--;
+    }
+    if (next && (s = _slot_of(t, next)) != NULL) s->prev = prev;
+}
+
+/* ------------------------------
+ * Lookup
+ * ------------------------------ */
+
+/* Member `key` of `obj` (NULL if absent) and the sibling before it. */
+static JsonNode* _member(JunoIndex *idx, JsonNode *obj, const char *key, JsonNode **prev) {
+    JIdxTable *t = _idx_table(idx, obj);
+    if (t) {
+        JIdxSlot *s = _slot_find(t, _key_hash(key), key);
+        *prev = s ? s->prev : NULL;
+        return s ? s->node : NULL;
+    }
+
+    JsonNode *p = NULL;
+    for (JsonNode *c = obj->first_child; c; p = c, c = c->next_sibling) {
+        if (strcmp(_key(c), key) == 0) {
+            *prev = p;
+            return c;
+        }
+    }
+    *prev = NULL;
+    return NULL;
+}
+
+static JsonNode* _last(JunoIndex *idx, JsonNode *c) {
+    JIdxTable *t = _idx_find(idx, c);
+    if (t && !t->off && c->type == JND_ARRAY) return t->n ? t->elems[t->n - 1] : NULL;
+
+    return juno_last_child(c);
+}
+
+static size_t _length(JunoIndex *idx, JsonNode *arr) {
+    JIdxTable *t = _idx_table(idx, arr);
+    if (t) return t->n;
+    size_t n = 0;
+    for (JsonNode *c = arr->first_child; c; c = c->next_sibling) n++;
+    return n;
+}
+
+/* Element `i` of `arr` (NULL when `i` is the length) and the one before it.
+ * False when `i` is past the end. */
+static bool _element(JunoIndex *idx, JsonNode *arr, size_t i, JsonNode **node, JsonNode **prev) {
+    JIdxTable *t = _idx_table(idx, arr);
+    if (t) {
+        if (i > t->n) return false;
+        *node = i < t->n ? t->elems[i] : NULL;
+        *prev = i ? t->elems[i - 1] : NULL;
+        return true;
+    }
+
+    JsonNode *p = NULL, *c = arr->first_child;
+    for (; c && i; i--) {
+        p = c;
+        c = c->next_sibling;
+    }
+    if (i) return false;
+    *node = c;
+    *prev = p;
+    return true;
+}
+
+/* ------------------------------
+ * Edit log
+ * ------------------------------ */
+
+enum { JE_INSERT, JE_REMOVE, JE_REKEY, JE_ROOT };
+
+/* One undoable step. Undo runs newest first, so `prev` / `pos` describe the
+ * container exactly as it was when the step was made. */
+typedef struct {
+    uint8_t   op;
+    bool      fresh;    /* JE_INSERT / JE_ROOT: the linked node was created by the patch */
+    bool      moved;    /* JE_REMOVE: the node was linked in again elsewhere (move) */
+    JsonNode *parent;   /* JE_INSERT / JE_REMOVE: container; JE_ROOT: new root */
+    JsonNode *prev;
+    JsonNode *node;     /* JE_ROOT: previous root */
+    size_t    pos;      /* array index */
+    char     *key;      /* JE_REKEY: previous member name */
+} JEdit;
+
+typedef struct {
+    JunoArena *arena;
+    JsonNode **root;
+    JunoIndex *idx;
+    JEdit     *log;
+    size_t     log_len, log_cap;
+    char      *seg;       /* decoded JSON Pointer reference token */
+    size_t     seg_cap;
+    JunoError  err;
+} JPatch;
+
+/* A location named by a JSON Pointer. */
+typedef struct {
+    JsonNode   *parent;   /* container, NULL for the root */
+    JsonNode   *node;     /* value there, NULL if none */
+    JsonNode   *prev;     /* child of `parent` before the location */
+    size_t      pos;      /* arrays: element index */
+    const char *key;      /* objects: member name */
+} JLoc;
+
+static bool _p_fail(JPatch *p, JunoErrorCode code, const char *msg) {
+    if (p->err.code == JUNO_OK) {
+        p->err.code = code;
+        p->err.msg = msg;
+    }
+    return false;
+}
+
+static JEdit* _log(JPatch *p, uint8_t op) {
+    if (p->log_len == p->log_cap) {
+        size_t cap = p->log_cap ? p->log_cap * 2 : 16;
+        JEdit *l = (JEdit*)realloc(p->log, cap * sizeof(*l));
+        if (!l) {
+            _p_fail(p, JUNO_ERR_OOM, "oom (patch log)");
+            return NULL;
+        }
+        p->log = l;
+        p->log_cap = cap;
+    }
+    JEdit *e = &p->log[p->log_len++];
+    memset(e, 0, sizeof(*e));
+    e->op = op;
+    return e;
+}
+
+static void _link_at(JunoIndex *idx, JsonNode *parent, JsonNode *prev, JsonNode *node, size_t pos) {
+    JsonNode *next = prev ? prev->next_sibling : parent->first_child;
+    node->next_sibling = next;
+    if (prev) prev->next_sibling = node;
+    else parent->first_child = node;
+    if (!next) juno_set_last_child(parent, node);
+    _idx_linked(idx, parent, prev, node, pos);
+}
+
+static void _unlink_at(JunoIndex *idx, JsonNode *parent, JsonNode *prev, JsonNode *node, size_t pos) {
+    JsonNode *next = node->next_sibling;
+    if (prev) prev->next_sibling = next;
+    else parent->first_child = next;
+    if (parent->value.last_child == node) parent->value.last_child = prev;
+    node->next_sibling = NULL;
+    _idx_unlinked(idx, parent, prev, node, next, pos);
+}
+
+static void _rollback(JPatch *p) {
+    while (p->log_len) {
+        JEdit *e = &p->log[--p->log_len];
+        switch (e->op) {
+            case JE_INSERT:
+                _unlink_at(p->idx, e->parent, e->prev, e->node, e->pos);
+                if (e->fresh) {
+                    _idx_forget(p->idx, e->node);
+                    juno_free_ast(e->node);
+                }
+                break;
+            case JE_REMOVE:
+                _link_at(p->idx, e->parent, e->prev, e->node, e->pos);
+                break;
+            case JE_REKEY:
+                _free_key(e->node, e->node->key);
+                e->node->key = e->key;
+                break;
+            case JE_ROOT:
+                if (e->fresh) {
+                    _idx_forget(p->idx, e->parent);
+                    juno_free_ast(e->parent);
+                }
+                *p->root = e->node;
+                break;
+        }
+    }
+}
+
+/* Release what the patch replaced; runs oldest first. */
+static void _commit(JPatch *p) {
+    for (size_t i = 0; i < p->log_len; i++) {
+        JEdit *e = &p->log[i];
+        if ((e->op == JE_REMOVE && !e->moved) || e->op == JE_ROOT) {
+            _idx_forget(p->idx, e->node);
+            juno_free_ast(e->node);
+        } else if (e->op == JE_REKEY) {
+            _free_key(e->node, e->key);
+        }
+    }
+    p->log_len = 0;
+}
+
+static void _p_init(JPatch *p, JunoArena *arena, JsonNode **root, JunoIndex *idx) {
+    memset(p, 0, sizeof(*p));
+    p->arena = arena;
+    p->root = root;
+    p->idx = idx;
+}
+
+static bool _p_begin(JPatch *p, const JsonNode *patch, JArenaMark *mark) {
+    if (!p->root || !patch) return _p_fail(p, JUNO_ERR_INVALID_ARG, "null input");
+    if (*p->root && ((*p->root)->flags & JND_FLAG_ARENA) && !p->arena)
+        return _p_fail(p, JUNO_ERR_INVALID_ARG, "arena tree patched without its arena");
+    if (p->arena) *mark = juno_arena_mark(p->arena);
+    return true;
+}
+
+/* Commit or roll back, report and release the patch state. */
+static bool _p_end(JPatch *p, bool ok, JArenaMark mark, size_t at, JunoError *err) {
+    if (ok) {
+        _commit(p);
+    } else if (p->root) {
+        _rollback(p);
+        /* Everything allocated since `mark` belonged to undone steps. */
+        if (p->arena) juno_arena_rewind(p->arena, mark);
+        p->err.offset = at;
+    }
+    if (err) *err = p->err;
+    free(p->log);
+    free(p->seg);
+    return ok;
+}
+
+/* ------------------------------
+ * JSON Pointer (RFC 6901)
+ * ------------------------------ */
+
+/* Decode the reference token at `s` into p->seg; returns its end (the next
+ * '/' or the terminator), NULL on a bad '~' escape. */
+static const char* _segment(JPatch *p, const char *s) {
+    char *o = p->seg;
+    for (; *s && *s != '/'; s++) {
+        if (*s != '~') {
+            *o++ = *s;
+            continue;
+        }
+        if (s[1] != '0' && s[1] != '1') return NULL;
+        *o++ = (*++s == '0') ? '~' : '/';
+    }
+    *o = '\0';
+    return s;
+}
+
+/* Array index: decimal digits without leading zeros. */
+static bool _index(const char *s, size_t *out) {
+    if (!*s || (s[0] == '0' && s[1])) return false;
+    size_t v = 0;
+    for (; *s; s++) {
+        if (*s < '0' || *s > '9' || v > (SIZE_MAX - 9) / 10) return false;
+        v = v * 10 + (size_t)(*s - '0');
+    }
+    *out = v;
+    return true;
+}
+
+/* Resolve `ptr`. Every step but the last must exist; the last may be absent
+ * when `insert` is set (targets of add / move / copy, "-" for arrays). */
+static bool _resolve(JPatch *p, const char *ptr, bool insert, JLoc *loc) {
+    memset(loc, 0, sizeof(*loc));
+    loc->node = *p->root;
+    if (!*ptr) return loc->node || insert || _p_fail(p, JUNO_ERR_PATH_NOT_FOUND, "path not found");
+    if (*ptr != '/') return _p_fail(p, JUNO_ERR_INVALID_ARG, "malformed JSON Pointer");
+
+    size_t need = strlen(ptr);
+    if (need > p->seg_cap) {
+        char *s = (char*)realloc(p->seg, need);
+        if (!s) return _p_fail(p, JUNO_ERR_OOM, "oom (pointer)");
+        p->seg = s;
+        p->seg_cap = need;
+    }
+
+    const char *s = ptr;
+    while (*s == '/') {
+        if ((s = _segment(p, s + 1)) == NULL) return _p_fail(p, JUNO_ERR_INVALID_ARG, "malformed JSON Pointer");
+        bool last = (*s == '\0');
+
+        JsonNode *cur = loc->node;
+        if (!_is_container(cur)) return _p_fail(p, JUNO_ERR_PATH_NOT_FOUND, "path not found");
+        loc->parent = cur;
+        loc->key = NULL;
+        if (cur->type == JND_ARRAY) {
+            if (last && insert && strcmp(p->seg, "-") == 0) loc->pos = _length(p->idx, cur);
+            else if (!_index(p->seg, &loc->pos)) return _p_fail(p, JUNO_ERR_PATH_NOT_FOUND, "bad array index");
+            if (!_element(p->idx, cur, loc->pos, &loc->node, &loc->prev))
+                return _p_fail(p, JUNO_ERR_PATH_NOT_FOUND, "array index out of range");
+        } else {
+            loc->key = p->seg;
+            loc->node = _member(p->idx, cur, p->seg, &loc->prev);
+        }
+        if (!loc->node && !(last && insert)) return _p_fail(p, JUNO_ERR_PATH_NOT_FOUND, "path not found");
+    }
+
+    /* New members go last. */
+    if (!loc->node && _is_obj(loc->parent)) loc->prev = _last(p->idx, loc->parent);
+    return true;
+}
+
+JsonNode* juno_pointer_get(JunoIndex *idx, const JsonNode *root, const char *ptr) {
+    if (!root || !ptr) return NULL;
+    JsonNode *r = (JsonNode*)root;
+    JPatch p;
+    JLoc loc;
+    _p_init(&p, NULL, &r, idx);
+    JsonNode *n = _resolve(&p, ptr, false, &loc) ? loc.node : NULL;
+    free(p.seg);
+    return n;
+}
+
+/* ------------------------------
+ * Steps
+ * ------------------------------ */
+
+/* Give `node` the member name `key` (NULL: none), allocated like the node.
+ * Nodes created by the patch are renamed without logging. */
+static bool _rekey(JPatch *p, JsonNode *node, const char *key, bool fresh) {
+    if (!key && !node->key) return true;
+
+    char *k = NULL;
+    if (key) {
+        size_t len = strlen(key);
+        k = (node->flags & JND_FLAG_ARENA) ? (char*)juno_arena_alloc(p->arena, len + 1) : (char*)malloc(len + 1);
+        if (!k) return _p_fail(p, JUNO_ERR_OOM, "oom (member name)");
+        memcpy(k, key, len + 1);
+    }
+    if (fresh) {
+        _free_key(node, node->key);
+        node->key = k;
+        return true;
+    }
+
+    JEdit *e = _log(p, JE_REKEY);
+    if (!e) {
+        _free_key(node, k);
+        return false;
+    }
+    e->node = node;
+    e->key = node->key;
+    node->key = k;
+    return true;
+}
+
+/* Unlink the value at `loc`; *entry (may be NULL) receives its log slot. */
+static bool _take(JPatch *p, const JLoc *loc, size_t *entry) {
+    if (!loc->parent) return _p_fail(p, JUNO_ERR_INVALID_ARG, "cannot remove the root");
+    JEdit *e = _log(p, JE_REMOVE);
+    if (!e) return false;
+    _unlink_at(p->idx, loc->parent, loc->prev, loc->node, loc->pos);
+    e->parent = loc->parent;
+    e->prev = loc->prev;
+    e->node = loc->node;
+    e->pos = loc->pos;
+    if (entry) *entry = p->log_len - 1;
+    return true;
+}
+
+/* Store `val` at `loc`: it becomes the root, replaces an object member or
+ * (`replace`) an array element, or is inserted into an array. Takes
+ * ownership of `val` when `fresh`. */
+static bool _put(JPatch *p, const JLoc *loc, JsonNode *val, bool fresh, bool replace) {
+    JEdit *e;
+    if (!loc->parent) {
+        if (!_rekey(p, val, NULL, fresh) || (e = _log(p, JE_ROOT)) == NULL) goto fail;
+        e->node = *p->root;
+        e->parent = val;
+        e->fresh = fresh;
+        *p->root = val;
+        return true;
+    }
+
+    bool is_obj = _is_obj(loc->parent);
+    if (loc->node && (is_obj || replace) && !_take(p, loc, NULL)) goto fail;
+    if (!_rekey(p, val, is_obj ? loc->key : NULL, fresh) || (e = _log(p, JE_INSERT)) == NULL) goto fail;
+    _link_at(p->idx, loc->parent, loc->prev, val, loc->pos);
+    e->parent = loc->parent;
+    e->prev = loc->prev;
+    e->node = val;
+    e->pos = loc->pos;
+    e->fresh = fresh;
+    return true;
+
+fail:
+    if (fresh) juno_free_ast(val);
+    return false;
+}
+
+static bool _put_copy(JPatch *p, const JLoc *loc, const JsonNode *value, bool replace) {
+    JsonNode *n = juno_clone(p->arena, value);
+    if (!n) return _p_fail(p, JUNO_ERR_OOM, "oom (patch value)");
+    return _put(p, loc, n, true, replace);
+}
+
+/* ------------------------------
+ * JSON Patch (RFC 6902)
+ * ------------------------------ */
+
+static const char* _op_str(const JsonNode *op, const char *name) {
+    const JsonNode *v = juno_obj_get(op, name);
+    if (!v || v->type != JND_STRING || (v->flags & JND_FLAG_BINARY)) return NULL;
+    return v->value.svalue;
+}
+
+static bool _move(JPatch *p, const char *from, const char *path) {
+    JLoc loc;
+    if (strcmp(from, path) == 0) return _resolve(p, from, false, &loc);
+
+    size_t n = strlen(from);
+    if (strncmp(path, from, n) == 0 && path[n] == '/')
+        return _p_fail(p, JUNO_ERR_INVALID_ARG, "cannot move a value into itself");
+
+    size_t at;
+    if (!_resolve(p, from, false, &loc) || !_take(p, &loc, &at)) return false;
+    JsonNode *node = loc.node;
+    if (!_resolve(p, path, true, &loc) || !_put(p, &loc, node, false, false)) return false;
+    p->log[at].moved = true;
+    return true;
+}
+
+static bool _apply_op(JPatch *p, const JsonNode *op) {
+    const char *name = _is_obj(op) ? _op_str(op, "op") : NULL;
+    const char *path = name ? _op_str(op, "path") : NULL;
+    if (!path) return _p_fail(p, JUNO_ERR_INVALID_ARG, "malformed patch operation");
+
+    const JsonNode *value = juno_obj_get(op, "value");
+    const char *from = _op_str(op, "from");
+    JLoc loc;
+
+    if (strcmp(name, "add") == 0 || strcmp(name, "replace") == 0) {
+        bool replace = (name[0] == 'r');
+        if (!value) return _p_fail(p, JUNO_ERR_INVALID_ARG, "patch operation without a value");
+        return _resolve(p, path, !replace, &loc) && _put_copy(p, &loc, value, replace);
+    }
+    if (strcmp(name, "remove") == 0) return _resolve(p, path, false, &loc) && _take(p, &loc, NULL);
+    if (strcmp(name, "test") == 0) {
+        if (!value) return _p_fail(p, JUNO_ERR_INVALID_ARG, "patch operation without a value");
+        if (!_resolve(p, path, false, &loc)) return false;
+        return juno_equal(loc.node, value) || _p_fail(p, JUNO_ERR_TEST_FAILED, "test failed");
+    }
+
+    bool copy = strcmp(name, "copy") == 0;
+    if (!copy && strcmp(name, "move") != 0) return _p_fail(p, JUNO_ERR_INVALID_ARG, "unknown patch operation");
+    if (!from) return _p_fail(p, JUNO_ERR_INVALID_ARG, "patch operation without a source");
+    if (!copy) return _move(p, from, path);
+
+    if (!_resolve(p, from, false, &loc)) return false;
+    JsonNode *n = juno_clone(p->arena, loc.node);
+    if (!n) return _p_fail(p, JUNO_ERR_OOM, "oom (patch value)");
+    if (!_resolve(p, path, true, &loc)) {
+        juno_free_ast(n);
+        return false;
+    }
+    return _put(p, &loc, n, true, false);
+}
+
+bool juno_patch_apply(JunoArena *arena, JsonNode **root, const JsonNode *patch,
+                      JunoIndex *idx, JunoError *err) {
+    JPatch p;
+    JArenaMark mark = { NULL, 0 };
+    size_t at = 0;
+    _p_init(&p, arena, root, idx);
+
+    bool ok = _p_begin(&p, patch, &mark);
+    if (ok && patch->type != JND_ARRAY) ok = _p_fail(&p, JUNO_ERR_INVALID_ARG, "patch is not an array");
+    for (const JsonNode *op = ok ? patch->first_child : NULL; op; op = op->next_sibling, at++) {
+        if (!(ok = _apply_op(&p, op))) break;
+    }
+    return _p_end(&p, ok, mark, at, err);
+}
+
+/* ------------------------------
+ * JSON Merge Patch (RFC 7386)
+ * ------------------------------ */
+
+static void _strip_nulls(JsonNode *obj) {
+    if (!_is_obj(obj)) return;
+    JsonNode *prev = NULL, *c = obj->first_child;
+    while (c) {
+        JsonNode *next = c->next_sibling;
+        if (c->type == JND_NULL) {
+            if (prev) prev->next_sibling = next;
+            else obj->first_child = next;
+            if (obj->value.last_child == c) obj->value.last_child = prev;
+            c->next_sibling = NULL;
+            juno_free_ast(c);
+        } else {
+            _strip_nulls(c);
+            prev = c;
+        }
+        c = next;
+    }
+}
+
+/* Copy of patch value `v` as merged into nothing: null members are dropped
+ * through nested objects (arrays are taken verbatim). */
+static JsonNode* _merge_value(JPatch *p, const JsonNode *v) {
+    JsonNode *n = juno_clone(p->arena, v);
+    if (!n) {
+        _p_fail(p, JUNO_ERR_OOM, "oom (patch value)");
+        return NULL;
+    }
+    _strip_nulls(n);
+    return n;
+}
+
+static bool _merge_into(JPatch *p, JsonNode *target, const JsonNode *patch) {
+    for (const JsonNode *m = patch->first_child; m; m = m->next_sibling) {
+        JLoc loc = { target, NULL, NULL, 0, _key(m) };
+        loc.node = _member(p->idx, target, loc.key, &loc.prev);
+
+        if (m->type == JND_NULL) {
+            if (loc.node && !_take(p, &loc, NULL)) return false;
+        } else if (_is_obj(loc.node) && _is_obj(m)) {
+            if (!_merge_into(p, loc.node, m)) return false;
+        } else {
+            if (!loc.node) loc.prev = _last(p->idx, target);
+            JsonNode *v = _merge_value(p, m);
+            if (!v || !_put(p, &loc, v, true, true)) return false;
+        }
+    }
+    return true;
+}
+
+bool juno_merge_patch(JunoArena *arena, JsonNode **root, const JsonNode *patch,
+                      JunoIndex *idx, JunoError *err) {
+    JPatch p;
+    JArenaMark mark = { NULL, 0 };
+    _p_init(&p, arena, root, idx);
+
+    bool ok = _p_begin(&p, patch, &mark);
+    if (ok && _is_obj(patch) && _is_obj(*root)) {
+        ok = _merge_into(&p, *root, patch);
+    } else if (ok) {
+        JLoc loc = { NULL, *root, NULL, 0, NULL };
+        JsonNode *v = _merge_value(&p, patch);
+        ok = v && _put(&p, &loc, v, true, true);
+    }
+    return _p_end(&p, ok, mark, 0, err);
+}
+
+/* ------------------------------
+ * Diff
+ * ------------------------------ */
+
+typedef struct {
+    JunoArena *arena;
+    JunoIndex *idx;     /* member lookups in both trees */
+    JsonNode  *ops;
+    char      *path;    /* JSON Pointer of the values being compared */
+    size_t     len, cap;
+} JDiff;
+
+static bool _d_reserve(JDiff *d, size_t extra) {
+    if (d->len + extra + 1 <= d->cap) return true;
+    size_t cap = d->cap ? d->cap : 64;
+    while (cap < d->len + extra + 1) cap *= 2;
+    char *s = (char*)realloc(d->path, cap);
+    if (!s) return false;
+    d->path = s;
+    d->cap = cap;
+    return true;
+}
+
+static bool _d_key(JDiff *d, const char *key) {
+    if (!_d_reserve(d, 2 * strlen(key) + 1)) return false;
+    d->path[d->len++] = '/';
+    for (; *key; key++) {
+        if (*key == '~' || *key == '/') {
+            d->path[d->len++] = '~';
+            d->path[d->len++] = (*key == '~') ? '0' : '1';
+        } else {
+            d->path[d->len++] = *key;
+        }
+    }
+    d->path[d->len] = '\0';
+    return true;
+}
+
+static bool _d_index(JDiff *d, size_t i) {
+    if (!_d_reserve(d, 24)) return false;
+    d->len += (size_t)snprintf(d->path + d->len, 24, "/%zu", i);
+    return true;
+}
+
+static void _d_pop(JDiff *d, size_t len) {
+    d->len = len;
+    d->path[len] = '\0';
+}
+
+static bool _d_member(JDiff *d, JsonNode *op, const char *key, JsonNode *val) {
+    if (!val) return false;
+    if (juno_obj_append(d->arena, op, key, val)) return true;
+    juno_free_ast(val);
+    return false;
+}
+
+/* Append {"op": name, "path": <current path>[, "value": value]}. */
+static bool _d_op(JDiff *d, const char *name, const JsonNode *value) {
+    JsonNode *op = juno_new_object(d->arena);
+    if (!op) return false;
+    if (_d_member(d, op, "op", juno_new_string(d->arena, name, strlen(name))) &&
+        _d_member(d, op, "path", juno_new_string(d->arena, d->path, d->len)) &&
+        (!value || _d_member(d, op, "value", juno_clone(d->arena, value))) &&
+        juno_array_append(d->ops, op))
+        return true;
+    juno_free_ast(op);
+    return false;
+}
+
+static bool _diff(JDiff *d, const JsonNode *a, const JsonNode *b);
+
+static bool _diff_obj(JDiff *d, const JsonNode *a, const JsonNode *b) {
+    size_t len = d->len;
+    JsonNode *prev;
+    for (const JsonNode *m = a->first_child; m; m = m->next_sibling) {
+        const JsonNode *o = _member(d->idx, (JsonNode*)b, _key(m), &prev);
+        bool ok = _d_key(d, _key(m)) && (o ? _diff(d, m, o) : _d_op(d, "remove", NULL));
+        _d_pop(d, len);
+        if (!ok) return false;
+    }
+    for (const JsonNode *m = b->first_child; m; m = m->next_sibling) {
+        if (_member(d->idx, (JsonNode*)a, _key(m), &prev)) continue;
+        bool ok = _d_key(d, _key(m)) && _d_op(d, "add", m);
+        _d_pop(d, len);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+static const JsonNode** _children(const JsonNode *c, size_t *n) {
+    *n = 0;
+    for (const JsonNode *ch = c->first_child; ch; ch = ch->next_sibling) (*n)++;
+    const JsonNode **v = (const JsonNode**)malloc((*n ? *n : 1) * sizeof(*v));
+    if (!v) return NULL;
+    size_t i = 0;
+    for (const JsonNode *ch = c->first_child; ch; ch = ch->next_sibling) v[i++] = ch;
+    return v;
+}
+
+static bool _diff_arr(JDiff *d, const JsonNode *a, const JsonNode *b) {
+    size_t na, nb;
+    const JsonNode **va = _children(a, &na), **vb = _children(b, &nb);
+    bool ok = va && vb;
+
+    size_t pre = 0, suf = 0;
+    while (ok && pre < na && pre < nb && juno_equal(va[pre], vb[pre])) pre++;
+    while (ok && suf < na - pre && suf < nb - pre && juno_equal(va[na - 1 - suf], vb[nb - 1 - suf])) suf++;
+
+    /* a[pre, pre+m) becomes b[pre, pre+k): pair up, then delete or insert the rest. */
+    size_t m = na - pre - suf, k = nb - pre - suf, common = m < k ? m : k, len = d->len;
+    for (size_t i = 0; ok && i < common; i++) {
+        ok = _d_index(d, pre + i) && _diff(d, va[pre + i], vb[pre + i]);
+        _d_pop(d, len);
+    }
+    for (size_t i = common; ok && i < m; i++) {
+        ok = _d_index(d, pre + common) && _d_op(d, "remove", NULL);
+        _d_pop(d, len);
+    }
+    for (size_t i = common; ok && i < k; i++) {
+        ok = _d_index(d, pre + i) && _d_op(d, "add", vb[pre + i]);
+        _d_pop(d, len);
+    }
+    free(va);
+    free(vb);
+    return ok;
+}
+
+static bool _diff(JDiff *d, const JsonNode *a, const JsonNode *b) {
+    if (_is_obj(a) && _is_obj(b)) return _diff_obj(d, a, b);
+    if (a->type == JND_ARRAY && b->type == JND_ARRAY) return _diff_arr(d, a, b);
+    return juno_equal(a, b) || _d_op(d, "replace", b);
+}
+
+JsonNode* juno_diff(JunoArena *arena, const JsonNode *from, const JsonNode *to, JunoError *err) {
+    if (err) memset(err, 0, sizeof(*err));
+    if (!from || !to) {
+        if (err) {
+            err->code = JUNO_ERR_INVALID_ARG;
+            err->msg = "null input";
+        }
+        return NULL;
+    }
+
+    JArenaMark mark = { NULL, 0 };
+    if (arena) mark = juno_arena_mark(arena);
+
+    JDiff d = { arena, juno_index_new(), juno_new_array(arena), NULL, 0, 0 };
+    bool ok = d.idx && d.ops && _d_reserve(&d, 0);
+    if (ok) {
+        d.path[0] = '\0';
+        ok = _diff(&d, from, to);
+    }
+    juno_index_free(d.idx);
+    free(d.path);
+    if (ok) return d.ops;
+
+    juno_free_ast(d.ops);
+    if (arena) juno_arena_rewind(arena, mark);
+    if (err) {
+        err->code = JUNO_ERR_OOM;
+        err->msg = "oom (diff)";
+    }
+    return NULL;
+}
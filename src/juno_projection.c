@@ -0,0 +1,326 @@
+#include "internal/juno_internal.h"
+
+#include <juno/projection.h>
+
+/* ------------------------------
+ * Projection trie
+ * ------------------------------ */
+
+typedef struct JProjNode {
+    char             *key;        /* member name (NULL for the root and "[*]" nodes) */
+    size_t            key_len;
+    struct JProjNode *children;   /* member names below this node */
+    struct JProjNode *next;       /* next sibling in the parent's children list */
+    struct JProjNode *elems;      /* "[*]": every element of an array */
+    bool              leaf;       /* a path ends here: keep the whole subtree */
+} JProjNode;
+
+struct JunoProjection {
+    JProjNode root;
+};
+
+static void _proj_free_children(JProjNode *pn) {
+    JProjNode *c = pn->children;
+    while (c) {
+        JProjNode *next = c->next;
+        _proj_free_children(c);
+        free(c->key);
+        free(c);
+        c = next;
+    }
+    if (pn->elems) {
+        _proj_free_children(pn->elems);
+        free(pn->elems);
+    }
+}
+
+void juno_projection_free(JunoProjection *proj) {
+    if (!proj) return;
+    _proj_free_children(&proj->root);
+    free(proj);
+}
+
+static JProjNode* _proj_child(JProjNode *pn, const char *key, size_t key_len) {
+    for (JProjNode *c = pn->children; c; c = c->next) {
+        if (c->key_len == key_len && memcmp(c->key, key, key_len) == 0) return c;
+    }
+
+    JProjNode *c = (JProjNode*)calloc(1, sizeof(JProjNode));
+    if (!c) return NULL;
+    c->key = (char*)malloc(key_len + 1);
+    if (!c->key) {
+        free(c);
+        return NULL;
+    }
+    memcpy(c->key, key, key_len);
+    c->key[key_len] = '\0';
+    c->key_len = key_len;
+    c->next = pn->children;
+    pn->children = c;
+    return c;
+}
+
+static JProjNode* _proj_elems(JProjNode *pn) {
+    if (!pn->elems) pn->elems = (JProjNode*)calloc(1, sizeof(JProjNode));
+    return pn->elems;
+}
+
+/* Add one path to the trie. Returns NULL on success or a pointer to the
+ * offending byte; *oom is set when an allocation failed. */
+static const char* _proj_add_path(JunoProjection *proj, const char *path, bool *oom) {
+    JProjNode *pn = &proj->root;
+    const char *p = path;
+
+    while (*p) {
+        if (*p == '[') {
+            if (strncmp(p, "[*]", 3) != 0) return p;
+            p += 3;
+            pn = _proj_elems(pn);
+        } else {
+            const char *name = p;
+            while (*p && *p != '.' && *p != '[') p++;
+            if (p == name) return p;
+            pn = _proj_child(pn, name, (size_t)(p - name));
+        }
+        if (!pn) {
+            *oom = true;
+            return p;
+        }
+
+        if (*p == '.') {
+            p++;
+            if (*p == '\0' || *p == '.' || *p == '[') return p;
+        }
+    }
+
+    pn->leaf = true;
+    return NULL;
+}
+
+JunoProjection* juno_projection_new(const char *const *paths, size_t n, JunoError *err) {
+    if (err) memset(err, 0, sizeof(*err));
+    if (!paths && n) {
+        if (err) err->code = JUNO_ERR_INVALID_ARG;
+        return NULL;
+    }
+
+    JunoProjection *proj = (JunoProjection*)calloc(1, sizeof(JunoProjection));
+    if (!proj) {
+        if (err) err->code = JUNO_ERR_OOM;
+        return NULL;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        bool oom = false;
+        const char *bad = paths[i] ? _proj_add_path(proj, paths[i], &oom) : "";
+        if (bad) {
+            if (err) {
+                err->code = oom ? JUNO_ERR_OOM : JUNO_ERR_INVALID_ARG;
+                err->msg = oom ? "oom (projection)" : "invalid projection path";
+                err->offset = paths[i] ? (size_t)(bad - paths[i]) : 0;
+                err->depth = (unsigned)i;
+            }
+            juno_projection_free(proj);
+            return NULL;
+        }
+    }
+    return proj;
+}
+
+/* ------------------------------
+ * Projected parsing
+ * ------------------------------ */
+
+/* Returned by _proj_value when the value was skipped (not an error). */
+static JsonNode _skipped;
+#define JPROJ_SKIPPED (&_skipped)
+
+static JsonNode* _proj_value(JParser *ps, const JProjNode *pn, unsigned short depth);
+
+static JsonNode* _proj_skip(JParser *ps, unsigned short depth) {
+    JLexer *lx = &ps->lx;
+    unsigned budget = JUNO_MAX_NESTING > depth ? (unsigned)(JUNO_MAX_NESTING - depth) : 0;
+
+    switch (jl_skip_value(lx, budget)) {
+        case JL_SKIP_OK:      return JPROJ_SKIPPED;
+        case JL_SKIP_EOF:     return juno_fail(ps, JUNO_ERR_UNEXPECTED_EOF, NULL, NULL, depth);
+        case JL_SKIP_NESTING: return juno_fail(ps, JUNO_ERR_NESTING, NULL, NULL, depth + budget + 1);
+        default:              break;
+    }
+
+    /* Cold path: lex the offending token again so the code and message match
+     * what juno_parse reports for the same input. */
+    JToken tok = jl_next(lx);
+    if (tok.type == JTK_ERROR) return juno_fail(ps, juno_lex_error_code(&tok), tok.err_msg, tok.start, depth);
+    if (tok.type == JTK_STRING) {
+        const char *err_msg = NULL;
+        char *s = jl_string_to_utf8(&tok, &err_msg);
+        if (!s) return juno_fail(ps, JUNO_ERR_INVALID_STRING, err_msg, tok.start, depth);
+        free(s);
+    }
+    return juno_fail(ps, juno_lex_error_code(&tok), "unexpected token in skipped value", tok.start, depth);
+}
+
+/* Find the projected member for a raw key token; escaped keys are decoded. */
+static const JProjNode* _proj_match(JParser *ps, const JProjNode *pn, const JToken *tok,
+                                    unsigned short depth, bool *failed) {
+    const char *key = tok->start + 1;
+    size_t key_len = tok->length - 2;
+    char *decoded = NULL;
+
+    if (memchr(key, '\\', key_len)) {
+        const char *err_msg = NULL;
+        decoded = jl_string_to_utf8(tok, &err_msg);
+        if (!decoded) {
+            juno_fail(ps, JUNO_ERR_INVALID_STRING, err_msg, tok->start, depth);
+            *failed = true;
+            return NULL;
+        }
+        key = decoded;
+        key_len = strlen(decoded);
+    }
+
+    const JProjNode *c;
+    for (c = pn->children; c; c = c->next) {
+        if (c->key_len == key_len && memcmp(c->key, key, key_len) == 0) break;
+    }
+    free(decoded);
+    return c;
+}
+
+static JsonNode* _proj_obj(JParser *ps, const JProjNode *pn, unsigned short depth) {
+    if (depth > JUNO_MAX_NESTING) return juno_fail(ps, JUNO_ERR_NESTING, NULL, NULL, depth);
+
+    JToken tok = juno_ps_next(ps);
+    JsonNode *obj = juno_ps_node(ps, JND_OBJ, tok.start, depth);
+    JsonNode *tail = NULL;
+    if (!obj) return juno_fail(ps, JUNO_ERR_OOM, "oom (object)", tok.start, depth);
+
+    int first = 1;
+    while (1) {
+        tok = juno_ps_next(ps);
+        if (tok.type == JTK_RBRACE) break;
+
+        if (!first) {
+            if (tok.type != JTK_COMMA) {
+                juno_fail(ps, juno_lex_error_code(&tok), tok.type == JTK_ERROR ? tok.err_msg : "expected ',' between object properties", tok.start, depth);
+                goto error;
+            }
+            tok = juno_ps_next(ps);
+        }
+        first = 0;
+
+        if (tok.type != JTK_STRING) {
+            juno_fail(ps, juno_lex_error_code(&tok), tok.type == JTK_ERROR ? tok.err_msg : "expected string as object key", tok.start, depth);
+            goto error;
+        }
+
+        bool failed = false;
+        const JProjNode *child = _proj_match(ps, pn, &tok, depth, &failed);
+        if (failed) goto error;
+
+        tok = juno_ps_next(ps);
+        if (tok.type != JTK_COLON) {
+            juno_fail(ps, juno_lex_error_code(&tok), tok.type == JTK_ERROR ? tok.err_msg : "expected ':' after object key", tok.start, depth);
+            goto error;
+        }
+
+        JsonNode *val = child ? _proj_value(ps, child, depth) : _proj_skip(ps, depth);
+        if (!val) goto error;
+        if (val == JPROJ_SKIPPED) continue;
+
+        val->key = juno_ps_strdup(ps, child->key, child->key_len, depth);
+        if (!val->key) {
+            juno_free_ast(val);
+            juno_fail(ps, JUNO_ERR_OOM, "oom (key)", NULL, depth);
+            goto error;
+        }
+
+        if (tail) tail->next_sibling = val;
+        else obj->first_child = val;
+        tail = val;
+    }
+
+    juno_set_last_child(obj, tail);
+    return obj;
+
+error:
+    juno_free_ast(obj);
+    return NULL;
+}
+
+static JsonNode* _proj_array(JParser *ps, const JProjNode *pn, unsigned short depth) {
+    JLexer *lx = &ps->lx;
+    if (depth > JUNO_MAX_NESTING) return juno_fail(ps, JUNO_ERR_NESTING, NULL, NULL, depth);
+
+    JToken tok = juno_ps_next(ps);
+    JsonNode *array = juno_ps_node(ps, JND_ARRAY, tok.start, depth);
+    JsonNode *tail = NULL;
+    if (!array) return juno_fail(ps, JUNO_ERR_OOM, "oom (array)", tok.start, depth);
+
+    jl_skip_ws(lx);
+    if (jl_peek(lx) == ']') {
+        (void)juno_ps_next(ps);
+        return array;
+    }
+
+    while (1) {
+        JsonNode *val = _proj_value(ps, pn, depth);
+        if (!val) goto error;
+
+        if (val != JPROJ_SKIPPED) {
+            if (tail) tail->next_sibling = val;
+            else array->first_child = val;
+            tail = val;
+        }
+
+        tok = juno_ps_next(ps);
+        if (tok.type == JTK_RBRACK) break;
+        if (tok.type == JTK_COMMA) continue;
+
+        juno_fail(ps, juno_lex_error_code(&tok), tok.type == JTK_ERROR ? tok.err_msg : "expected ',' or ']' while parsing array", tok.start, depth);
+        goto error;
+    }
+
+    juno_set_last_child(array, tail);
+    return array;
+
+error:
+    juno_free_ast(array);
+    return NULL;
+}
+
+static JsonNode* _proj_value(JParser *ps, const JProjNode *pn, unsigned short depth) {
+    if (pn->leaf) return juno_parse_value(ps, depth);
+
+    JLexer *lx = &ps->lx;
+    jl_skip_ws(lx);
+    char c = jl_peek(lx);
+    if (c == '{' && pn->children) return _proj_obj(ps, pn, (unsigned short)(depth + 1));
+    if (c == '[' && pn->elems) return _proj_array(ps, pn->elems, (unsigned short)(depth + 1));
+    return _proj_skip(ps, depth);
+}
+
+JsonNode* juno_parse_projected(const char *json_str, size_t len,
+                               const JunoProjection *proj, JunoError *err) {
+    if (!proj) return juno_parse_ex(json_str, len, err);
+    if (!json_str) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_INVALID_ARG;
+            err->msg = "null input";
+        }
+        return NULL;
+    }
+
+    JParser ps;
+    juno_parser_init(&ps, json_str, len);
+
+    JsonNode *root = _proj_value(&ps, &proj->root, 0);
+    if (root == JPROJ_SKIPPED) {
+        root = juno_ps_node(&ps, JND_NULL, NULL, 0);
+        if (!root) juno_fail(&ps, JUNO_ERR_OOM, "oom (null)", NULL, 0);
+    }
+    if (err) *err = ps.err;
+    return root;
+}
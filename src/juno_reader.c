@@ -0,0 +1,649 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "internal/juno_internal.h"
+
+#include <juno/reader.h>
+
+#include <errno.h>
+#include <unistd.h>
+
+/* ------------------------------
+ * Reader state
+ * ------------------------------ */
+
+typedef enum {
+    RS_VALUE,       /* expecting a value (top level, after ':' or after ',' in an array) */
+    RS_ARR_FIRST,   /* after '[': value or ']' */
+    RS_OBJ_FIRST,   /* after '{': key or '}' */
+    RS_OBJ_KEY,     /* after ',' in an object: key */
+    RS_OBJ_COLON,   /* after a key: ':' */
+    RS_AFTER_VALUE, /* after a member/element: ',' or the closing bracket */
+    RS_DOC_END,     /* top-level value completed, JEV_DOC_END pending */
+    RS_EOF,
+    RS_ERROR
+} JReaderState;
+
+struct JunoReader {
+    JunoReadFn read_fn;
+    void      *ud;
+
+    char   *buf;        /* input window */
+    size_t  cap;
+    size_t  pos;        /* next unread byte in buf */
+    size_t  fill;       /* valid bytes in buf */
+    size_t  base;       /* absolute stream offset of buf[0] */
+    bool    eof;
+    bool    owns_buf;
+    bool    no_decode;  /* skipping or reformatting: strings are checked, not decoded */
+
+    size_t  str_part;   /* max decoded bytes per string event, 0: whole strings */
+    bool    in_string;  /* a string value is being delivered in parts */
+    size_t  str_offset; /* absolute offset of its opening quote */
+
+    char   *scratch;    /* decoded string of the current event */
+    size_t  scratch_cap;
+
+    JReaderState state;
+    unsigned     depth;
+    bool         is_obj[JUNO_MAX_NESTING + 1];
+
+    JunoError err;
+};
+
+/* ------------------------------
+ * Input sources
+ * ------------------------------ */
+
+static ptrdiff_t _read_fd(void *ud, char *buf, size_t cap) {
+    int fd = (int)(intptr_t)ud;
+    for (;;) {
+        ssize_t n = read(fd, buf, cap);
+        if (n < 0 && errno == EINTR) continue;
+        return (ptrdiff_t)n;
+    }
+}
+
+static ptrdiff_t _read_stdio(void *ud, char *buf, size_t cap) {
+    FILE *fp = (FILE*)ud;
+    size_t n = fread(buf, 1, cap, fp);
+    if (n == 0 && ferror(fp)) return -1;
+    return (ptrdiff_t)n;
+}
+
+JunoReader* juno_reader_new_cb(JunoReadFn read_fn, void *ud, size_t bufsize) {
+    if (!read_fn) return NULL;
+    if (bufsize == 0) bufsize = JUNO_READER_DEFAULT_BUFSIZE;
+
+    JunoReader *r = (JunoReader*)calloc(1, sizeof(JunoReader));
+    if (!r) return NULL;
+    r->buf = (char*)malloc(bufsize);
+    if (!r->buf) {
+        free(r);
+        return NULL;
+    }
+    r->read_fn = read_fn;
+    r->ud = ud;
+    r->cap = bufsize;
+    r->owns_buf = true;
+    r->state = RS_VALUE;
+    return r;
+}
+
+JunoReader* juno_reader_new_fd(int fd, size_t bufsize) {
+    if (fd < 0) return NULL;
+    return juno_reader_new_cb(_read_fd, (void*)(intptr_t)fd, bufsize);
+}
+
+JunoReader* juno_reader_new_file(FILE *fp, size_t bufsize) {
+    if (!fp) return NULL;
+    return juno_reader_new_cb(_read_stdio, fp, bufsize);
+}
+
+JunoReader* juno_reader_new_mem(const char *data, size_t len) {
+    if (!data) return NULL;
+
+    JunoReader *r = (JunoReader*)calloc(1, sizeof(JunoReader));
+    if (!r) return NULL;
+    r->buf = (char*)data;
+    r->cap = len;
+    r->fill = len;
+    r->eof = true;
+    r->state = RS_VALUE;
+    return r;
+}
+
+void juno_reader_free(JunoReader *r) {
+    if (!r) return;
+    if (r->owns_buf) free(r->buf);
+    free(r->scratch);
+    free(r);
+}
+
+const JunoError* juno_reader_error(const JunoReader *r) {
+    return r ? &r->err : NULL;
+}
+
+/* ------------------------------
+ * Window management
+ * ------------------------------ */
+
+static JunoEventType _reader_fail(JunoReader *r, JunoErrorCode code, const char *msg, size_t offset) {
+    if (r->state != RS_ERROR) {
+        r->err.code = code;
+        r->err.msg = msg ? msg : juno_error_str(code);
+        r->err.offset = offset;
+        r->err.depth = r->depth;
+        r->state = RS_ERROR;
+    }
+    return JEV_ERROR;
+}
+
+/* Move the unread tail to the front of the window and read more input. */
+static bool _refill(JunoReader *r) {
+    if (r->pos > 0) {
+        memmove(r->buf, r->buf + r->pos, r->fill - r->pos);
+        r->base += r->pos;
+        r->fill -= r->pos;
+        r->pos = 0;
+    }
+
+    ptrdiff_t n = r->read_fn(r->ud, r->buf + r->fill, r->cap - r->fill);
+    if (n < 0) {
+        _reader_fail(r, JUNO_ERR_IO, "read failed", r->base + r->fill);
+        return false;
+    }
+    if (n == 0) r->eof = true;
+    else r->fill += (size_t)n;
+    return true;
+}
+
+/* Tokens that may continue past the end of the window (numbers, literals and
+ * anything the lexer rejected because it ran out of input). */
+static bool _may_continue(JTokenType type) {
+    return type == JTK_NUMBER || type == JTK_TRUE || type == JTK_FALSE ||
+           type == JTK_NULL || type == JTK_ERROR;
+}
+
+static bool _next_token(JunoReader *r, JToken *tok) {
+    for (;;) {
+        JLexer lx;
+        jl_init(&lx, r->buf + r->pos, r->fill - r->pos);
+        jl_skip_ws(&lx);
+        r->pos = (size_t)(lx.p - r->buf);
+
+        if (jl_at_end(&lx)) {
+            if (r->eof) {
+                *tok = jl_next(&lx);
+                return true;
+            }
+            if (!_refill(r)) return false;
+            continue;
+        }
+
+        JToken t = jl_next(&lx);
+        if (lx.p == lx.end && !r->eof && _may_continue(t.type)) {
+            if (r->pos == 0 && r->fill == r->cap) {
+                _reader_fail(r, JUNO_ERR_TOKEN_TOO_LARGE, NULL, r->base);
+                return false;
+            }
+            if (!_refill(r)) return false;
+            continue;
+        }
+
+        r->pos = (size_t)(lx.p - r->buf);
+        *tok = t;
+        return true;
+    }
+}
+
+/* ------------------------------
+ * Event generation
+ * ------------------------------ */
+
+static size_t _tok_offset(const JunoReader *r, const JToken *tok) {
+    return r->base + (size_t)(tok->start - r->buf);
+}
+
+static JunoEventType _fail_tok(JunoReader *r, const JToken *tok, const char *msg) {
+    return _reader_fail(r, juno_lex_error_code(tok),
+                        tok->type == JTK_ERROR ? tok->err_msg : msg,
+                        _tok_offset(r, tok));
+}
+
+/* Make room for `n` decoded bytes in scratch. */
+static bool _reserve(JunoReader *r, size_t n, size_t offset) {
+    if (n <= r->scratch_cap) return true;
+    size_t cap = r->scratch_cap ? r->scratch_cap : 256;
+    while (cap < n) cap *= 2;
+    char *nb = (char*)realloc(r->scratch, cap);
+    if (!nb) {
+        _reader_fail(r, JUNO_ERR_OOM, "oom (string)", offset);
+        return false;
+    }
+    r->scratch = nb;
+    r->scratch_cap = cap;
+    return true;
+}
+
+static bool _decode(JunoReader *r, const JToken *tok, JunoEvent *ev) {
+    size_t n = tok->length - 2;
+    const char *err_msg = NULL;
+    if (r->no_decode) {
+        if (jl_check_string(tok->start + 1, n, &err_msg)) return true;
+        _reader_fail(r, JUNO_ERR_INVALID_STRING, err_msg, _tok_offset(r, tok));
+        return false;
+    }
+
+    if (!_reserve(r, n + 1, _tok_offset(r, tok))) return false;
+    if (!jl_decode_string_into(tok->start + 1, n, r->scratch, &ev->str_len, &err_msg)) {
+        _reader_fail(r, JUNO_ERR_INVALID_STRING, err_msg, _tok_offset(r, tok));
+        return false;
+    }
+    ev->str = r->scratch;
+    return true;
+}
+
+static void _after_value(JunoReader *r) {
+    r->state = (r->depth == 0) ? RS_DOC_END : RS_AFTER_VALUE;
+}
+
+static JunoEventType _open(JunoReader *r, JunoEvent *ev, bool is_obj, const JToken *tok) {
+    if (r->depth + 1 > JUNO_MAX_NESTING)
+        return _reader_fail(r, JUNO_ERR_NESTING, NULL, _tok_offset(r, tok));
+    r->depth++;
+    r->is_obj[r->depth] = is_obj;
+    r->state = is_obj ? RS_OBJ_FIRST : RS_ARR_FIRST;
+    ev->depth = r->depth;
+    return ev->type = is_obj ? JEV_OBJ_BEGIN : JEV_ARR_BEGIN;
+}
+
+static JunoEventType _close(JunoReader *r, JunoEvent *ev) {
+    ev->type = r->is_obj[r->depth] ? JEV_OBJ_END : JEV_ARR_END;
+    ev->depth = r->depth;
+    r->depth--;
+    _after_value(r);
+    return ev->type;
+}
+
+static JunoEventType _value(JunoReader *r, const JToken *tok, JunoEvent *ev) {
+    ev->depth = r->depth;
+    switch (tok->type) {
+        case JTK_LBRACE: return _open(r, ev, true, tok);
+        case JTK_LBRACK: return _open(r, ev, false, tok);
+        case JTK_STRING:
+            if (!_decode(r, tok, ev)) return JEV_ERROR;
+            ev->type = JEV_STRING;
+            break;
+        case JTK_NUMBER:
+            ev->type = JEV_NUMBER;
+            break;
+        case JTK_TRUE:
+        case JTK_FALSE:
+            ev->type = JEV_BOOL;
+            ev->bvalue = (tok->type == JTK_TRUE);
+            break;
+        case JTK_NULL:
+            ev->type = JEV_NULL;
+            break;
+        default:
+            return _fail_tok(r, tok, "unexpected token while parsing value");
+    }
+    _after_value(r);
+    return ev->type;
+}
+
+/* ------------------------------
+ * Strings in parts
+ * ------------------------------ */
+
+#define JREADER_MIN_PART 16
+
+bool juno_reader_set_decode(JunoReader *r, bool decode) {
+    bool was = !r->no_decode;
+    r->no_decode = !decode;
+    return was;
+}
+
+void juno_reader_set_string_parts(JunoReader *r, size_t max_part) {
+    if (!r) return;
+    if (max_part && max_part < JREADER_MIN_PART) max_part = JREADER_MIN_PART;
+    /* Keep half the window free to carry an escape over a refill. */
+    if (max_part && r->owns_buf && max_part > r->cap / 2) max_part = r->cap / 2;
+    r->str_part = max_part;
+}
+
+/* Skip whitespace; true if the next value is a string. */
+static bool _at_string(JunoReader *r) {
+    for (;;) {
+        while (r->pos < r->fill) {
+            char c = r->buf[r->pos];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') return c == '"';
+            r->pos++;
+        }
+        if (r->eof || !_refill(r)) return false;
+    }
+}
+
+/* Source length of the escape at `q`: a high surrogate takes its low half
+ * along, so the pair is never split. May exceed what the window holds. */
+static size_t _escape_len(const char *q, const char *end) {
+    if (end - q < 2 || q[1] != 'u') return 2;
+    if (end - q < 4) return 6;
+    bool high = (q[2] == 'd' || q[2] == 'D') &&
+                (q[3] == '8' || q[3] == '9' || q[3] == 'a' || q[3] == 'b' || q[3] == 'A' || q[3] == 'B');
+    return high ? 12 : 6;
+}
+
+/* Deliver the next part of the string value at r->pos: JEV_STRING_PART while
+ * more follows, JEV_STRING for the last one. A part ends before an escape or
+ * UTF-8 sequence that does not fit, so each one decodes on its own. */
+static JunoEventType _string_part(JunoReader *r, JunoEvent *ev) {
+    if (!r->in_string) r->str_offset = r->base + r->pos;
+
+    for (;;) {
+        size_t from = r->pos + (r->in_string ? 0 : 1);
+        const char *p = r->buf + from, *end = r->buf + r->fill, *q = p;
+        const char *limit = ((size_t)(end - p) > r->str_part) ? p + r->str_part : end;
+        bool closed = false, split = false;
+
+        while (q < limit) {
+            if (*q == '"') {
+                closed = true;
+                break;
+            }
+            if (*q != '\\') {
+                q++;
+                continue;
+            }
+            size_t need = _escape_len(q, end);
+            if (need > (size_t)(end - q)) {
+                split = true;
+                break;
+            }
+            if (q + need > limit && q > p) break;
+            q += need;
+        }
+
+        if (!closed && (split || q == end) && !r->eof) {
+            /* Window exhausted before a full part: read more first. */
+            if (r->pos > 0 || r->fill < r->cap) {
+                if (!_refill(r)) return JEV_ERROR;
+                continue;
+            }
+            if (q == p) return _reader_fail(r, JUNO_ERR_TOKEN_TOO_LARGE, NULL, r->base);
+        }
+        if (split && r->eof) q = end;   /* truncated escape: let decode report it */
+        if (!closed && q < end) {
+            /* Do not cut a UTF-8 sequence in two. */
+            const char *cut = q;
+            for (int k = 0; k < 3 && cut > p && ((unsigned char)*cut & 0xC0) == 0x80; k++) cut--;
+            if (cut > p) q = cut;
+        }
+
+        size_t n = (size_t)(q - p);
+        const char *err_msg = NULL;
+        if (r->no_decode) {
+            if (!jl_check_string(p, n, &err_msg))
+                return _reader_fail(r, JUNO_ERR_INVALID_STRING, err_msg, r->str_offset);
+        } else {
+            if (!_reserve(r, n + 1, r->str_offset)) return JEV_ERROR;
+            if (!jl_decode_string_into(p, n, r->scratch, &ev->str_len, &err_msg))
+                return _reader_fail(r, JUNO_ERR_INVALID_STRING, err_msg, r->str_offset);
+            ev->str = r->scratch;
+        }
+        if (!closed && q == end && r->eof)
+            return _reader_fail(r, JUNO_ERR_INVALID_STRING, "unterminated string", r->str_offset);
+
+        ev->depth = r->depth;
+        if (closed && !r->in_string) {
+            ev->offset = r->str_offset;
+            ev->raw = r->buf + r->pos;
+            ev->raw_len = n + 2;
+        } else {
+            ev->offset = r->base + from;
+            ev->raw = p;
+            ev->raw_len = n;
+        }
+        r->pos = (size_t)(q - r->buf) + (closed ? 1 : 0);
+        if (!closed) {
+            r->in_string = true;
+            return ev->type = JEV_STRING_PART;
+        }
+        r->in_string = false;
+        _after_value(r);
+        return ev->type = JEV_STRING;
+    }
+}
+
+JunoEventType juno_reader_next(JunoReader *r, JunoEvent *ev) {
+    memset(ev, 0, sizeof(*ev));
+    if (!r) return JEV_ERROR;
+
+    for (;;) {
+        switch (r->state) {
+            case RS_ERROR:
+                ev->offset = r->err.offset;
+                return ev->type = JEV_ERROR;
+            case RS_EOF:
+                ev->offset = r->base + r->fill;
+                return ev->type = JEV_EOF;
+            case RS_DOC_END:
+                r->state = RS_VALUE;
+                ev->offset = r->base + r->pos;
+                return ev->type = JEV_DOC_END;
+            default:
+                break;
+        }
+
+        if (r->str_part && (r->in_string ||
+                            ((r->state == RS_VALUE || r->state == RS_ARR_FIRST) && _at_string(r))))
+            return _string_part(r, ev);
+        if (r->state == RS_ERROR) continue;
+
+        JToken tok;
+        if (!_next_token(r, &tok)) return ev->type = JEV_ERROR;
+
+        ev->offset = _tok_offset(r, &tok);
+        ev->raw = tok.start;
+        ev->raw_len = tok.length;
+
+        switch (r->state) {
+            case RS_VALUE:
+                if (r->depth == 0 && tok.type == JTK_EOF) {
+                    r->state = RS_EOF;
+                    return ev->type = JEV_EOF;
+                }
+                return _value(r, &tok, ev);
+
+            case RS_ARR_FIRST:
+                if (tok.type == JTK_RBRACK) return _close(r, ev);
+                return _value(r, &tok, ev);
+
+            case RS_OBJ_FIRST:
+                if (tok.type == JTK_RBRACE) return _close(r, ev);
+                /* fall through */
+            case RS_OBJ_KEY:
+                if (tok.type != JTK_STRING) return _fail_tok(r, &tok, "expected string as object key");
+                if (!_decode(r, &tok, ev)) return ev->type = JEV_ERROR;
+                r->state = RS_OBJ_COLON;
+                ev->depth = r->depth;
+                return ev->type = JEV_KEY;
+
+            case RS_OBJ_COLON:
+                if (tok.type != JTK_COLON) return _fail_tok(r, &tok, "expected ':' after object key");
+                r->state = RS_VALUE;
+                continue;
+
+            case RS_AFTER_VALUE: {
+                bool is_obj = r->is_obj[r->depth];
+                if (tok.type == JTK_COMMA) {
+                    r->state = is_obj ? RS_OBJ_KEY : RS_VALUE;
+                    continue;
+                }
+                if (tok.type == (is_obj ? JTK_RBRACE : JTK_RBRACK)) return _close(r, ev);
+                return _fail_tok(r, &tok, is_obj ? "expected ',' between object properties"
+                                                 : "expected ',' or ']' while parsing array");
+            }
+
+            default:
+                return ev->type = JEV_ERROR;
+        }
+    }
+}
+
+bool juno_reader_skip(JunoReader *r) {
+    if (!r) return false;
+
+    unsigned target = r->depth;
+    JunoEvent ev;
+    bool decode = juno_reader_set_decode(r, false);
+    while (r->depth >= target && target > 0) {
+        if (juno_reader_next(r, &ev) == JEV_ERROR) break;
+    }
+    juno_reader_set_decode(r, decode);
+    return r->state != RS_ERROR;
+}
+
+/* ------------------------------
+ * Numbers
+ * ------------------------------ */
+
+static JToken _number_token(const JunoEvent *ev) {
+    JToken t;
+    memset(&t, 0, sizeof(t));
+    t.type = JTK_NUMBER;
+    t.start = ev->raw;
+    t.length = ev->raw_len;
+    return t;
+}
+
+bool juno_event_int64(const JunoEvent *ev, int64_t *out) {
+    if (!ev || ev->type != JEV_NUMBER) return false;
+    JToken t = _number_token(ev);
+    return jl_number_to_int64(&t, out);
+}
+
+bool juno_event_double(const JunoEvent *ev, double *out) {
+    if (!ev || ev->type != JEV_NUMBER) return false;
+    JToken t = _number_token(ev);
+    return jl_number_to_double(&t, out);
+}
+
+/* ------------------------------
+ * Document builder
+ * ------------------------------ */
+
+static char* _dup_str(const char *s, size_t n) {
+    char *d = (char*)malloc(n + 1);
+    if (!d) return NULL;
+    memcpy(d, s, n);
+    d[n] = '\0';
+    return d;
+}
+
+static JsonNode* _event_node(const JunoEvent *ev) {
+    JsonNode *n = NULL;
+    switch (ev->type) {
+        case JEV_OBJ_BEGIN: return juno_create_node(JND_OBJ);
+        case JEV_ARR_BEGIN: return juno_create_node(JND_ARRAY);
+        case JEV_NULL:      return juno_create_node(JND_NULL);
+        case JEV_BOOL:
+            if ((n = juno_create_node(JND_BOOL)) != NULL) n->value.bvalue = ev->bvalue;
+            return n;
+        case JEV_STRING:
+            if ((n = juno_create_node(JND_STRING)) == NULL) return NULL;
+            if ((n->value.svalue = _dup_str(ev->str, ev->str_len)) == NULL) {
+                free(n);
+                return NULL;
+            }
+            return n;
+        case JEV_NUMBER: {
+            if ((n = juno_create_node(JND_NUMBER)) == NULL) return NULL;
+            JToken t = _number_token(ev);
+            if (!juno_number_from_token(n, &t)) n->type = JND_ERROR;
+            return n;
+        }
+        default:
+            return NULL;
+    }
+}
+
+static JsonNode* _next_document(JunoReader *r, JunoError *err) {
+    JsonNode *parents[JUNO_MAX_NESTING + 1];
+    JsonNode *tails[JUNO_MAX_NESTING + 1];
+    JsonNode *root = NULL;
+    char *key = NULL;
+    JunoEvent ev;
+
+    for (;;) {
+        switch (juno_reader_next(r, &ev)) {
+            case JEV_EOF:
+                return NULL;
+            case JEV_DOC_END:
+                return root;
+            case JEV_ERROR:
+                goto fail;
+            case JEV_OBJ_END:
+            case JEV_ARR_END:
+                juno_set_last_child(parents[ev.depth], tails[ev.depth]);
+                continue;
+            case JEV_KEY:
+                free(key);
+                if ((key = _dup_str(ev.str, ev.str_len)) == NULL) {
+                    _reader_fail(r, JUNO_ERR_OOM, "oom (key)", ev.offset);
+                    goto fail;
+                }
+                continue;
+            default:
+                break;
+        }
+
+        JsonNode *n = _event_node(&ev);
+        if (!n) {
+            _reader_fail(r, JUNO_ERR_OOM, "oom (node)", ev.offset);
+            goto fail;
+        }
+        if (n->type == JND_ERROR) {
+            free(n);
+            _reader_fail(r, JUNO_ERR_INVALID_NUMBER, "invalid number", ev.offset);
+            goto fail;
+        }
+
+        bool opens = (ev.type == JEV_OBJ_BEGIN || ev.type == JEV_ARR_BEGIN);
+        unsigned parent = opens ? ev.depth - 1 : ev.depth;
+        if (parent == 0) {
+            root = n;
+        } else {
+            n->key = key;
+            key = NULL;
+            if (tails[parent]) tails[parent]->next_sibling = n;
+            else parents[parent]->first_child = n;
+            tails[parent] = n;
+        }
+        if (opens) {
+            parents[ev.depth] = n;
+            tails[ev.depth] = NULL;
+        }
+    }
+
+fail:
+    free(key);
+    juno_free_ast(root);
+    if (err) *err = r->err;
+    return NULL;
+}
+
+JsonNode* juno_reader_next_document(JunoReader *r, JunoError *err) {
+    if (err) memset(err, 0, sizeof(*err));
+    if (!r) {
+        if (err) err->code = JUNO_ERR_INVALID_ARG;
+        return NULL;
+    }
+
+    /* Tree nodes hold whole strings. */
+    size_t part = r->str_part;
+    r->str_part = 0;
+    JsonNode *root = _next_document(r, err);
+    r->str_part = part;
+    return root;
+}
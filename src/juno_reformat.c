@@ -0,0 +1,151 @@
+#include "internal/juno_internal.h"
+
+#include <juno/reader.h>
+
+/* ------------------------------
+ * Token re-emission
+ * ------------------------------ */
+
+typedef struct {
+    JWriter *w;
+    unsigned indent;     /* spaces per level, 0: minify */
+    unsigned level;      /* containers currently open */
+    bool     open;       /* a container was just opened and has no entry yet */
+    bool     after_key;  /* a member name was written, its value comes next */
+    bool     started;    /* a document has been written (separate the next one) */
+    bool     in_string;  /* a string value is being copied in parts */
+} JFmt;
+
+static bool _fmt_newline(JFmt *f) {
+    static const char spaces[64] = "                                                               ";
+    if (!juno_w_char(f->w, '\n')) return false;
+    size_t n = (size_t)f->indent * f->level;
+    while (n > 0) {
+        size_t k = n < sizeof(spaces) - 1 ? n : sizeof(spaces) - 1;
+        if (!juno_w_put(f->w, spaces, k)) return false;
+        n -= k;
+    }
+    return true;
+}
+
+/* Separator in front of a member name or a value. */
+static bool _fmt_lead(JFmt *f) {
+    if (f->after_key) {
+        f->after_key = false;
+        return true;
+    }
+    if (f->level == 0) {
+        if (f->started && !juno_w_char(f->w, '\n')) return false;
+        f->started = true;
+        return true;
+    }
+    if (!f->open && !juno_w_char(f->w, ',')) return false;
+    f->open = false;
+    return f->indent == 0 || _fmt_newline(f);
+}
+
+static bool _fmt_event(JFmt *f, const JunoEvent *ev) {
+    switch (ev->type) {
+        case JEV_OBJ_BEGIN:
+        case JEV_ARR_BEGIN:
+            if (!_fmt_lead(f)) return false;
+            f->level++;
+            f->open = true;
+            return juno_w_char(f->w, ev->type == JEV_OBJ_BEGIN ? '{' : '[');
+
+        case JEV_OBJ_END:
+        case JEV_ARR_END:
+            f->level--;
+            if (!f->open && f->indent && !_fmt_newline(f)) return false;
+            f->open = false;
+            return juno_w_char(f->w, ev->type == JEV_OBJ_END ? '}' : ']');
+
+        case JEV_KEY:
+            if (!_fmt_lead(f) || !juno_w_put(f->w, ev->raw, ev->raw_len)) return false;
+            f->after_key = true;
+            return f->indent ? juno_w_put(f->w, ": ", 2) : juno_w_char(f->w, ':');
+
+        case JEV_STRING_PART:
+            if (!f->in_string && (!_fmt_lead(f) || !juno_w_char(f->w, '"'))) return false;
+            f->in_string = true;
+            return juno_w_put(f->w, ev->raw, ev->raw_len);
+
+        case JEV_STRING:
+            if (f->in_string) {
+                f->in_string = false;
+                return juno_w_put(f->w, ev->raw, ev->raw_len) && juno_w_char(f->w, '"');
+            }
+            return _fmt_lead(f) && juno_w_put(f->w, ev->raw, ev->raw_len);
+
+        case JEV_NUMBER:
+            return _fmt_lead(f) && juno_w_put(f->w, ev->raw, ev->raw_len);
+
+        case JEV_BOOL:
+            if (!_fmt_lead(f)) return false;
+            return ev->bvalue ? juno_w_put(f->w, "true", 4) : juno_w_put(f->w, "false", 5);
+
+        case JEV_NULL:
+            return _fmt_lead(f) && juno_w_put(f->w, "null", 4);
+
+        default:
+            return true;
+    }
+}
+
+bool juno_reformat(JunoReader *r, unsigned indent, JunoWriteFn fn, void *ud, JunoError *err) {
+    JWriter *w = (JWriter*)malloc(sizeof(JWriter));
+    if (!w) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_OOM;
+            err->msg = "oom (writer)";
+        }
+        return false;
+    }
+    juno_writer_init(w, fn, ud);
+
+    JFmt f;
+    memset(&f, 0, sizeof(f));
+    f.w = w;
+    f.indent = indent;
+
+    bool ok = true;
+    if (!r || !fn) {
+        ok = juno_w_fail(w, JUNO_ERR_INVALID_ARG, "null input", 0);
+    } else {
+        /* Output is the raw tokens: check strings, skip decoding them. */
+        bool decode = juno_reader_set_decode(r, false);
+        JunoEvent ev;
+        JunoEventType t;
+        while (ok && (t = juno_reader_next(r, &ev)) != JEV_EOF) {
+            if (t == JEV_ERROR) {
+                w->err = *juno_reader_error(r);
+                ok = false;
+            } else {
+                ok = _fmt_event(&f, &ev);
+            }
+        }
+        juno_reader_set_decode(r, decode);
+        ok = ok && juno_w_flush(w);
+    }
+
+    if (err) *err = w->err;
+    free(w);
+    return ok;
+}
+
+bool juno_reformat_buffer(const char *json_str, size_t len, unsigned indent,
+                          JunoWriteFn fn, void *ud, JunoError *err) {
+    JunoReader *r = json_str ? juno_reader_new_mem(json_str, len) : NULL;
+    if (json_str && !r) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_OOM;
+            err->msg = "oom (reader)";
+        }
+        return false;
+    }
+    bool ok = juno_reformat(r, indent, fn, ud, err);
+    juno_reader_free(r);
+    return ok;
+}
@@ -0,0 +1,533 @@
+#include "internal/juno_internal.h"
+
+#include <juno/schema.h>
+#include <juno/base64.h>
+#include <juno/builder.h>
+#include <juno/hash.h>
+
+#define JSCHEMA_SEED 0x6a756e6f73636865ull
+
+/* JSNode.types (0: any type) */
+#define JS_NULL    0x01u
+#define JS_BOOLEAN 0x02u
+#define JS_OBJECT  0x04u
+#define JS_ARRAY   0x08u
+#define JS_NUMBER  0x10u
+#define JS_INTEGER 0x20u
+#define JS_STRING  0x40u
+
+/* JSNode.flags */
+#define JS_REJECT  0x01u   /* the `false` schema */
+#define JS_MIN     0x02u
+#define JS_MAX     0x04u
+#define JS_XMIN    0x08u
+#define JS_XMAX    0x10u
+
+/* ------------------------------
+ * Compiled form
+ * ------------------------------ */
+
+typedef struct {
+    const char   *name;     /* NULL: empty slot */
+    size_t        len;
+    uint64_t      hash;
+    const JSNode *schema;   /* NULL: any value */
+    int           req;      /* bit in JSNode.required, -1 if optional */
+} JSProp;
+
+struct JSNode {
+    unsigned      types;
+    unsigned      flags;
+    double        minimum, maximum, xminimum, xmaximum;
+    size_t        min_len, max_len;       /* code points */
+    size_t        min_items, max_items;
+    JSProp       *props;                  /* open addressing, mask + 1 slots (NULL: none) */
+    uint32_t      mask;
+    unsigned      nrequired;
+    uint64_t      required;               /* every required bit */
+    const char  **req_names;              /* by bit */
+    const JSNode *additional;             /* members not in props; NULL: any */
+    const JSNode *items;                  /* array elements; NULL: any */
+    const JsonNode **enum_values;
+    uint64_t     *enum_hashes;
+    size_t        nenum;
+};
+
+struct JunoSchema {
+    JunoArena    *arena;    /* every JSNode, table, name and enum value */
+    const JSNode *root;
+};
+
+static const JSProp* _lookup(const JSNode *s, const char *key, size_t len) {
+    if (!s->props) return NULL;
+    uint64_t h = juno_hash_bytes(key, len, JSCHEMA_SEED);
+    for (uint32_t i = (uint32_t)h & s->mask; s->props[i].name; i = (i + 1) & s->mask) {
+        const JSProp *p = &s->props[i];
+        if (p->hash == h && p->len == len && memcmp(p->name, key, len) == 0) return p;
+    }
+    return NULL;
+}
+
+/* ------------------------------
+ * JSON Pointers
+ * ------------------------------ */
+
+/* Put "/seg" (escaped per RFC 6901) in front of the pointer; violations are
+ * found innermost first, so pointers are built while unwinding. */
+static void _ptr_prepend(JunoSchemaError *e, const char *seg, size_t len) {
+    if (!e || e->truncated) return;
+    size_t esc = len, cur = strlen(e->pointer);
+    for (size_t i = 0; i < len; i++) esc += (seg[i] == '~' || seg[i] == '/');
+    if (cur + esc + 2 > JUNO_SCHEMA_POINTER_MAX) {
+        e->truncated = true;
+        return;
+    }
+    memmove(e->pointer + esc + 1, e->pointer, cur + 1);
+    char *w = e->pointer;
+    *w++ = '/';
+    for (size_t i = 0; i < len; i++) {
+        if (seg[i] == '~' || seg[i] == '/') {
+            *w++ = '~';
+            *w++ = seg[i] == '~' ? '0' : '1';
+        } else {
+            *w++ = seg[i];
+        }
+    }
+}
+
+static void _ptr_prepend_index(JunoSchemaError *e, size_t index) {
+    char buf[24];
+    int n = snprintf(buf, sizeof(buf), "%zu", index);
+    _ptr_prepend(e, buf, (size_t)n);
+}
+
+/* ------------------------------
+ * Checks
+ * ------------------------------ */
+
+static unsigned _type_bit(JNodeType t) {
+    switch (t) {
+        case JND_NULL:     return JS_NULL;
+        case JND_BOOL:     return JS_BOOLEAN;
+        case JND_OBJ:
+        case JND_ROOT_OBJ: return JS_OBJECT;
+        case JND_ARRAY:    return JS_ARRAY;
+        case JND_NUMBER:   return JS_NUMBER | JS_INTEGER;
+        case JND_STRING:   return JS_STRING;
+        default:           return 0;
+    }
+}
+
+static const char* _check_type(const JSNode *s, JNodeType t) {
+    if (s->flags & JS_REJECT) return "value not allowed by schema";
+    if (s->types && !(s->types & _type_bit(t))) return "value has the wrong type";
+    return NULL;
+}
+
+/* JSON Schema integers are numbers without a fractional part (1.0 included). */
+static bool _integral(const JsonNode *n, double d) {
+    int64_t i;
+    if (juno_number_int64(n, &i)) return true;
+    if (d > 9007199254740992.0 || d < -9007199254740992.0) return true;   /* beyond 2^53 every double is */
+    return d == (double)(int64_t)d;
+}
+
+/* Length in code points; binary nodes count the characters of their base64 text. */
+static size_t _str_length(const JsonNode *n) {
+    size_t len = 0;
+    if (n->flags & JND_FLAG_BINARY) {
+        juno_binary(n, &len);
+        return juno_base64_encoded_len(len, (n->flags & JND_FLAG_BASE64URL) ? JUNO_BASE64_URL : 0);
+    }
+    for (const unsigned char *p = (const unsigned char*)n->value.svalue; p && *p; p++) len += (*p & 0xC0) != 0x80;
+    return len;
+}
+
+static bool _in_enum(const JSNode *s, const JsonNode *n) {
+    uint64_t h = juno_hash(n);
+    for (size_t i = 0; i < s->nenum; i++)
+        if (s->enum_hashes[i] == h && juno_equal(s->enum_values[i], n)) return true;
+    return false;
+}
+
+/* Everything but the type and the members' own schemas. `seen` holds the
+ * required bits met by an object's members. */
+static const char* _check_value(const JSNode *s, const JsonNode *n, uint64_t seen, const char **member) {
+    switch (n->type) {
+        case JND_NUMBER: {
+            double d = 0;
+            juno_number_double(n, &d);
+            if ((s->types & (JS_NUMBER | JS_INTEGER)) == JS_INTEGER && !_integral(n, d)) return "value is not an integer";
+            if ((s->flags & JS_MIN) && d < s->minimum) return "value below minimum";
+            if ((s->flags & JS_MAX) && d > s->maximum) return "value above maximum";
+            if ((s->flags & JS_XMIN) && d <= s->xminimum) return "value not above exclusiveMinimum";
+            if ((s->flags & JS_XMAX) && d >= s->xmaximum) return "value not below exclusiveMaximum";
+            break;
+        }
+        case JND_STRING:
+            if (s->min_len || s->max_len != SIZE_MAX) {
+                size_t len = _str_length(n);
+                if (len < s->min_len) return "string shorter than minLength";
+                if (len > s->max_len) return "string longer than maxLength";
+            }
+            break;
+        case JND_ARRAY:
+            if (s->min_items || s->max_items != SIZE_MAX) {
+                size_t count = 0;
+                for (const JsonNode *c = n->first_child; c; c = c->next_sibling) count++;
+                if (count < s->min_items) return "array has fewer items than minItems";
+                if (count > s->max_items) return "array has more items than maxItems";
+            }
+            break;
+        case JND_OBJ:
+        case JND_ROOT_OBJ:
+            if ((seen & s->required) != s->required) {
+                unsigned bit = 0;
+                while (seen & (1ull << bit)) bit++;
+                *member = s->req_names[bit];
+                return "missing required member";
+            }
+            break;
+        default:
+            break;
+    }
+    if (s->nenum && !_in_enum(s, n)) return "value not in enum";
+    return NULL;
+}
+
+/* ------------------------------
+ * Parser hooks
+ * ------------------------------ */
+
+static bool _fail(JParser *ps, const char *msg, const char *member, const char *at, unsigned depth) {
+    if (ps->err.code == JUNO_OK && ps->sch_err) {
+        ps->sch_err->pointer[0] = '\0';
+        ps->sch_err->truncated = false;
+        ps->sch_err->member = member;
+    }
+    juno_fail(ps, JUNO_ERR_SCHEMA, msg, at, depth);
+    return false;
+}
+
+bool juno_schema_enter(JParser *ps, const JSNode *s, JNodeType type, const char *at, unsigned depth) {
+    const char *msg = _check_type(s, type);
+    return !msg || _fail(ps, msg, NULL, at, depth);
+}
+
+bool juno_schema_member(JParser *ps, const JSNode *s, const char *key, uint64_t *seen, const char *at, unsigned depth) {
+    const JSProp *p = _lookup(s, key, strlen(key));
+    const JSNode *child = p ? p->schema : s->additional;
+    if (p && p->req >= 0) *seen |= 1ull << p->req;
+    if (child && (child->flags & JS_REJECT)) return _fail(ps, "member not allowed by schema", NULL, at, depth);
+    ps->sch_next = child;
+    return true;
+}
+
+bool juno_schema_item(JParser *ps, const JSNode *s, size_t index, const char *at, unsigned depth) {
+    if (index >= s->max_items) return _fail(ps, "array has more items than maxItems", NULL, at, depth);
+    ps->sch_next = s->items;
+    return true;
+}
+
+bool juno_schema_check(JParser *ps, const JSNode *s, const JsonNode *n, uint64_t seen, const char *at, unsigned depth) {
+    const char *member = NULL, *msg = _check_type(s, n->type);
+    if (!msg) msg = _check_value(s, n, seen, &member);
+    return !msg || _fail(ps, msg, member, at, depth);
+}
+
+void juno_schema_unwind_key(JParser *ps, const char *key) {
+    if (ps->err.code == JUNO_ERR_SCHEMA) _ptr_prepend(ps->sch_err, key, strlen(key));
+}
+
+void juno_schema_unwind_index(JParser *ps, size_t index) {
+    if (ps->err.code == JUNO_ERR_SCHEMA) _ptr_prepend_index(ps->sch_err, index);
+}
+
+/* ------------------------------
+ * Tree validation
+ * ------------------------------ */
+
+static bool _vfail(JunoSchemaError *err, const char *msg, const char *member) {
+    if (err) {
+        err->error.code = JUNO_ERR_SCHEMA;
+        err->error.msg = msg;
+        err->member = member;
+    }
+    return false;
+}
+
+static bool _validate(const JSNode *s, const JsonNode *n, JunoSchemaError *err) {
+    const char *member = NULL, *msg = _check_type(s, n->type);
+    uint64_t seen = 0;
+
+    if (!msg && (n->type == JND_OBJ || n->type == JND_ROOT_OBJ)) {
+        for (const JsonNode *c = n->first_child; c; c = c->next_sibling) {
+            const char *key = c->key ? c->key : "";
+            const JSProp *p = _lookup(s, key, strlen(key));
+            const JSNode *cs = p ? p->schema : s->additional;
+            if (p && p->req >= 0) seen |= 1ull << p->req;
+            if (cs && (cs->flags & JS_REJECT)) _vfail(err, "member not allowed by schema", NULL);
+            else if (!cs || _validate(cs, c, err)) continue;
+            _ptr_prepend(err, key, strlen(key));
+            return false;
+        }
+    } else if (!msg && n->type == JND_ARRAY && s->items) {
+        size_t i = 0;
+        for (const JsonNode *c = n->first_child; c; c = c->next_sibling, i++) {
+            if (_validate(s->items, c, err)) continue;
+            _ptr_prepend_index(err, i);
+            return false;
+        }
+    }
+    if (!msg) msg = _check_value(s, n, seen, &member);
+    return !msg || _vfail(err, msg, member);
+}
+
+/* ------------------------------
+ * Compiler
+ * ------------------------------ */
+
+static void* _c_alloc(JunoArena *a, size_t size) {
+    void *p = juno_arena_alloc(a, size);
+    if (p) memset(p, 0, size);
+    return p;
+}
+
+static bool _cfail(JunoSchemaError *err, JunoErrorCode code, const char *msg) {
+    if (err) {
+        memset(err, 0, sizeof(*err));
+        err->error.code = code;
+        err->error.msg = msg;
+    }
+    return false;
+}
+
+static const char* _c_types(JSNode *s, const JsonNode *kw) {
+    static const char *const names[] = { "null", "boolean", "object", "array", "number", "integer", "string" };
+    const JsonNode *one = kw->type == JND_STRING ? kw : NULL;
+    if (!one && kw->type != JND_ARRAY) return "type must be a string or an array of strings";
+
+    for (const JsonNode *t = one ? one : kw->first_child; t; t = one ? NULL : t->next_sibling) {
+        if (t->type != JND_STRING || (t->flags & JND_FLAG_BINARY)) return "type must be a string or an array of strings";
+        unsigned i = 0;
+        while (i < 7 && strcmp(names[i], t->value.svalue) != 0) i++;
+        if (i == 7) return "unknown type name";
+        s->types |= 1u << i;
+    }
+    return NULL;
+}
+
+static const char* _c_number(const JsonNode *kw, double *out, unsigned *flags, unsigned flag) {
+    if (kw->type != JND_NUMBER || !juno_number_double(kw, out)) return "value must be a number";
+    *flags |= flag;
+    return NULL;
+}
+
+static const char* _c_count(const JsonNode *kw, size_t *out) {
+    int64_t v;
+    if (kw->type != JND_NUMBER || !juno_number_int64(kw, &v) || v < 0) return "value must be a non-negative integer";
+    *out = (size_t)v;
+    return NULL;
+}
+
+static const char* _c_enum(JunoArena *a, JSNode *s, const JsonNode *kw) {
+    if (kw->type != JND_ARRAY) return "enum must be an array";
+    size_t n = 0;
+    for (const JsonNode *v = kw->first_child; v; v = v->next_sibling) n++;
+    s->enum_values = (const JsonNode**)_c_alloc(a, n * sizeof(*s->enum_values));
+    s->enum_hashes = (uint64_t*)_c_alloc(a, n * sizeof(*s->enum_hashes));
+    if (!s->enum_values || !s->enum_hashes) return "oom (schema)";
+    for (const JsonNode *v = kw->first_child; v; v = v->next_sibling, s->nenum++) {
+        if (!(s->enum_values[s->nenum] = juno_clone(a, v))) return "oom (schema)";
+        s->enum_hashes[s->nenum] = juno_hash(v);
+    }
+    return NULL;
+}
+
+/* Slot for `name`, added (with no schema, optional) if it is not there yet. */
+static JSProp* _c_prop(JunoArena *a, JSNode *s, const char *name) {
+    size_t len = strlen(name);
+    uint64_t h = juno_hash_bytes(name, len, JSCHEMA_SEED);
+    uint32_t i = (uint32_t)h & s->mask;
+    for (; s->props[i].name; i = (i + 1) & s->mask)
+        if (s->props[i].hash == h && s->props[i].len == len && memcmp(s->props[i].name, name, len) == 0)
+            return &s->props[i];
+
+    char *copy = (char*)juno_arena_alloc(a, len + 1);
+    if (!copy) return NULL;
+    memcpy(copy, name, len + 1);
+    JSProp *p = &s->props[i];
+    p->name = copy;
+    p->len = len;
+    p->hash = h;
+    p->req = -1;
+    return p;
+}
+
+static JSNode* _compile(JunoArena *a, const JsonNode *js, JunoSchemaError *err);
+
+/* The member table of `properties` and `required`. */
+static bool _c_members(JunoArena *a, JSNode *s, const JsonNode *props, const JsonNode *required, JunoSchemaError *err) {
+    size_t n = 0, nreq = 0;
+    for (const JsonNode *p = props ? props->first_child : NULL; p; p = p->next_sibling) n++;
+    for (const JsonNode *r = required ? required->first_child : NULL; r; r = r->next_sibling) nreq++;
+    if (nreq > 64) {
+        _cfail(err, JUNO_ERR_INVALID_ARG, "more than 64 required members");
+        _ptr_prepend(err, "required", 8);
+        return false;
+    }
+
+    uint32_t slots = 2;
+    while (slots < 2 * (n + nreq)) slots *= 2;
+    s->props = (JSProp*)_c_alloc(a, slots * sizeof(JSProp));
+    s->req_names = (const char**)_c_alloc(a, (nreq ? nreq : 1) * sizeof(char*));
+    if (!s->props || !s->req_names) return _cfail(err, JUNO_ERR_OOM, "oom (schema)");
+    s->mask = slots - 1;
+
+    for (const JsonNode *p = props ? props->first_child : NULL; p; p = p->next_sibling) {
+        const char *key = p->key ? p->key : "";
+        JSProp *slot = _c_prop(a, s, key);
+        if (!slot) return _cfail(err, JUNO_ERR_OOM, "oom (schema)");
+        if (!(slot->schema = _compile(a, p, err))) {
+            _ptr_prepend(err, key, strlen(key));
+            _ptr_prepend(err, "properties", 10);
+            return false;
+        }
+    }
+    for (const JsonNode *r = required ? required->first_child : NULL; r; r = r->next_sibling) {
+        JSProp *slot = _c_prop(a, s, r->value.svalue);
+        if (!slot) return _cfail(err, JUNO_ERR_OOM, "oom (schema)");
+        if (slot->req >= 0) continue;   /* listed twice */
+        slot->req = (int)s->nrequired;
+        s->req_names[s->nrequired++] = slot->name;
+    }
+    s->required = s->nrequired == 64 ? ~0ull : (1ull << s->nrequired) - 1;
+    return true;
+}
+
+static bool _c_annotation(const char *k) {
+    static const char *const names[] = {
+        "$schema", "$id", "$comment", "title", "description", "default", "examples", NULL
+    };
+    for (const char *const *n = names; *n; n++)
+        if (strcmp(*n, k) == 0) return true;
+    return false;
+}
+
+static JSNode* _compile(JunoArena *a, const JsonNode *js, JunoSchemaError *err) {
+    JSNode *s = (JSNode*)_c_alloc(a, sizeof(JSNode));
+    if (!s) {
+        _cfail(err, JUNO_ERR_OOM, "oom (schema)");
+        return NULL;
+    }
+    s->max_len = s->max_items = SIZE_MAX;
+    if (js->type == JND_BOOL) {
+        if (!js->value.bvalue) s->flags = JS_REJECT;
+        return s;
+    }
+    if (js->type != JND_OBJ && js->type != JND_ROOT_OBJ) {
+        _cfail(err, JUNO_ERR_INVALID_ARG, "schema must be an object or a boolean");
+        return NULL;
+    }
+
+    const JsonNode *props = NULL, *required = NULL;
+    for (const JsonNode *kw = js->first_child; kw; kw = kw->next_sibling) {
+        const char *k = kw->key ? kw->key : "", *msg = NULL;
+        if (strcmp(k, "type") == 0) {
+            msg = _c_types(s, kw);
+        } else if (strcmp(k, "properties") == 0) {
+            if (kw->type != JND_OBJ) msg = "properties must be an object";
+            props = kw;
+        } else if (strcmp(k, "required") == 0) {
+            if (kw->type != JND_ARRAY) msg = "required must be an array of strings";
+            for (const JsonNode *r = kw->first_child; r && !msg; r = r->next_sibling)
+                if (r->type != JND_STRING || (r->flags & JND_FLAG_BINARY)) msg = "required must be an array of strings";
+            required = kw;
+        } else if (strcmp(k, "additionalProperties") == 0 || strcmp(k, "items") == 0) {
+            if (kw->type == JND_ARRAY) {
+                msg = "unsupported schema keyword";   /* tuple form of items */
+            } else {
+                JSNode *sub = _compile(a, kw, err);
+                if (!sub) {
+                    _ptr_prepend(err, k, strlen(k));
+                    return NULL;
+                }
+                if (k[0] == 'i') s->items = sub;
+                else s->additional = sub;
+            }
+        } else if (strcmp(k, "enum") == 0) {
+            msg = _c_enum(a, s, kw);
+        } else if (strcmp(k, "minimum") == 0) {
+            msg = _c_number(kw, &s->minimum, &s->flags, JS_MIN);
+        } else if (strcmp(k, "maximum") == 0) {
+            msg = _c_number(kw, &s->maximum, &s->flags, JS_MAX);
+        } else if (strcmp(k, "exclusiveMinimum") == 0) {
+            msg = _c_number(kw, &s->xminimum, &s->flags, JS_XMIN);
+        } else if (strcmp(k, "exclusiveMaximum") == 0) {
+            msg = _c_number(kw, &s->xmaximum, &s->flags, JS_XMAX);
+        } else if (strcmp(k, "minLength") == 0) {
+            msg = _c_count(kw, &s->min_len);
+        } else if (strcmp(k, "maxLength") == 0) {
+            msg = _c_count(kw, &s->max_len);
+        } else if (strcmp(k, "minItems") == 0) {
+            msg = _c_count(kw, &s->min_items);
+        } else if (strcmp(k, "maxItems") == 0) {
+            msg = _c_count(kw, &s->max_items);
+        } else if (!_c_annotation(k)) {
+            msg = "unsupported schema keyword";
+        }
+        if (msg) {
+            _cfail(err, strncmp(msg, "oom", 3) == 0 ? JUNO_ERR_OOM : JUNO_ERR_INVALID_ARG, msg);
+            _ptr_prepend(err, k, strlen(k));
+            return NULL;
+        }
+    }
+    if ((props || required) && !_c_members(a, s, props, required, err)) return NULL;
+    return s;
+}
+
+/* ------------------------------
+ * Public API
+ * ------------------------------ */
+
+JunoSchema* juno_schema_compile(const JsonNode *schema, JunoSchemaError *err) {
+    if (!schema) {
+        _cfail(err, JUNO_ERR_INVALID_ARG, "null input");
+        return NULL;
+    }
+    JunoSchema *sc = (JunoSchema*)calloc(1, sizeof(JunoSchema));
+    if (sc) sc->arena = juno_arena_new(4096);
+    if (!sc || !sc->arena) {
+        free(sc);
+        _cfail(err, JUNO_ERR_OOM, "oom (schema)");
+        return NULL;
+    }
+    if (err) memset(err, 0, sizeof(*err));
+    if (!(sc->root = _compile(sc->arena, schema, err))) {
+        juno_schema_free(sc);
+        return NULL;
+    }
+    return sc;
+}
+
+void juno_schema_free(JunoSchema *schema) {
+    if (!schema) return;
+    juno_arena_free(schema->arena);
+    free(schema);
+}
+
+JsonNode* juno_schema_parse(const JunoSchema *schema, const char *json_str, size_t len,
+                            const JunoParseOptions *opts, JunoSchemaError *err) {
+    if (!schema || !json_str) {
+        _cfail(err, JUNO_ERR_INVALID_ARG, "null input");
+        return NULL;
+    }
+    if (err) memset(err, 0, sizeof(*err));
+    return juno_parse_run(json_str, len, opts, schema->root, err, err ? &err->error : NULL);
+}
+
+bool juno_schema_validate(const JunoSchema *schema, const JsonNode *root, JunoSchemaError *err) {
+    if (!schema || !root) return _cfail(err, JUNO_ERR_INVALID_ARG, "null input");
+    if (err) memset(err, 0, sizeof(*err));
+    return _validate(schema->root, root, err);
+}
@@ -0,0 +1,242 @@
+#include "internal/juno_internal.h"
+
+#include <juno/writer.h>
+#include <juno/iter.h>
+
+#include <inttypes.h>
+#include <math.h>
+
+/* ------------------------------
+ * Output staging
+ * ------------------------------ */
+
+void juno_writer_init(JWriter *w, JunoWriteFn fn, void *ud) {
+    memset(&w->err, 0, sizeof(w->err));
+    w->fn = fn;
+    w->ud = ud;
+    w->written = 0;
+    w->n = 0;
+}
+
+bool juno_w_fail(JWriter *w, JunoErrorCode code, const char *msg, unsigned depth) {
+    if (w->err.code == JUNO_OK) {
+        w->err.code = code;
+        w->err.msg = msg;
+        w->err.offset = w->written + w->n;
+        w->err.depth = depth;
+    }
+    return false;
+}
+
+bool juno_w_flush(JWriter *w) {
+    if (w->n == 0) return true;
+    if (!w->fn(w->ud, w->buf, w->n)) return juno_w_fail(w, JUNO_ERR_IO, "write callback failed", 0);
+    w->written += w->n;
+    w->n = 0;
+    return true;
+}
+
+bool juno_w_put(JWriter *w, const char *s, size_t len) {
+    if (len > JWRITER_BUF - w->n) {
+        if (!juno_w_flush(w)) return false;
+        if (len > JWRITER_BUF) {
+            if (!w->fn(w->ud, s, len)) return juno_w_fail(w, JUNO_ERR_IO, "write callback failed", 0);
+            w->written += len;
+            return true;
+        }
+    }
+    memcpy(w->buf + w->n, s, len);
+    w->n += len;
+    return true;
+}
+
+/* ------------------------------
+ * Scalars
+ * ------------------------------ */
+
+bool juno_w_string(JWriter *w, const char *s, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    if (!juno_w_char(w, '"')) return false;
+
+    const char *run = s, *end = s + len;
+    for (const char *p = s; p < end; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        if (!juno_w_put(w, run, (size_t)(p - run))) return false;
+        run = p + 1;
+
+        char esc[6] = { '\\', 0, '0', '0', 0, 0 };
+        size_t n = 2;
+        switch (c) {
+            case '"':  esc[1] = '"';  break;
+            case '\\': esc[1] = '\\'; break;
+            case '\b': esc[1] = 'b';  break;
+            case '\f': esc[1] = 'f';  break;
+            case '\n': esc[1] = 'n';  break;
+            case '\r': esc[1] = 'r';  break;
+            case '\t': esc[1] = 't';  break;
+            default:
+                esc[1] = 'u';
+                esc[4] = hex[c >> 4];
+                esc[5] = hex[c & 0xF];
+                n = 6;
+                break;
+        }
+        if (!juno_w_put(w, esc, n)) return false;
+    }
+    if (!juno_w_put(w, run, (size_t)(end - run))) return false;
+    return juno_w_char(w, '"');
+}
+
+static inline bool _w_cstring(JWriter *w, const char *s) {
+    return s ? juno_w_string(w, s, strlen(s)) : juno_w_put(w, "\"\"", 2);
+}
+
+/* Shortest %g form that reads back as `v`, forced to look like a double. */
+static int _fmt_double(char *buf, size_t size, double v) {
+    int n = 0;
+    for (int prec = 15; prec <= 17; prec++) {
+        n = snprintf(buf, size, "%.*g", prec, v);
+        if (strtod(buf, NULL) == v) break;
+    }
+    if (!strpbrk(buf, ".eE") && (size_t)n + 2 < size) {
+        buf[n++] = '.';
+        buf[n++] = '0';
+        buf[n] = '\0';
+    }
+    return n;
+}
+
+static bool _w_number(JWriter *w, const JsonNode *n, unsigned depth) {
+    char num[40];
+    int len;
+    /* Raw numbers: source text, byte for byte (validated by the lexer or builder). */
+    if (n->flags & JND_FLAG_RAW_NUMBER) return juno_w_put(w, n->value.svalue, strlen(n->value.svalue));
+
+    if (n->is_integer) {
+        len = snprintf(num, sizeof(num), "%" PRId64, n->value.ivalue);
+    } else {
+        if (!isfinite(n->value.nvalue))
+            return juno_w_fail(w, JUNO_ERR_INVALID_NUMBER, "non-finite number", depth);
+        len = _fmt_double(num, sizeof(num), n->value.nvalue);
+    }
+    return juno_w_put(w, num, (size_t)len);
+}
+
+/* ------------------------------
+ * Tree walk
+ * ------------------------------ */
+
+static bool _w_scalar(JWriter *w, const JsonNode *n, unsigned depth) {
+    switch (n->type) {
+        case JND_NULL:   return juno_w_put(w, "null", 4);
+        case JND_BOOL:   return n->value.bvalue ? juno_w_put(w, "true", 4) : juno_w_put(w, "false", 5);
+        case JND_NUMBER: return _w_number(w, n, depth);
+        case JND_STRING:
+            if (n->flags & JND_FLAG_BINARY) return juno_w_base64(w, n);
+            return _w_cstring(w, n->value.svalue);
+        default:         return juno_w_fail(w, JUNO_ERR_INVALID_ARG, "cannot serialize an error node", depth);
+    }
+}
+
+static bool _w_tree(JWriter *w, const JsonNode *root) {
+    JunoIter it;
+    JunoIterEvent ev;
+    bool need_comma = false, ok = true;
+
+    juno_iter_init(&it, root);
+    while (ok && (ev = juno_iter_next(&it)) != JUNO_ITER_END) {
+        if (ev == JUNO_ITER_LEAVE) {
+            ok = juno_w_char(w, it.type == JND_OBJ ? '}' : ']');
+            need_comma = true;
+            continue;
+        }
+        if ((need_comma && !juno_w_char(w, ',')) ||
+            (it.key && (!juno_w_string(w, it.key, it.key_len) || !juno_w_char(w, ':')))) {
+            ok = false;
+            break;
+        }
+
+        if (ev == JUNO_ITER_VALUE) {
+            ok = _w_scalar(w, it.pos.node, it.depth);
+            need_comma = true;
+        } else if (it.depth >= JUNO_MAX_NESTING) {
+            ok = juno_w_fail(w, JUNO_ERR_NESTING, NULL, it.depth + 1);
+        } else {
+            /* ENTER; ERROR cannot happen below JUNO_MAX_NESTING (inline path). */
+            ok = juno_w_char(w, it.type == JND_OBJ ? '{' : '[');
+            need_comma = false;
+        }
+    }
+    juno_iter_free(&it);
+    return ok;
+}
+
+bool juno_write(const JsonNode *root, JunoWriteFn fn, void *ud, JunoError *err) {
+    JWriter *w = (JWriter*)malloc(sizeof(JWriter));
+    if (!w) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            err->code = JUNO_ERR_OOM;
+            err->msg = "oom (writer)";
+        }
+        return false;
+    }
+    juno_writer_init(w, fn, ud);
+
+    bool ok;
+    if (!root || !fn) ok = juno_w_fail(w, JUNO_ERR_INVALID_ARG, "null input", 0);
+    else ok = _w_tree(w, root) && juno_w_flush(w);
+
+    if (err) *err = w->err;
+    free(w);
+    return ok;
+}
+
+/* ------------------------------
+ * In-memory output
+ * ------------------------------ */
+
+typedef struct {
+    char  *data;
+    size_t len, cap;
+} JStrBuf;
+
+static bool _strbuf_append(void *ud, const char *data, size_t len) {
+    JStrBuf *sb = (JStrBuf*)ud;
+    if (len + 1 > sb->cap - sb->len) {
+        size_t cap = sb->cap ? sb->cap : 256;
+        while (len + 1 > cap - sb->len) cap *= 2;
+        char *p = (char*)realloc(sb->data, cap);
+        if (!p) return false;
+        sb->data = p;
+        sb->cap = cap;
+    }
+    memcpy(sb->data + sb->len, data, len);
+    sb->len += len;
+    return true;
+}
+
+char* juno_stringify_with(JWriteTreeFn write, const JsonNode *root, size_t *len, JunoError *err) {
+    JStrBuf sb = { NULL, 0, 0 };
+    JunoError e;
+    if (!write(root, _strbuf_append, &sb, &e) || !_strbuf_append(&sb, "", 0)) {
+        /* The sink only refuses on realloc failure. */
+        if (e.code == JUNO_ERR_IO || e.code == JUNO_OK) {
+            e.code = JUNO_ERR_OOM;
+            e.msg = "oom (stringify)";
+        }
+        if (err) *err = e;
+        free(sb.data);
+        return NULL;
+    }
+    sb.data[sb.len] = '\0';
+    if (len) *len = sb.len;
+    if (err) *err = e;
+    return sb.data;
+}
+
+char* juno_stringify(const JsonNode *root, size_t *len, JunoError *err) {
+    return juno_stringify_with(juno_write, root, len, err);
+}
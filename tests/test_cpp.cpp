@@ -0,0 +1,142 @@
+// tests/test_cpp.cpp — juno/juno.hpp
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <juno/juno.hpp>
+
+/* ------------------------------------------------------------------
+ *  Minimal test framework (same output as test_main.c)
+ * ------------------------------------------------------------------ */
+
+static int tests_run    = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define ASSERT_TRUE(cond) do {                                      \
+    if (!(cond)) {                                                  \
+        printf("\033[0;31m[FAILED]\033[0m %s:%d: '%s'\n",           \
+               __FILE__, __LINE__, #cond);                          \
+        tests_failed++;                                             \
+        return;                                                     \
+    }                                                               \
+} while (0)
+
+#define RUN_TEST(fn) do {                                           \
+    printf("[RUNNING] %s\n", #fn);                                  \
+    int failed_before = tests_failed;                               \
+    fn();                                                           \
+    tests_run++;                                                    \
+    if (tests_failed == failed_before) {                            \
+        tests_passed++;                                             \
+        printf("\033[0;32m[PASSED]\033[0m %s\n", #fn);              \
+    }                                                               \
+} while (0)
+
+using namespace juno::literals;
+
+/* The wrappers are views: no state beyond the pointer. */
+static_assert(sizeof(juno::Value) == sizeof(JsonNode *), "Value is one pointer");
+static_assert(sizeof(juno::Document) == sizeof(JsonNode *), "Document is one pointer");
+static_assert(!std::is_copy_constructible_v<juno::Document>, "Document is move-only");
+static_assert(std::is_nothrow_move_constructible_v<juno::Document>, "Document moves cheaply");
+static_assert("name"_k.size() == 4, "literal key length is a constant");
+
+static const char *k_doc =
+    "{\"id\": 42, \"big\": 5000000000, \"neg\": -1, \"pi\": 3.25, \"ok\": true,"
+    " \"name\": \"juno\", \"tags\": [\"a\", \"bb\", \"ccc\"], \"nested\": {\"n\": null}}";
+
+static void test_cpp_document(void) {
+    auto doc = juno::Document::parse(k_doc);
+    ASSERT_TRUE(doc.has_value());
+
+    /* Moving transfers ownership; the source is left empty. */
+    juno::Document owner = std::move(*doc);
+    ASSERT_TRUE(owner && !*doc);
+    juno::Document other;
+    other = std::move(owner);
+    ASSERT_TRUE(other && !owner);
+
+    auto bad = juno::Document::parse("{\"a\": tru}");
+    ASSERT_TRUE(!bad);
+    ASSERT_TRUE(bad.error().code == JUNO_ERR_INVALID_LITERAL);
+    ASSERT_TRUE(bad.error().offset == 6);
+
+    auto missing = juno::Document::parse_file("./tests/json_files_test/no_such_file.json");
+    ASSERT_TRUE(!missing && missing.error().code == JUNO_ERR_IO);
+
+    auto file = juno::Document::parse_file("./tests/json_files_test/test_array.json");
+    ASSERT_TRUE(file && (*file)["locations"_k].is_array());
+
+    /* Arena documents are borrowed: destroying the Document leaves the arena alone. */
+    JunoArena *arena = juno_arena_new(0);
+    JunoParseOptions opts;
+    std::memset(&opts, 0, sizeof(opts));
+    opts.arena = arena;
+    {
+        auto in_arena = juno::Document::parse(k_doc, &opts);
+        ASSERT_TRUE(in_arena && (*in_arena)["id"_k].get_or<int>(0) == 42);
+    }
+    juno_arena_free(arena);
+}
+
+static void test_cpp_access(void) {
+    auto parsed = juno::Document::parse(k_doc);
+    ASSERT_TRUE(parsed);
+    const juno::Document &doc = *parsed;
+
+    ASSERT_TRUE(doc["id"_k].get<int>().value() == 42);
+    ASSERT_TRUE(doc["big"_k].get<int64_t>().value() == 5000000000LL);
+    ASSERT_TRUE(doc["pi"_k].get<double>().value() == 3.25);
+    ASSERT_TRUE(doc["ok"_k].get<bool>().value());
+    ASSERT_TRUE(doc["name"_k].get<std::string_view>().value() == "juno");
+    ASSERT_TRUE(std::strcmp(doc["name"_k].get<const char *>().value(), "juno") == 0);
+    ASSERT_TRUE(doc["nested"_k]["n"_k].is_null());
+
+    /* Runtime keys work too, and must match the whole name. */
+    std::string_view runtime_key("name");
+    ASSERT_TRUE(doc[runtime_key].is_string());
+    ASSERT_TRUE(!doc["nam"] && !doc["names"]);
+
+    /* Range and type checks surface as errors, not silent truncation. */
+    auto narrow = doc["big"_k].get<int32_t>();
+    ASSERT_TRUE(!narrow && narrow.error().code == JUNO_ERR_INVALID_NUMBER);
+    ASSERT_TRUE(!doc["neg"_k].get<unsigned>());
+    ASSERT_TRUE(!doc["pi"_k].get<int>());
+    auto mismatch = doc["name"_k].get<double>();
+    ASSERT_TRUE(!mismatch && mismatch.error().code == JUNO_ERR_INVALID_ARG);
+    auto absent = doc["nope"_k]["deeper"_k][3].get<bool>();
+    ASSERT_TRUE(!absent && absent.error().code == JUNO_ERR_PATH_NOT_FOUND);
+    ASSERT_TRUE(doc["nope"_k].get_or<int>(-7) == -7);
+
+    /* Children in document order, strings pointing into the tree. */
+    std::vector<std::string_view> tags;
+    for (juno::Value t : doc["tags"_k]) tags.push_back(t.get_or<std::string_view>(""));
+    ASSERT_TRUE(tags.size() == 3 && tags[0] == "a" && tags[2] == "ccc");
+    ASSERT_TRUE(doc["tags"_k].size() == 3);
+    ASSERT_TRUE(doc["tags"_k][1].get<std::string_view>().value() == "bb");
+    ASSERT_TRUE(!doc["tags"_k][3]);
+    ASSERT_TRUE(doc["tags"_k][0].node()->value.svalue == tags[0].data());
+
+    std::size_t members = 0;
+    for (juno::Value m : doc) {
+        if (members == 0) ASSERT_TRUE(m.key() == "id");
+        members++;
+    }
+    ASSERT_TRUE(members == 8);
+    ASSERT_TRUE(doc["id"_k].begin() == doc["id"_k].end());
+}
+
+int main(void) {
+    printf("=== C++ binding test suite ===\n");
+
+    RUN_TEST(test_cpp_document);
+    RUN_TEST(test_cpp_access);
+
+    printf("\n=== Summary ===\n");
+    printf("Run: %d, Passed: %d, Failed: %d\n",
+           tests_run, tests_passed, tests_failed);
+    return tests_failed == 0 ? 0 : 1;
+}
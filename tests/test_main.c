@@ -4,6 +4,22 @@
 #include <string.h>
 
 #include <juno/juno.h>
+#include <juno/reader.h>
+#include <juno/projection.h>
+#include <juno/binary.h>
+#include <juno/batch.h>
+#include <juno/builder.h>
+#include <juno/writer.h>
+#include <juno/doc.h>
+#include <juno/hash.h>
+#include <juno/patch.h>
+#include <juno/iter.h>
+#include <juno/files.h>
+#include <juno/cache.h>
+#include <juno/base64.h>
+#include <juno/schema.h>
+
+#include <pthread.h>
 
 /* ------------------------------------------------------------------
  *  Minimal test framework
@@ -250,6 +266,1798 @@ static void test_number_cases_file(void) {
     juno_free_ast(root);
 }
 
+/* Objects count one level each, like arrays: {"a":{"a":...0...}} is accepted
+ * up to JUNO_MAX_NESTING objects and rejected one past it. */
+static char* _nested_objects(int n) {
+    char *buf = (char*)malloc((size_t)n * 6 + 2);
+    char *p = buf;
+    for (int i = 0; i < n; ++i) p += sprintf(p, "{\"a\":");
+    *p++ = '0';
+    for (int i = 0; i < n; ++i) *p++ = '}';
+    *p = '\0';
+    return buf;
+}
+
+static void test_object_nesting(void) {
+    char *ok = _nested_objects(JUNO_MAX_NESTING);
+    JunoError err;
+    JsonNode *root = juno_parse_ex(ok, strlen(ok), &err);
+    ASSERT_TRUE(root != NULL);
+    juno_free_ast(root);
+    free(ok);
+
+    char *deep = _nested_objects(JUNO_MAX_NESTING + 1);
+    ASSERT_TRUE(juno_parse_ex(deep, strlen(deep), &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_NESTING && err.depth == JUNO_MAX_NESTING + 1);
+    free(deep);
+}
+
+/* Structured errors: innermost error is kept, with code, offset and depth */
+static void test_structured_error(void) {
+    const char *json = "{\"a\": [1, 2,\n  {\"b\": tru}]}";
+    JunoError err;
+    JsonNode *root = juno_parse_ex(json, strlen(json), &err);
+    ASSERT_TRUE(root == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_INVALID_LITERAL);
+    ASSERT_TRUE(err.offset == (size_t)(strstr(json, "tru") - json));
+    ASSERT_TRUE(err.depth == 3);
+
+    unsigned line = 0, col = 0;
+    juno_error_position(&err, json, strlen(json), &line, &col);
+    ASSERT_TRUE(line == 2 && col == 9);
+
+    char buf[256];
+    juno_error_format(&err, json, strlen(json), buf, sizeof(buf));
+    ASSERT_TRUE(strncmp(buf, "Parse error at 2:9", 18) == 0);
+    ASSERT_TRUE(strstr(buf, "^") != NULL);
+}
+
+static void test_structured_error_codes(void) {
+    JunoError err;
+    const char *eof = "[1, 2";
+    ASSERT_TRUE(juno_parse_ex(eof, strlen(eof), &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_UNEXPECTED_EOF && err.offset == 5);
+
+    const char *str = "[\"a\\qb\"]";
+    ASSERT_TRUE(juno_parse_ex(str, strlen(str), &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_INVALID_STRING && err.offset == 1);
+
+    const char *colon = "{\"a\" 1}";
+    ASSERT_TRUE(juno_parse_ex(colon, strlen(colon), &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_UNEXPECTED_TOKEN && err.depth == 1);
+
+    ASSERT_TRUE(juno_parse_ex(NULL, 0, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_INVALID_ARG);
+
+    /* Legacy entry point still returns an error node with the formatted message */
+    JsonNode *node = juno_parse(eof, strlen(eof));
+    ASSERT_TRUE(juno_is_error(node));
+    ASSERT_TRUE(strstr(node->value.err_msg, "1:6") != NULL);
+    juno_free_ast(node);
+}
+
+/* Streaming reader: feeds input a few bytes at a time into a tiny window */
+typedef struct {
+    const char *data;
+    size_t len, pos, chunk;
+} ChunkSource;
+
+static ptrdiff_t chunk_read(void *ud, char *buf, size_t cap) {
+    ChunkSource *src = (ChunkSource*)ud;
+    size_t n = src->len - src->pos;
+    if (n > src->chunk) n = src->chunk;
+    if (n > cap) n = cap;
+    memcpy(buf, src->data + src->pos, n);
+    src->pos += n;
+    return (ptrdiff_t)n;
+}
+
+static void test_reader_documents(void) {
+    const char *json =
+        "{\"id\": 12345678, \"name\": \"caf\\u00e9 long value\"}\n"
+        "[true, false, null, -0.25e1]\n"
+        "\"tail\"";
+    ChunkSource src = { json, strlen(json), 0, 3 };
+    JunoReader *r = juno_reader_new_cb(chunk_read, &src, 32);
+    ASSERT_TRUE(r != NULL);
+
+    JunoError err;
+    JsonNode *doc = juno_reader_next_document(r, &err);
+    ASSERT_TRUE(doc && doc->type == JND_OBJ);
+    ASSERT_TRUE(find_member(doc, "id")->value.ivalue == 12345678);
+    ASSERT_STR_EQ("caf\xc3\xa9 long value", find_member(doc, "name")->value.svalue);
+    juno_free_ast(doc);
+
+    doc = juno_reader_next_document(r, &err);
+    ASSERT_TRUE(doc && doc->type == JND_ARRAY);
+    ASSERT_TRUE(array_get(doc, 2)->type == JND_NULL);
+    ASSERT_DOUBLE_NEAR(-2.5, array_get(doc, 3)->value.nvalue, 1e-12);
+    juno_free_ast(doc);
+
+    doc = juno_reader_next_document(r, &err);
+    ASSERT_TRUE(doc && doc->type == JND_STRING);
+    ASSERT_STR_EQ("tail", doc->value.svalue);
+    juno_free_ast(doc);
+
+    ASSERT_TRUE(juno_reader_next_document(r, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_OK);
+    juno_reader_free(r);
+}
+
+static void test_reader_events(void) {
+    const char *json = "{\"a\": [1, {\"skip\": [2, 3]}], \"b\": 2}";
+    JunoReader *r = juno_reader_new_mem(json, strlen(json));
+    JunoEvent ev;
+    int64_t iv = 0;
+
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_OBJ_BEGIN && ev.depth == 1);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_KEY);
+    ASSERT_STR_EQ("a", ev.str);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_ARR_BEGIN && ev.depth == 2);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_NUMBER && juno_event_int64(&ev, &iv) && iv == 1);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_OBJ_BEGIN && ev.offset == 10);
+    ASSERT_TRUE(juno_reader_skip(r));
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_ARR_END);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_KEY);
+    ASSERT_STR_EQ("b", ev.str);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_NUMBER && ev.raw_len == 1);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_OBJ_END);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_DOC_END);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_EOF);
+    juno_reader_free(r);
+
+    /* Skipped strings are still checked. */
+    json = "[[\"\\x\"], 1]";
+    r = juno_reader_new_mem(json, strlen(json));
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_ARR_BEGIN && juno_reader_next(r, &ev) == JEV_ARR_BEGIN);
+    ASSERT_TRUE(!juno_reader_skip(r) && juno_reader_error(r)->code == JUNO_ERR_INVALID_STRING);
+    juno_reader_free(r);
+}
+
+static void test_reader_errors(void) {
+    /* A token larger than the window is reported, not silently truncated */
+    const char *big = "[\"0123456789abcdefghijklmnopqrstuvwxyz\"]";
+    ChunkSource src = { big, strlen(big), 0, 64 };
+    JunoReader *r = juno_reader_new_cb(chunk_read, &src, 16);
+    JunoError err;
+    ASSERT_TRUE(juno_reader_next_document(r, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_TOKEN_TOO_LARGE);
+    juno_reader_free(r);
+
+    /* Truncated document and grammar errors carry absolute offsets */
+    const char *bad = "{\"a\": 1} {\"b\" 2}";
+    FILE *fp = tmpfile();
+    ASSERT_TRUE(fp != NULL);
+    fwrite(bad, 1, strlen(bad), fp);
+    rewind(fp);
+    r = juno_reader_new_file(fp, 8);
+    JsonNode *doc = juno_reader_next_document(r, &err);
+    ASSERT_TRUE(doc != NULL);
+    juno_free_ast(doc);
+    ASSERT_TRUE(juno_reader_next_document(r, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_UNEXPECTED_TOKEN && err.offset == 14);
+    juno_reader_free(r);
+    fclose(fp);
+}
+
+/* Projection: only declared paths are materialized */
+static void test_projection(void) {
+    const char *json =
+        "{\"method\": \"put\", \"params\": {"
+        "  \"noise\": [1, {\"x\": \"]}\\\"\"}, 2.5e3],"
+        "  \"user\": {\"id\": 42, \"name\": \"bob\"},"
+        "  \"it\\u0065ms\": [{\"sku\": \"A\", \"qty\": 1}, 7, {\"qty\": 2}]"
+        "}, \"id\": 9}";
+    const char *paths[] = { "params.user.id", "params.items[*].sku", "id" };
+    JunoError err;
+    JunoProjection *proj = juno_projection_new(paths, 3, &err);
+    ASSERT_TRUE(proj != NULL);
+
+    JsonNode *root = juno_parse_projected(json, strlen(json), proj, &err);
+    ASSERT_TRUE(root && root->type == JND_OBJ);
+    ASSERT_TRUE(find_member(root, "method") == NULL);
+    ASSERT_TRUE(find_member(root, "id")->value.ivalue == 9);
+
+    JsonNode *params = find_member(root, "params");
+    ASSERT_TRUE(params && find_member(params, "noise") == NULL);
+    JsonNode *user = find_member(params, "user");
+    ASSERT_TRUE(user && find_member(user, "id")->value.ivalue == 42);
+    ASSERT_TRUE(find_member(user, "name") == NULL);
+
+    JsonNode *items = find_member(params, "items");
+    ASSERT_TRUE(items && items->type == JND_ARRAY);
+    ASSERT_STR_EQ("A", find_member(array_get(items, 0), "sku")->value.svalue);
+    ASSERT_TRUE(find_member(array_get(items, 0), "qty") == NULL);
+    ASSERT_TRUE(array_get(items, 1)->type == JND_OBJ && array_get(items, 1)->first_child == NULL);
+    ASSERT_TRUE(array_get(items, 2) == NULL);
+    juno_free_ast(root);
+
+    /* Skipped regions are still checked structurally */
+    const char *bad = "{\"noise\": [1, {\"x\": 2]], \"id\": 1}";
+    ASSERT_TRUE(juno_parse_projected(bad, strlen(bad), proj, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_UNEXPECTED_TOKEN && err.offset == 21);
+    juno_projection_free(proj);
+
+    /* ... and against the grammar: whatever juno_parse rejects is rejected
+     * here too, with the same code and offset. */
+    const char *id_path[] = { "a" };
+    proj = juno_projection_new(id_path, 1, &err);
+    static const char *const invalid[] = {
+        "{\"a\":1,\"b\":zzz}", "{\"a\":1,\"b\":[1 2 3]}", "{\"a\":1,\"b\":{,,}}",
+        "{\"a\":1,\"b\":\"\\q\"}", "{\"a\":1,\"b\":tru}", "{\"a\":1,\"b\":01}",
+        "{\"a\":1,\"b\":[1,]}", "{\"a\":1,\"b\":{\"k\" 1}}", "{\"a\":1,\"b\":{\"k\":1,}}",
+        "{\"a\":1,\"b\":\"\\ud800x\"}", "{\"a\":1,\"b\":\"\x01\"}", "{\"a\":1,\"b\":-}",
+        "{\"a\":1,\"b\":\"open"
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        JunoError full;
+        ASSERT_TRUE(juno_parse_ex(invalid[i], strlen(invalid[i]), &full) == NULL);
+        ASSERT_TRUE(juno_parse_projected(invalid[i], strlen(invalid[i]), proj, &err) == NULL);
+        ASSERT_TRUE(err.code == full.code && err.offset == full.offset);
+    }
+    /* Too deep a skipped value fails like juno_parse, at the container that
+     * went past JUNO_MAX_NESTING. */
+    char deep[2 * JUNO_MAX_NESTING + 32];
+    size_t dn = (size_t)sprintf(deep, "{\"a\":1,\"b\":");
+    memset(deep + dn, '[', JUNO_MAX_NESTING);
+    memset(deep + dn + JUNO_MAX_NESTING, ']', JUNO_MAX_NESTING);
+    strcpy(deep + dn + 2 * JUNO_MAX_NESTING, "}");
+    JunoError full;
+    ASSERT_TRUE(juno_parse_ex(deep, strlen(deep), &full) == NULL && full.code == JUNO_ERR_NESTING);
+    ASSERT_TRUE(juno_parse_projected(deep, strlen(deep), proj, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_NESTING && err.depth == JUNO_MAX_NESTING + 1);
+    ASSERT_TRUE(err.depth == full.depth && err.offset == full.offset);
+
+    const char *skipped = "{\"a\":1,\"b\":[true, false, null, -0.5e+3, \"\\ud83d\\ude00\\/\", {}, []]}";
+    root = juno_parse_projected(skipped, strlen(skipped), proj, &err);
+    ASSERT_TRUE(root && find_member(root, "a")->value.ivalue == 1 && find_member(root, "b") == NULL);
+    juno_free_ast(root);
+    juno_projection_free(proj);
+
+    const char *bad_paths[] = { "a.b", "a..b" };
+    ASSERT_TRUE(juno_projection_new(bad_paths, 2, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_INVALID_ARG && err.depth == 1 && err.offset == 2);
+}
+
+/* Binary images: save, mmap back and navigate in place */
+static void test_binary_roundtrip(void) {
+    const char *path = "./bin/juno_test.jub";
+    JsonNode *root = juno_parse_file("./tests/json_files_test/test_array.json");
+    ASSERT_TRUE(root && !juno_is_error(root));
+
+    JunoError err;
+    ASSERT_TRUE(juno_save_binary(root, path, &err));
+    juno_free_ast(root);
+
+    JunoBinDoc *doc = juno_load_binary(path, JUNO_BIN_VERIFY, &err);
+    ASSERT_TRUE(doc != NULL);
+
+    JunoBinRef locs = juno_bin_get(doc, juno_bin_root(doc), "locations");
+    ASSERT_TRUE(juno_bin_type(doc, locs) == JND_ARRAY);
+    ASSERT_TRUE(juno_bin_child_count(doc, locs) == 2);
+
+    JunoBinRef second = juno_bin_at(doc, locs, 1);
+    size_t len = 0;
+    ASSERT_STR_EQ("SUNNYVALE", juno_bin_string(doc, juno_bin_get(doc, second, "City"), &len));
+    ASSERT_TRUE(len == 9);
+    ASSERT_DOUBLE_NEAR(37.371991, juno_bin_double(doc, juno_bin_get(doc, second, "Latitude")), 1e-9);
+    ASSERT_TRUE(juno_bin_get(doc, second, "missing") == JUNO_BIN_NONE);
+    juno_binary_close(doc);
+
+    /* Flip one byte in the node area: the checksum must catch it */
+    FILE *fp = fopen(path, "r+b");
+    ASSERT_TRUE(fp != NULL);
+    fseek(fp, 80, SEEK_SET);
+    int c = fgetc(fp);
+    fseek(fp, 80, SEEK_SET);
+    fputc(c ^ 0x40, fp);
+    fclose(fp);
+    ASSERT_TRUE(juno_load_binary(path, JUNO_BIN_VERIFY, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_BINARY_FORMAT);
+
+    /* An empty file is a malformed image, not an I/O failure */
+    fp = fopen(path, "wb");
+    ASSERT_TRUE(fp != NULL);
+    fclose(fp);
+    ASSERT_TRUE(juno_load_binary(path, JUNO_BIN_VERIFY, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_BINARY_FORMAT);
+    remove(path);
+}
+
+static void test_binary_scalars(void) {
+    const char *json = "[-9223372036854775808, 0.5, true, null, \"\", {}]";
+    JsonNode *root = juno_parse(json, strlen(json));
+    JunoError err;
+    size_t size = 0;
+    void *image = juno_encode_binary(root, &size, &err);
+    juno_free_ast(root);
+    ASSERT_TRUE(image != NULL);
+
+    JunoBinDoc *doc = juno_open_binary(image, size, JUNO_BIN_VERIFY, &err);
+    ASSERT_TRUE(doc != NULL);
+    JunoBinRef arr = juno_bin_root(doc);
+    ASSERT_TRUE(juno_bin_is_integer(doc, juno_bin_at(doc, arr, 0)));
+    ASSERT_TRUE(juno_bin_int(doc, juno_bin_at(doc, arr, 0)) == INT64_MIN);
+    ASSERT_DOUBLE_NEAR(0.5, juno_bin_double(doc, juno_bin_at(doc, arr, 1)), 0);
+    ASSERT_TRUE(juno_bin_bool(doc, juno_bin_at(doc, arr, 2)));
+    ASSERT_TRUE(juno_bin_type(doc, juno_bin_at(doc, arr, 3)) == JND_NULL);
+    ASSERT_STR_EQ("", juno_bin_string(doc, juno_bin_at(doc, arr, 4), NULL));
+    ASSERT_TRUE(juno_bin_first_child(doc, juno_bin_at(doc, arr, 5)) == JUNO_BIN_NONE);
+    ASSERT_TRUE(juno_bin_at(doc, arr, 6) == JUNO_BIN_NONE);
+    juno_binary_close(doc);
+
+    ASSERT_TRUE(juno_open_binary(image, 16, 0, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_BINARY_FORMAT);
+    free(image);
+}
+
+/* Batch: many small documents share one arena */
+static void test_batch_parse(void) {
+    const char *docs[] = {
+        "{\"jsonrpc\": \"2.0\", \"id\": 1, \"method\": \"ping\"}",
+        "[1, 2,",
+        "{\"jsonrpc\": \"2.0\", \"id\": 2, \"params\": [\"a\\n\", null]}",
+    };
+    JunoBuffer items[3];
+    JsonNode *roots[3];
+    JunoError errs[3];
+    for (int i = 0; i < 3; i++) {
+        items[i].data = docs[i];
+        items[i].len = strlen(docs[i]);
+    }
+
+    JunoBatch *batch = juno_batch_new(256);
+    ASSERT_TRUE(batch != NULL);
+
+    for (int round = 0; round < 3; round++) {
+        ASSERT_TRUE(juno_batch_parse(batch, items, 3, roots, errs) == 2);
+        ASSERT_TRUE(roots[0] && find_member(roots[0], "id")->value.ivalue == 1);
+        ASSERT_TRUE(roots[0]->flags & JND_FLAG_ARENA);
+        ASSERT_TRUE(roots[1] == NULL && errs[1].code == JUNO_ERR_UNEXPECTED_EOF);
+        JsonNode *params = find_member(roots[2], "params");
+        ASSERT_STR_EQ("a\n", array_get(params, 0)->value.svalue);
+        ASSERT_TRUE(errs[2].code == JUNO_OK);
+        /* no-op on arena trees */
+        juno_free_ast(roots[2]);
+    }
+
+    /* The parse mode selects the parser as it does for juno_parse_opts. */
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.mode = JUNO_PARSE_MODE_DOUBLES;
+    juno_batch_set_options(batch, &opts);
+    ASSERT_TRUE(juno_batch_parse(batch, items, 3, roots, errs) == 2);
+    JsonNode *id = find_member(roots[0], "id");
+    ASSERT_TRUE(id && !id->is_integer && id->value.nvalue == 1.0);
+    JunoError single;
+    ASSERT_TRUE(juno_parse_opts(docs[1], strlen(docs[1]), &opts, &single) == NULL);
+    ASSERT_TRUE(errs[1].code == single.code && errs[1].offset == single.offset);
+    juno_batch_free(batch);
+}
+
+static void test_arena_parse(void) {
+    JunoArena *arena = juno_arena_new(64);
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.arena = arena;
+
+    const char *json = "{\"k\": \"a long enough string to need its own chunk of the arena\"}";
+    JunoError err;
+    JsonNode *root = juno_parse_opts(json, strlen(json), &opts, &err);
+    ASSERT_TRUE(root && root->type == JND_OBJ);
+    ASSERT_STR_EQ("a long enough string to need its own chunk of the arena", find_member(root, "k")->value.svalue);
+    size_t used = juno_arena_used(arena);
+    ASSERT_TRUE(used > 0);
+
+    /* A failed parse gives its allocations back */
+    const char *bad = "[\"x\", \"y\", ";
+    ASSERT_TRUE(juno_parse_opts(bad, strlen(bad), &opts, &err) == NULL);
+    ASSERT_TRUE(juno_arena_used(arena) == used);
+
+    juno_arena_reset(arena);
+    ASSERT_TRUE(juno_arena_used(arena) == 0);
+    juno_arena_free(arena);
+}
+
+/* Statistics and tracing hooks */
+typedef struct {
+    int begins, ends;
+    size_t nodes_seen;
+    JunoErrorCode last_code;
+} HookLog;
+
+static void hook_begin(void *ud, const char *json, size_t len) {
+    (void)json; (void)len;
+    ((HookLog*)ud)->begins++;
+}
+
+static void hook_end(void *ud, const JunoStats *stats, const JunoError *err) {
+    HookLog *log = (HookLog*)ud;
+    log->ends++;
+    log->nodes_seen = stats ? stats->nodes[JND_STRING] : 0;
+    log->last_code = err->code;
+}
+
+static void test_parse_stats(void) {
+    const char *json = "{\"a\": \"x\\n\", \"b\": [1, 2.5, true, null], \"c\": {\"d\": \"plain\"}} ";
+    JunoStats stats;
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.stats = &stats;
+
+    JunoError err;
+    JsonNode *root = juno_parse_opts(json, strlen(json), &opts, &err);
+    ASSERT_TRUE(root != NULL);
+    juno_free_ast(root);
+
+    ASSERT_TRUE(stats.nodes[JND_OBJ] == 2 && stats.nodes[JND_ARRAY] == 1);
+    ASSERT_TRUE(stats.nodes[JND_STRING] == 2 && stats.nodes[JND_NUMBER] == 2);
+    ASSERT_TRUE(stats.nodes[JND_BOOL] == 1 && stats.nodes[JND_NULL] == 1);
+    ASSERT_TRUE(stats.max_depth == 2);
+    ASSERT_TRUE(stats.escaped_strings == 1 && stats.string_bytes == 11);
+    ASSERT_TRUE(stats.integers == 1 && stats.doubles == 1);
+    ASSERT_TRUE(stats.bytes_consumed == strlen(json) - 1);
+    ASSERT_TRUE(stats.alloc_count >= 13 && stats.alloc_bytes > 9 * sizeof(JsonNode));
+    ASSERT_TRUE(stats.total_cycles >= stats.lex_cycles + stats.decode_cycles);
+
+    HookLog log = { 0, 0, 0, JUNO_OK };
+    JunoHooks hooks = { hook_begin, hook_end, &log };
+    opts.stats = NULL;
+    opts.hooks = &hooks;
+    root = juno_parse_opts(json, strlen(json), &opts, &err);
+    juno_free_ast(root);
+    ASSERT_TRUE(juno_parse_opts("[1,", 3, &opts, &err) == NULL);
+    ASSERT_TRUE(log.begins == 2 && log.ends == 2);
+    ASSERT_TRUE(log.nodes_seen == 0 && log.last_code == JUNO_ERR_UNEXPECTED_EOF);
+}
+
+/* Builder / mutation API */
+static void test_builder(void) {
+    JsonNode *resp = juno_new_object(NULL);
+    JsonNode *result = juno_new_array(NULL);
+    ASSERT_TRUE(resp && result);
+    ASSERT_TRUE(juno_obj_append(NULL, resp, "jsonrpc", juno_new_string(NULL, "2.0", 3)));
+    ASSERT_TRUE(juno_obj_append(NULL, resp, "id", juno_new_int(NULL, 7)));
+    for (int i = 0; i < 3; i++) ASSERT_TRUE(juno_array_append(result, juno_new_int(NULL, i)));
+    ASSERT_TRUE(juno_array_append(result, juno_new_double(NULL, 0.5)));
+    ASSERT_TRUE(juno_obj_append(NULL, resp, "result", result));
+    ASSERT_TRUE(juno_obj_append(NULL, resp, "error", juno_new_null(NULL)));
+
+    /* Replace in place, remove, then append after the removed tail. */
+    ASSERT_TRUE(juno_obj_set(NULL, resp, "id", juno_new_string(NULL, "x", 1)));
+    JsonNode *gone = juno_obj_remove(resp, "error");
+    ASSERT_TRUE(gone && gone->type == JND_NULL && juno_obj_get(resp, "error") == NULL);
+    juno_free_ast(gone);
+    ASSERT_TRUE(juno_obj_set(NULL, resp, "ok", juno_new_bool(NULL, true)));
+
+    char *text = juno_stringify(resp, NULL, NULL);
+    ASSERT_STR_EQ("{\"jsonrpc\":\"2.0\",\"id\":\"x\",\"result\":[0,1,2,0.5],\"ok\":true}", text);
+    free(text);
+
+    /* Move a subtree between documents: same allocator by detaching, other
+     * allocator by cloning. */
+    const char *src = "{\"keep\": [1, {\"k\": \"v\"}]}";
+    JsonNode *other = juno_parse(src, strlen(src));
+    ASSERT_TRUE(other && !juno_is_error(other));
+    JsonNode *keep = juno_detach(other, juno_obj_get(other, "keep"));
+    ASSERT_TRUE(keep && other->first_child == NULL);
+    ASSERT_TRUE(juno_array_append(result, keep) && keep->key == NULL);
+    JsonNode *one = juno_new_int(NULL, 1);
+    ASSERT_TRUE(juno_array_append(other, one) == false);
+    juno_free_ast(one);
+    juno_free_ast(other);
+
+    /* Containers linked by hand: value.last_child is ignored without
+     * JND_FLAG_TAIL, and a parsed array relinked by hand appends after its
+     * real tail once the flag is cleared. */
+    JsonNode *hand = juno_new_array(NULL);
+    JsonNode *h0 = juno_new_int(NULL, 0), *stray = juno_new_int(NULL, 9);
+    hand->first_child = h0;
+    hand->value.last_child = stray;
+    ASSERT_TRUE(juno_array_append(hand, juno_new_int(NULL, 1)));
+    ASSERT_TRUE(stray->next_sibling == NULL && h0->next_sibling && h0->next_sibling->value.ivalue == 1);
+    ASSERT_TRUE((hand->flags & JND_FLAG_TAIL) && hand->value.last_child == h0->next_sibling);
+    juno_free_ast(stray);
+    juno_free_ast(hand);
+
+    JsonNode *rev = juno_parse("[1,2,3]", 7);
+    ASSERT_TRUE(rev && (rev->flags & JND_FLAG_TAIL));
+    JsonNode *r1 = rev->first_child, *r2 = r1->next_sibling, *r3 = r2->next_sibling;
+    rev->first_child = r3;
+    r3->next_sibling = r2;
+    r2->next_sibling = r1;
+    r1->next_sibling = NULL;
+    rev->flags &= ~JND_FLAG_TAIL;
+    ASSERT_TRUE(juno_array_append(rev, juno_new_int(NULL, 4)));
+    text = juno_stringify(rev, NULL, NULL);
+    ASSERT_STR_EQ("[3,2,1,4]", text);
+    free(text);
+    juno_free_ast(rev);
+
+    JunoArena *arena = juno_arena_new(0);
+    JsonNode *copy = juno_clone(arena, resp);
+    ASSERT_TRUE(copy && (copy->flags & JND_FLAG_ARENA));
+    ASSERT_TRUE(juno_obj_set(arena, copy, "id", juno_new_int(arena, 8)));
+    ASSERT_TRUE(juno_obj_append(NULL, copy, "bad", juno_new_int(arena, 0)) == false);
+    juno_free_ast(resp);
+
+    text = juno_stringify(copy, NULL, NULL);
+    ASSERT_STR_EQ("{\"jsonrpc\":\"2.0\",\"id\":8,\"result\":[0,1,2,0.5,[1,{\"k\":\"v\"}]],\"ok\":true}", text);
+    free(text);
+    juno_arena_free(arena);
+}
+
+/* Serializer */
+static int sink_calls = 0;
+static bool refusing_sink(void *ud, const char *data, size_t len) {
+    (void)ud; (void)data; (void)len;
+    sink_calls++;
+    return false;
+}
+
+static void test_stringify(void) {
+    const char *json = "{\"s\": \"q\\\" b\\\\ \\n\\u0001 caf\u00e9\", \"n\": [-0, 1e300, 0.1, 3.0, -9223372036854775808], \"e\": {}, \"a\": []}";
+    JunoError err;
+    JsonNode *root = juno_parse_ex(json, strlen(json), &err);
+    ASSERT_TRUE(root != NULL);
+
+    size_t len = 0;
+    char *text = juno_stringify(root, &len, &err);
+    ASSERT_TRUE(text && err.code == JUNO_OK && len == strlen(text));
+    ASSERT_STR_EQ("{\"s\":\"q\\\" b\\\\ \\n\\u0001 caf\u00e9\",\"n\":[0,1e+300,0.1,3.0,-9223372036854775808],\"e\":{},\"a\":[]}", text);
+
+    /* Output parses back to the same text. */
+    JsonNode *again = juno_parse_ex(text, len, &err);
+    char *text2 = juno_stringify(again, NULL, NULL);
+    ASSERT_STR_EQ(text, text2);
+    free(text);
+    free(text2);
+    juno_free_ast(again);
+
+    ASSERT_TRUE(juno_write(root, refusing_sink, NULL, &err) == false);
+    ASSERT_TRUE(err.code == JUNO_ERR_IO && sink_calls == 1);
+    juno_free_ast(root);
+
+    JsonNode *bad = juno_new_double(NULL, 1.0 / 0.0);
+    ASSERT_TRUE(juno_stringify(bad, NULL, &err) == NULL && err.code == JUNO_ERR_INVALID_NUMBER);
+    juno_free_ast(bad);
+}
+
+/* Frozen, reference-counted documents */
+static void test_frozen_doc(void) {
+    const char *v1 = "{\"version\": 1, \"hosts\": [\"a\", \"b\"]}";
+    JunoError err;
+    JunoDoc *doc = juno_doc_parse(v1, strlen(v1), &err);
+    ASSERT_TRUE(doc && err.code == JUNO_OK);
+    ASSERT_TRUE(juno_doc_root(doc)->first_child->flags & JND_FLAG_ARENA);
+
+    ASSERT_TRUE(juno_doc_parse("{\"x\":", 5, &err) == NULL && err.code == JUNO_ERR_UNEXPECTED_EOF);
+
+    JunoDocSlot *slot = juno_doc_slot_new(doc);
+    JunoDoc *snap = juno_doc_slot_acquire(slot);
+    ASSERT_TRUE(snap == doc);
+
+    /* Publish a new version built in memory; the reader's snapshot survives. */
+    JsonNode *tree = juno_new_object(NULL);
+    juno_obj_append(NULL, tree, "version", juno_new_int(NULL, 2));
+    JunoDoc *doc2 = juno_doc_freeze(tree, &err);
+    juno_free_ast(tree);
+    ASSERT_TRUE(doc2 != NULL);
+    juno_doc_slot_publish(slot, doc2);
+
+    ASSERT_TRUE(juno_obj_get(juno_doc_root(snap), "version")->value.ivalue == 1);
+    ASSERT_STR_EQ("b", juno_obj_get(juno_doc_root(snap), "hosts")->first_child->next_sibling->value.svalue);
+    juno_doc_release(snap);
+
+    JunoDoc *cur = juno_doc_slot_acquire(slot);
+    ASSERT_TRUE(juno_obj_get(juno_doc_root(cur), "version")->value.ivalue == 2);
+    juno_doc_slot_free(slot);
+    ASSERT_TRUE(juno_doc_root(cur)->first_child->value.ivalue == 2);
+    juno_doc_release(juno_doc_retain(cur));
+    juno_doc_release(cur);
+}
+
+/* Lazy numbers and arbitrary-precision passthrough */
+static void test_lazy_numbers(void) {
+    const char *json = "{\"id\": 340282366920938463463374607431768211455, \"price\": 19.990000000000000001,"
+                       " \"n\": -42, \"u\": 18446744073709551615, \"big\": 1e400}";
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.flags = JUNO_PARSE_LAZY_NUMBERS;
+
+    JunoError err;
+    JsonNode *root = juno_parse_opts(json, strlen(json), &opts, &err);
+    ASSERT_TRUE(root != NULL);
+
+    JsonNode *id = juno_obj_get(root, "id");
+    size_t len = 0;
+    ASSERT_TRUE((id->flags & JND_FLAG_RAW_NUMBER) && id->is_integer);
+    ASSERT_STR_EQ("340282366920938463463374607431768211455", juno_number_raw(id, &len));
+    ASSERT_TRUE(len == 39);
+
+    int64_t iv = 0;
+    uint64_t uv = 0;
+    double dv = 0.0;
+    ASSERT_TRUE(!juno_number_int64(id, &iv) && !juno_number_uint64(id, &uv));
+    ASSERT_TRUE(juno_number_double(id, &dv) && dv > 3.4e38);
+    ASSERT_TRUE(juno_number_int64(juno_obj_get(root, "n"), &iv) && iv == -42);
+    ASSERT_TRUE(!juno_number_uint64(juno_obj_get(root, "n"), &uv));
+    ASSERT_TRUE(juno_number_uint64(juno_obj_get(root, "u"), &uv) && uv == UINT64_MAX);
+    ASSERT_TRUE(!juno_number_int64(juno_obj_get(root, "price"), &iv));
+    ASSERT_TRUE(!juno_number_double(juno_obj_get(root, "big"), &dv));
+
+    /* Byte-for-byte round trip, also through a clone and a built node. */
+    JsonNode *copy = juno_clone(NULL, root);
+    juno_obj_append(NULL, copy, "amount", juno_new_number_text(NULL, "-0.10E+2", 8));
+    ASSERT_TRUE(juno_new_number_text(NULL, "01", 2) == NULL && juno_new_number_text(NULL, "1 ", 2) == NULL);
+    char *text = juno_stringify(copy, NULL, NULL);
+    ASSERT_STR_EQ("{\"id\":340282366920938463463374607431768211455,\"price\":19.990000000000000001,"
+                  "\"n\":-42,\"u\":18446744073709551615,\"big\":1e400,\"amount\":-0.10E+2}", text);
+    free(text);
+    juno_free_ast(copy);
+    juno_free_ast(root);
+
+    /* Getters on converted numbers. */
+    root = juno_parse_ex("[-9223372036854775808, 2.5]", 27, &err);
+    ASSERT_TRUE(juno_number_raw(root->first_child, NULL) == NULL);
+    ASSERT_TRUE(juno_number_int64(root->first_child, &iv) && iv == INT64_MIN);
+    ASSERT_TRUE(juno_number_double(root->first_child->next_sibling, &dv) && dv == 2.5);
+    juno_free_ast(root);
+}
+
+/* Structural hashing and deep equality */
+static void test_hash_equal(void) {
+    const char *ta = "{\"a\": 1, \"b\": [1, 2.0, \"x\"], \"c\": {\"d\": null, \"e\": true}}";
+    const char *tb = "{\"c\": {\"e\": true, \"d\": null}, \"b\": [1.0, 2, \"x\"], \"a\": 1e0}";
+    JunoError err;
+    JsonNode *a = juno_parse_ex(ta, strlen(ta), &err);
+    JsonNode *b = juno_parse_ex(tb, strlen(tb), &err);
+    ASSERT_TRUE(a && b);
+    ASSERT_TRUE(juno_equal(a, b) && juno_hash(a) == juno_hash(b));
+
+    /* Streaming, lazy-number and binary representations agree. */
+    uint64_t h = 0;
+    ASSERT_TRUE(juno_hash_buffer(tb, strlen(tb), &h, &err) && h == juno_hash(a));
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.flags = JUNO_PARSE_LAZY_NUMBERS;
+    JsonNode *lazy = juno_parse_opts(tb, strlen(tb), &opts, &err);
+    ASSERT_TRUE(juno_equal(a, lazy) && juno_hash(lazy) == h);
+    juno_free_ast(lazy);
+
+    /* Beyond int64 numbers compare by value, lazy or not: equality stays
+     * transitive and independent of JUNO_PARSE_LAZY_NUMBERS. */
+    const char *wide = "[10000000000000000000, 10000000000000000001, 1e19]";
+    JsonNode *eager = juno_parse_ex(wide, strlen(wide), &err);
+    lazy = juno_parse_opts(wide, strlen(wide), &opts, &err);
+    ASSERT_TRUE(eager && lazy && juno_equal(eager, lazy) && juno_hash(eager) == juno_hash(lazy));
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            ASSERT_TRUE(juno_equal(array_get(lazy, i), array_get(lazy, j)));
+            ASSERT_TRUE(juno_equal(array_get(lazy, i), array_get(eager, j)));
+        }
+    }
+    juno_free_ast(eager);
+    juno_free_ast(lazy);
+
+    size_t size = 0;
+    void *image = juno_encode_binary(b, &size, &err);
+    JunoBinDoc *doc = juno_open_binary(image, size, 0, &err);
+    ASSERT_TRUE(doc && juno_bin_hash(doc, juno_bin_root(doc)) == h);
+    ASSERT_TRUE(juno_bin_equal(doc, juno_bin_root(doc), doc, juno_bin_root(doc)));
+    ASSERT_TRUE(!juno_bin_equal(doc, juno_bin_root(doc), doc, juno_bin_get(doc, juno_bin_root(doc), "c")));
+    juno_binary_close(doc);
+    free(image);
+
+    /* Order matters in arrays, not in objects; duplicates pair one to one. */
+    JsonNode *x = juno_parse("[1, 2]", 6), *y = juno_parse("[2, 1]", 6);
+    ASSERT_TRUE(!juno_equal(x, y) && juno_hash(x) != juno_hash(y));
+    juno_free_ast(x);
+    juno_free_ast(y);
+    x = juno_parse("{\"a\": 1, \"a\": 2}", 16);
+    y = juno_parse("{\"a\": 2, \"a\": 1}", 16);
+    JsonNode *z = juno_parse("{\"a\": 1, \"a\": 1}", 16);
+    ASSERT_TRUE(juno_equal(x, y) && !juno_equal(x, z) && !juno_equal(z, x));
+    juno_free_ast(x);
+    juno_free_ast(y);
+    juno_free_ast(z);
+
+    /* Large objects take the sorted path. */
+    char big1[2048], big2[2048];
+    size_t n1 = 0, n2 = 0;
+    big1[n1++] = big2[n2++] = '{';
+    for (int i = 0; i < 40; i++) {
+        n1 += (size_t)sprintf(big1 + n1, "%s\"k%d\": %d", i ? ", " : "", i, i);
+        n2 += (size_t)sprintf(big2 + n2, "%s\"k%d\": %d", i ? ", " : "", 39 - i, 39 - i);
+    }
+    big1[n1++] = big2[n2++] = '}';
+    x = juno_parse_ex(big1, n1, &err);
+    y = juno_parse_ex(big2, n2, &err);
+    ASSERT_TRUE(x && y && juno_equal(x, y) && juno_hash(x) == juno_hash(y));
+    juno_obj_set(NULL, y, "k7", juno_new_int(NULL, 8));
+    ASSERT_TRUE(!juno_equal(x, y) && juno_hash(x) != juno_hash(y));
+    juno_free_ast(x);
+    juno_free_ast(y);
+
+    ASSERT_TRUE(!juno_hash_buffer("[1,", 3, &h, &err) && err.code == JUNO_ERR_UNEXPECTED_EOF);
+    ASSERT_TRUE(!juno_hash_buffer("1 2", 3, &h, &err) && err.code == JUNO_ERR_UNEXPECTED_TOKEN);
+    juno_free_ast(a);
+    juno_free_ast(b);
+}
+
+/* Canonical JSON (RFC 8785) */
+static bool collect_sink(void *ud, const char *data, size_t len) {
+    char *out = (char*)ud;
+    size_t n = strlen(out);
+    memcpy(out + n, data, len);
+    out[n + len] = '\0';
+    return true;
+}
+
+static void test_canonical(void) {
+    /* RFC 8785 section 3.2.2 example. */
+    const char *in = "{\"numbers\": [333333333.33333329, 1E30, 4.50, 2e-3, 0.000000000000000000000000001],"
+                     " \"string\": \"\\u20ac$\\u000F\\u000aA'\\u0042\\u0022\\u005c\\\\\\\"\\/\","
+                     " \"literals\": [null, true, false]}";
+    const char *want = "{\"literals\":[null,true,false],\"numbers\":[333333333.3333333,1e+30,4.5,0.002,1e-27],"
+                       "\"string\":\"\xe2\x82\xac$\\u000f\\nA'B\\\"\\\\\\\\\\\"/\"}";
+    JunoError err;
+    JsonNode *root = juno_parse_ex(in, strlen(in), &err);
+    ASSERT_TRUE(root != NULL);
+    char *text = juno_stringify_canonical(root, NULL, &err);
+    ASSERT_STR_EQ(want, text);
+    free(text);
+    juno_free_ast(root);
+
+    char out[512] = "";
+    ASSERT_TRUE(juno_canonicalize(in, strlen(in), collect_sink, out, &err));
+    ASSERT_STR_EQ(want, out);
+
+    /* Section 3.2.3: members sorted by UTF-16 code units. */
+    in = "{\"\\u20ac\": 1, \"\\r\": 2, \"\\ufb33\": 3, \"1\": 4, \"\\ud83d\\ude00\": 5, \"\\u0080\": 6, \"\\u00f6\": 7}";
+    want = "{\"\\r\":2,\"1\":4,\"\xc2\x80\":6,\"\xc3\xb6\":7,\"\xe2\x82\xac\":1,\"\xf0\x9f\x98\x80\":5,\"\xef\xac\xb3\":3}";
+    root = juno_parse_ex(in, strlen(in), &err);
+    text = juno_stringify_canonical(root, NULL, &err);
+    ASSERT_STR_EQ(want, text);
+    free(text);
+    juno_free_ast(root);
+    out[0] = '\0';
+    ASSERT_TRUE(juno_canonicalize(in, strlen(in), collect_sink, out, &err));
+    ASSERT_STR_EQ(want, out);
+
+    /* ECMAScript number formatting, nesting and large objects. */
+    in = "[1e21, 1e20, -0, 0.000001, 1e-7, 9007199254740993, 123456789012345680000,"
+         " {\"b\": {\"z\": [], \"y\": {}}, \"a\": [{\"k\": 1, \"j\": 2}]}]";
+    want = "[1e+21,100000000000000000000,0,0.000001,1e-7,9007199254740992,123456789012345680000,"
+           "{\"a\":[{\"j\":2,\"k\":1}],\"b\":{\"y\":{},\"z\":[]}}]";
+    out[0] = '\0';
+    ASSERT_TRUE(juno_canonicalize(in, strlen(in), collect_sink, out, &err));
+    ASSERT_STR_EQ(want, out);
+    root = juno_parse_ex(in, strlen(in), &err);
+    text = juno_stringify_canonical(root, NULL, &err);
+    ASSERT_STR_EQ(want, text);
+    free(text);
+    juno_free_ast(root);
+
+    char big[1024];
+    size_t n = 0;
+    big[n++] = '{';
+    for (int i = 29; i >= 0; i--) n += (size_t)sprintf(big + n, "\"k%02d\":%d%s", i, i, i ? "," : "");
+    big[n++] = '}';
+    big[n] = '\0';
+    out[0] = '\0';
+    ASSERT_TRUE(juno_canonicalize(big, n, collect_sink, out, &err));
+    ASSERT_TRUE(strncmp(out, "{\"k00\":0,\"k01\":1,\"k02\":2,", 25) == 0);
+
+    /* Errors: duplicates, bad input, trailing data. */
+    const char *dup = "{\"a\":1,\"a\":2}", *unclosed = "{\"a\":[1,}";
+    ASSERT_TRUE(!juno_canonicalize(dup, strlen(dup), collect_sink, out, &err));
+    ASSERT_TRUE(err.code == JUNO_ERR_INVALID_ARG && err.offset == 11);
+    ASSERT_TRUE(!juno_canonicalize(unclosed, strlen(unclosed), collect_sink, out, &err) && err.offset == 8);
+    ASSERT_TRUE(!juno_canonicalize("1 2", 3, collect_sink, out, &err) && err.code == JUNO_ERR_UNEXPECTED_TOKEN);
+}
+
+/* JSON Patch / Merge Patch / diff */
+static bool patch_case(const char *doc, const char *patch, JunoIndex *idx, const char *want, JunoErrorCode code) {
+    JunoError err;
+    JsonNode *root = juno_parse_ex(doc, strlen(doc), &err);
+    JsonNode *ops = juno_parse_ex(patch, strlen(patch), &err);
+    char *before = juno_stringify(root, NULL, &err);
+    bool ok = juno_patch_apply(NULL, &root, ops, idx, &err) == (code == JUNO_OK) && err.code == code;
+    char *after = juno_stringify(root, NULL, &err);
+    /* A failed patch leaves the document untouched. */
+    ok = ok && after && strcmp(after, want ? want : before) == 0;
+    free(before);
+    free(after);
+    juno_index_clear(idx);
+    juno_free_ast(ops);
+    juno_free_ast(root);
+    return ok;
+}
+
+static void test_patch(void) {
+    JunoIndex *idx = juno_index_new();
+    ASSERT_TRUE(idx != NULL);
+    for (int pass = 0; pass < 2; pass++) {
+        JunoIndex *ix = pass ? idx : NULL;
+        /* RFC 6902 appendix A. */
+        ASSERT_TRUE(patch_case("{\"foo\":\"bar\"}", "[{\"op\":\"add\",\"path\":\"/baz\",\"value\":\"qux\"}]", ix,
+                               "{\"foo\":\"bar\",\"baz\":\"qux\"}", JUNO_OK));
+        ASSERT_TRUE(patch_case("{\"foo\":[\"bar\",\"baz\"]}", "[{\"op\":\"add\",\"path\":\"/foo/1\",\"value\":\"qux\"}]", ix,
+                               "{\"foo\":[\"bar\",\"qux\",\"baz\"]}", JUNO_OK));
+        ASSERT_TRUE(patch_case("{\"baz\":\"qux\",\"foo\":\"bar\"}", "[{\"op\":\"remove\",\"path\":\"/baz\"}]", ix,
+                               "{\"foo\":\"bar\"}", JUNO_OK));
+        ASSERT_TRUE(patch_case("{\"baz\":\"qux\",\"foo\":\"bar\"}", "[{\"op\":\"replace\",\"path\":\"/baz\",\"value\":\"boo\"}]", ix,
+                               "{\"baz\":\"boo\",\"foo\":\"bar\"}", JUNO_OK));
+        ASSERT_TRUE(patch_case("{\"foo\":{\"bar\":\"baz\",\"waldo\":\"fred\"},\"qux\":{\"corge\":\"grault\"}}",
+                               "[{\"op\":\"move\",\"from\":\"/foo/waldo\",\"path\":\"/qux/thud\"}]", ix,
+                               "{\"foo\":{\"bar\":\"baz\"},\"qux\":{\"corge\":\"grault\",\"thud\":\"fred\"}}", JUNO_OK));
+        ASSERT_TRUE(patch_case("{\"foo\":[\"all\",\"grass\",\"cows\",\"eat\"]}", "[{\"op\":\"move\",\"from\":\"/foo/1\",\"path\":\"/foo/3\"}]", ix,
+                               "{\"foo\":[\"all\",\"cows\",\"eat\",\"grass\"]}", JUNO_OK));
+        ASSERT_TRUE(patch_case("{\"foo\":[\"bar\"]}", "[{\"op\":\"add\",\"path\":\"/foo/-\",\"value\":[\"abc\",\"def\"]}]", ix,
+                               "{\"foo\":[\"bar\",[\"abc\",\"def\"]]}", JUNO_OK));
+        ASSERT_TRUE(patch_case("{\"/\":1,\"~\":2}", "[{\"op\":\"copy\",\"from\":\"/~1\",\"path\":\"/~0~1\"},{\"op\":\"test\",\"path\":\"/~0~1\",\"value\":1.0}]", ix,
+                               "{\"/\":1,\"~\":2,\"~/\":1}", JUNO_OK));
+        ASSERT_TRUE(patch_case("[1]", "[{\"op\":\"replace\",\"path\":\"\",\"value\":{\"a\":[]}},{\"op\":\"add\",\"path\":\"/a/0\",\"value\":2}]", ix,
+                               "{\"a\":[2]}", JUNO_OK));
+
+        /* Failures roll back every earlier operation. */
+        ASSERT_TRUE(patch_case("{\"a\":{\"b\":[1,2]},\"c\":3}",
+                               "[{\"op\":\"remove\",\"path\":\"/c\"},{\"op\":\"move\",\"from\":\"/a/b/0\",\"path\":\"/x\"},"
+                               "{\"op\":\"replace\",\"path\":\"\",\"value\":null},{\"op\":\"test\",\"path\":\"\",\"value\":false}]", ix,
+                               NULL, JUNO_ERR_TEST_FAILED));
+        ASSERT_TRUE(patch_case("{\"a\":[1]}", "[{\"op\":\"add\",\"path\":\"/a/-\",\"value\":2},{\"op\":\"add\",\"path\":\"/a/3\",\"value\":3}]", ix,
+                               NULL, JUNO_ERR_PATH_NOT_FOUND));
+        ASSERT_TRUE(patch_case("{\"a\":{}}", "[{\"op\":\"move\",\"from\":\"/a\",\"path\":\"/a/b\"}]", ix, NULL, JUNO_ERR_INVALID_ARG));
+        ASSERT_TRUE(patch_case("[0]", "[{\"op\":\"remove\",\"path\":\"/01\"}]", ix, NULL, JUNO_ERR_PATH_NOT_FOUND));
+        ASSERT_TRUE(patch_case("[0]", "[{\"op\":\"frobnicate\",\"path\":\"\"}]", ix, NULL, JUNO_ERR_INVALID_ARG));
+    }
+
+    /* Large containers go through the index; the tables follow every edit. */
+    char doc[4096];
+    size_t n = (size_t)sprintf(doc, "{\"list\":[");
+    for (int i = 0; i < 100; i++) n += (size_t)sprintf(doc + n, "%s%d", i ? "," : "", i);
+    n += (size_t)sprintf(doc + n, "]");
+    for (int i = 0; i < 100; i++) n += (size_t)sprintf(doc + n, ",\"k%d\":%d", i, i);
+    sprintf(doc + n, "}");
+    JunoError err;
+    JsonNode *root = juno_parse_ex(doc, strlen(doc), &err);
+    const char *ops = "[{\"op\":\"remove\",\"path\":\"/k50\"},{\"op\":\"remove\",\"path\":\"/list/50\"},"
+                      "{\"op\":\"add\",\"path\":\"/list/0\",\"value\":-1},{\"op\":\"replace\",\"path\":\"/k51\",\"value\":\"x\"},"
+                      "{\"op\":\"move\",\"from\":\"/k52\",\"path\":\"/list/-\"},{\"op\":\"test\",\"path\":\"/list/100\",\"value\":52}]";
+    JsonNode *patch = juno_parse_ex(ops, strlen(ops), &err);
+    ASSERT_TRUE(juno_patch_apply(NULL, &root, patch, idx, &err));
+    ASSERT_TRUE(juno_pointer_get(idx, root, "/k50") == NULL && juno_pointer_get(idx, root, "/k52") == NULL);
+    ASSERT_TRUE(juno_pointer_get(idx, root, "/list/0")->value.ivalue == -1);
+    ASSERT_TRUE(juno_pointer_get(idx, root, "/list/51")->value.ivalue == 51);
+    ASSERT_STR_EQ("x", juno_pointer_get(idx, root, "/k51")->value.svalue);
+    ASSERT_TRUE(juno_pointer_get(idx, root, "/k53")->value.ivalue == 53);
+    ASSERT_TRUE(juno_pointer_get(NULL, root, "/list/100") == juno_pointer_get(idx, root, "/list/100"));
+
+    /* Undo through the index, then keep using it. */
+    const char *bad = "[{\"op\":\"remove\",\"path\":\"/k53\"},{\"op\":\"remove\",\"path\":\"/list/0\"},{\"op\":\"remove\",\"path\":\"/nope\"}]";
+    JsonNode *bp = juno_parse_ex(bad, strlen(bad), &err);
+    ASSERT_TRUE(!juno_patch_apply(NULL, &root, bp, idx, &err) && err.offset == 2);
+    ASSERT_TRUE(juno_pointer_get(idx, root, "/k53")->value.ivalue == 53);
+    ASSERT_TRUE(juno_pointer_get(idx, root, "/list/0")->value.ivalue == -1);
+    ASSERT_TRUE(juno_pointer_get(idx, root, "/list/100")->value.ivalue == 52);
+    juno_free_ast(bp);
+    juno_free_ast(patch);
+
+    /* Diff: applying diff(a, b) to a yields b. */
+    const char *tb = "{\"list\":[-1,0,1,2,3],\"k1\":\"one\",\"k2\":{\"a/b\":[true]},\"new\":null}";
+    JsonNode *b = juno_parse_ex(tb, strlen(tb), &err);
+    JsonNode *d = juno_diff(NULL, root, b, &err);
+    ASSERT_TRUE(d != NULL);
+    ASSERT_TRUE(juno_patch_apply(NULL, &root, d, idx, &err));
+    ASSERT_TRUE(juno_equal(root, b));
+    juno_free_ast(d);
+
+    JsonNode *x = juno_parse("[1,2,3,4,5]", 11), *y = juno_parse("[1,2,9,3,4,5]", 13);
+    d = juno_diff(NULL, x, y, &err);
+    char *text = juno_stringify(d, NULL, &err);
+    ASSERT_STR_EQ("[{\"op\":\"add\",\"path\":\"/2\",\"value\":9}]", text);
+    free(text);
+    juno_free_ast(d);
+    d = juno_diff(NULL, x, x, &err);
+    ASSERT_TRUE(d && d->first_child == NULL);
+    juno_free_ast(d);
+    juno_free_ast(x);
+    juno_free_ast(y);
+    juno_free_ast(b);
+    juno_free_ast(root);
+
+    /* Merge patch (RFC 7386), here on an arena tree. */
+    JunoArena *arena = juno_arena_new(0);
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.arena = arena;
+    const char *tt = "{\"title\":\"Goodbye!\",\"author\":{\"givenName\":\"John\",\"familyName\":\"Doe\"},"
+                     "\"tags\":[\"example\",\"sample\"],\"content\":\"This will be unchanged\"}";
+    const char *tm = "{\"title\":\"Hello!\",\"phoneNumber\":\"+01-123-456-7890\",\"author\":{\"familyName\":null},"
+                     "\"tags\":[\"example\"],\"extra\":{\"a\":null,\"b\":1}}";
+    root = juno_parse_opts(tt, strlen(tt), &opts, &err);
+    JsonNode *mp = juno_parse_ex(tm, strlen(tm), &err);
+    ASSERT_TRUE(!juno_merge_patch(NULL, &root, mp, NULL, &err) && err.code == JUNO_ERR_INVALID_ARG);
+    ASSERT_TRUE(juno_merge_patch(arena, &root, mp, idx, &err));
+    text = juno_stringify(root, NULL, &err);
+    ASSERT_STR_EQ("{\"title\":\"Hello!\",\"author\":{\"givenName\":\"John\"},\"tags\":[\"example\"],"
+                  "\"content\":\"This will be unchanged\",\"phoneNumber\":\"+01-123-456-7890\",\"extra\":{\"b\":1}}", text);
+    free(text);
+    juno_free_ast(mp);
+    juno_index_free(idx);
+    juno_arena_free(arena);
+}
+
+/* Duplicate member names */
+static void test_duplicate_keys(void) {
+    const char *small = "{\"a\": 1, \"b\": {\"x\": 1}, \"a\": [2]}";
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    JunoError err;
+
+    JsonNode *root = juno_parse_opts(small, strlen(small), &opts, &err);
+    char *text = juno_stringify(root, NULL, &err);
+    ASSERT_STR_EQ("{\"a\":1,\"b\":{\"x\":1},\"a\":[2]}", text);
+    free(text);
+    juno_free_ast(root);
+
+    opts.duplicates = JUNO_DUP_REJECT;
+    ASSERT_TRUE(juno_parse_opts(small, strlen(small), &opts, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_DUPLICATE_KEY && err.offset == 24);
+
+    opts.duplicates = JUNO_DUP_FIRST;
+    root = juno_parse_opts(small, strlen(small), &opts, &err);
+    text = juno_stringify(root, NULL, &err);
+    ASSERT_STR_EQ("{\"a\":1,\"b\":{\"x\":1}}", text);
+    free(text);
+    juno_free_ast(root);
+
+    opts.duplicates = JUNO_DUP_LAST;
+    root = juno_parse_opts(small, strlen(small), &opts, &err);
+    text = juno_stringify(root, NULL, &err);
+    ASSERT_STR_EQ("{\"a\":[2],\"b\":{\"x\":1}}", text);
+    free(text);
+    juno_free_ast(root);
+
+    /* Wide objects switch to the hash set; nested wide objects stack theirs. */
+    char wide[8192];
+    size_t n = (size_t)sprintf(wide, "{");
+    for (int i = 0; i < 200; i++) {
+        n += (size_t)sprintf(wide + n, "%s\"k%d\":", i ? "," : "", i);
+        if (i == 100) {
+            n += (size_t)sprintf(wide + n, "{");
+            for (int j = 0; j < 40; j++) n += (size_t)sprintf(wide + n, "%s\"k%d\":%d", j ? "," : "", j, j);
+            n += (size_t)sprintf(wide + n, "}");
+        } else {
+            n += (size_t)sprintf(wide + n, "%d", i);
+        }
+    }
+    size_t open_end = n;
+    n += (size_t)sprintf(wide + n, "}");
+
+    opts.duplicates = JUNO_DUP_REJECT;
+    root = juno_parse_opts(wide, n, &opts, &err);
+    ASSERT_TRUE(root != NULL);
+    juno_free_ast(root);
+
+    sprintf(wide + open_end, ",\"k150\":-1}");
+    n = strlen(wide);
+    ASSERT_TRUE(juno_parse_opts(wide, n, &opts, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_DUPLICATE_KEY && err.offset == open_end + 1);
+
+    JunoArena *arena = juno_arena_new(0);
+    opts.arena = arena;
+    opts.duplicates = JUNO_DUP_LAST;
+    root = juno_parse_opts(wide, n, &opts, &err);
+    ASSERT_TRUE(find_member(root, "k150")->value.ivalue == -1);
+    ASSERT_TRUE(find_member(find_member(root, "k100"), "k39")->value.ivalue == 39);
+    ASSERT_TRUE(root->value.last_child == find_member(root, "k199"));
+
+    opts.duplicates = JUNO_DUP_FIRST;
+    juno_arena_reset(arena);
+    root = juno_parse_opts(wide, n, &opts, &err);
+    ASSERT_TRUE(find_member(root, "k150")->value.ivalue == 150);
+    juno_arena_free(arena);
+
+    /* Batches reuse the scratch between documents. */
+    JunoBuffer items[2] = { { small, strlen(small) }, { wide, n } };
+    JsonNode *roots[2];
+    JunoError errs[2];
+    JunoBatch *batch = juno_batch_new(0);
+    opts.arena = NULL;
+    opts.duplicates = JUNO_DUP_REJECT;
+    juno_batch_set_options(batch, &opts);
+    ASSERT_TRUE(juno_batch_parse(batch, items, 2, roots, errs) == 0);
+    ASSERT_TRUE(errs[0].code == JUNO_ERR_DUPLICATE_KEY && errs[1].code == JUNO_ERR_DUPLICATE_KEY);
+    juno_batch_free(batch);
+}
+
+/* Runtime resource limits */
+static JunoErrorCode limited_parse(const char *json, const JunoLimits *lim, JunoArena *arena) {
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.limits = lim;
+    opts.arena = arena;
+    JunoError err;
+    JsonNode *root = juno_parse_opts(json, strlen(json), &opts, &err);
+    juno_free_ast(root);
+    return err.code;
+}
+
+static void test_limits(void) {
+    const char *doc = "{\"id\": 12345, \"name\": \"\\u0041bcdef\", \"list\": [1, 2, 3, 4]}";
+    JunoLimits lim;
+    memset(&lim, 0, sizeof(lim));
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_OK);
+
+    /* Each limit at its exact edge, then one below. */
+    lim.max_input = strlen(doc);
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_OK);
+    lim.max_input--;
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_ERR_INPUT_TOO_LARGE);
+
+    memset(&lim, 0, sizeof(lim));
+    lim.max_nodes = 8;
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_OK);
+    lim.max_nodes = 7;
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_ERR_TOO_MANY_NODES);
+
+    memset(&lim, 0, sizeof(lim));
+    lim.max_string = 6;
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_OK);
+    lim.max_string = 5;
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_ERR_STRING_TOO_LONG);
+    lim.max_string = 1;
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_ERR_STRING_TOO_LONG);
+
+    memset(&lim, 0, sizeof(lim));
+    lim.max_members = 4;
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_OK);
+    lim.max_members = 3;
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_ERR_TOO_MANY_MEMBERS);
+    lim.max_members = 2;
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_ERR_TOO_MANY_MEMBERS);
+
+    memset(&lim, 0, sizeof(lim));
+    lim.max_digits = 5;
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_OK);
+    ASSERT_TRUE(limited_parse("[1e999999999999]", &lim, NULL) == JUNO_ERR_NUMBER_TOO_LONG);
+
+    memset(&lim, 0, sizeof(lim));
+    lim.max_alloc = 8 * sizeof(JsonNode) + 64;
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_OK);
+    lim.max_alloc = 8 * sizeof(JsonNode);
+    ASSERT_TRUE(limited_parse(doc, &lim, NULL) == JUNO_ERR_ALLOC_LIMIT);
+
+    /* The failing parse gives the arena back; the error names the offender. */
+    JunoArena *arena = juno_arena_new(0);
+    ASSERT_TRUE(limited_parse(doc, &lim, arena) == JUNO_ERR_ALLOC_LIMIT);
+    ASSERT_TRUE(juno_arena_used(arena) == 0);
+    juno_arena_free(arena);
+
+    memset(&lim, 0, sizeof(lim));
+    lim.max_string = 4;
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.limits = &lim;
+    JunoError err;
+    ASSERT_TRUE(juno_parse_opts(doc, strlen(doc), &opts, &err) == NULL);
+    ASSERT_TRUE(err.offset == 22 && err.depth == 1);
+
+    /* Limits report the depth of the value that tripped them. */
+    const char *nested = "[[\"abcd\"]]";
+    lim.max_string = 2;
+    ASSERT_TRUE(juno_parse_opts(nested, strlen(nested), &opts, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_STRING_TOO_LONG && err.depth == 2 && err.offset == 2);
+    memset(&lim, 0, sizeof(lim));
+    lim.max_alloc = 2 * sizeof(JsonNode);
+    ASSERT_TRUE(juno_parse_opts(nested, strlen(nested), &opts, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_ALLOC_LIMIT && err.depth == 2 && err.offset == 2);
+    memset(&lim, 0, sizeof(lim));
+    lim.max_nodes = 2;
+    ASSERT_TRUE(juno_parse_opts(nested, strlen(nested), &opts, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_TOO_MANY_NODES && err.depth == 2 && err.offset == 2);
+
+    memset(&lim, 0, sizeof(lim));
+    lim.max_input = 8;
+    ASSERT_TRUE(juno_parse_file_opts("./tests/json_files_test/test_array.json", &opts, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_INPUT_TOO_LARGE);
+}
+
+/* One token per event: depth, then key= inside objects, then {, [, }, ] or v.
+ * Containers keyed "skip" are not descended into. */
+static bool iter_trace(JunoIter *it, char *buf, size_t cap) {
+    size_t n = 0;
+    buf[0] = '\0';
+    for (JunoIterEvent ev; (ev = juno_iter_next(it)) != JUNO_ITER_END; ) {
+        if (ev == JUNO_ITER_ERROR) return false;
+        char mark = 'v';
+        if (ev == JUNO_ITER_ENTER) mark = it->type == JND_OBJ ? '{' : '[';
+        if (ev == JUNO_ITER_LEAVE) mark = it->type == JND_OBJ ? '}' : ']';
+        int w = snprintf(buf + n, cap - n, "%u%.*s%s%c ", it->depth, (int)it->key_len,
+                         it->key ? it->key : "", it->key ? "=" : "", mark);
+        if (w < 0 || (size_t)w >= cap - n) return false;
+        n += (size_t)w;
+        if (ev == JUNO_ITER_ENTER && it->key && strcmp(it->key, "skip") == 0) juno_iter_skip(it);
+    }
+    return true;
+}
+
+static void test_iter(void) {
+    const char *json = "{\"a\": [1, {\"b\": null}, []], \"skip\": {\"x\": [1, 2]}, \"c\": \"s\"}";
+    const char *expect = "0{ 1a=[ 2v 2{ 3b=v 2} 2[ 2] 1a=] 1skip={ 1skip=} 1c=v 0} ";
+    char trace[256], bin_trace[256];
+
+    JsonNode *root = juno_parse(json, strlen(json));
+    ASSERT_TRUE(root && !juno_is_error(root));
+    JunoIter it;
+    juno_iter_init(&it, root);
+    ASSERT_TRUE(iter_trace(&it, trace, sizeof(trace)));
+    ASSERT_STR_EQ(expect, trace);
+    ASSERT_TRUE(juno_iter_next(&it) == JUNO_ITER_END);
+    juno_iter_free(&it);
+
+    /* The binary image walks the same way. */
+    size_t size = 0;
+    void *image = juno_encode_binary(root, &size, NULL);
+    ASSERT_TRUE(image != NULL);
+    JunoBinDoc *doc = juno_open_binary(image, size, 0, NULL);
+    ASSERT_TRUE(doc != NULL);
+    juno_iter_init_bin(&it, doc, juno_bin_root(doc));
+    ASSERT_TRUE(iter_trace(&it, bin_trace, sizeof(bin_trace)));
+    ASSERT_STR_EQ(expect, bin_trace);
+    juno_iter_free(&it);
+    juno_binary_close(doc);
+    free(image);
+
+    /* A scalar root is a single event; NULL is an empty walk. */
+    juno_iter_init(&it, root->first_child->first_child);
+    ASSERT_TRUE(iter_trace(&it, trace, sizeof(trace)));
+    ASSERT_STR_EQ("0v ", trace);
+    juno_iter_init(&it, NULL);
+    ASSERT_TRUE(juno_iter_next(&it) == JUNO_ITER_END);
+    juno_free_ast(root);
+
+    /* Deeper than the inline path: the stack moves to the heap. */
+    JsonNode *deep = juno_new_array(NULL), *tail = deep;
+    for (int i = 0; i < 3 * JUNO_MAX_NESTING; i++) {
+        JsonNode *a = juno_new_array(NULL);
+        ASSERT_TRUE(a && juno_array_append(tail, a));
+        tail = a;
+    }
+    ASSERT_TRUE(juno_array_append(tail, juno_new_int(NULL, 7)));
+    unsigned enters = 0, leaves = 0, max_depth = 0;
+    JunoIterEvent ev;
+    juno_iter_init(&it, deep);
+    while ((ev = juno_iter_next(&it)) != JUNO_ITER_END) {
+        ASSERT_TRUE(ev != JUNO_ITER_ERROR);
+        if (ev == JUNO_ITER_ENTER) enters++;
+        if (ev == JUNO_ITER_LEAVE) leaves++;
+        if (it.depth > max_depth) max_depth = it.depth;
+    }
+    juno_iter_free(&it);
+    ASSERT_TRUE(enters == 3 * JUNO_MAX_NESTING + 1 && leaves == enters);
+    ASSERT_TRUE(max_depth == 3 * JUNO_MAX_NESTING + 1);
+
+    /* The writer walks with the iterator and still refuses what cannot parse back. */
+    JunoError err;
+    ASSERT_TRUE(juno_stringify(deep, NULL, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_NESTING);
+    juno_free_ast(deep);
+}
+
+/* Concurrent multi-file loading: results and errors per path, in order */
+static void test_parse_files(void) {
+    enum { N = 48 };
+    char names[N][64];
+    const char *paths[N];
+    JsonNode *roots[N];
+    JunoError errs[N];
+
+    /* Every 7th file is malformed, the last one does not exist. */
+    for (int i = 0; i < N; i++) {
+        snprintf(names[i], sizeof(names[i]), "./bin/juno_files_%02d.json", i);
+        paths[i] = names[i];
+        if (i == N - 1) {
+            remove(names[i]);
+            continue;
+        }
+        FILE *fp = fopen(names[i], "wb");
+        ASSERT_TRUE(fp != NULL);
+        if (i % 7 == 3) fprintf(fp, "{\"id\": %d,", i);
+        else fprintf(fp, "{\"id\": %d, \"pad\": \"%0*d\"}", i, 1 + i * 97, 0);
+        fclose(fp);
+    }
+
+    /* Both backends, one loader and several, a shallow io_uring queue. */
+    JunoFilesOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    for (unsigned run = 0; run < 6; run++) {
+        opts.backend = run < 3 ? JUNO_FILES_AUTO : JUNO_FILES_THREADS;
+        opts.threads = (run % 3) ? 8 : 1;
+        opts.queue_depth = (run % 3 == 2) ? 2 : 0;
+        ASSERT_TRUE(juno_parse_files(paths, N, &opts, roots, errs) == N - 1 - 7);
+        for (int i = 0; i < N; i++) {
+            if (i == N - 1) {
+                ASSERT_TRUE(roots[i] == NULL && errs[i].code == JUNO_ERR_IO);
+            } else if (i % 7 == 3) {
+                ASSERT_TRUE(roots[i] == NULL && errs[i].code == JUNO_ERR_UNEXPECTED_EOF);
+            } else {
+                ASSERT_TRUE(roots[i] != NULL && errs[i].code == JUNO_OK);
+                JsonNode *id = find_member(roots[i], "id");
+                ASSERT_TRUE(id && id->value.ivalue == i);
+                ASSERT_TRUE(strlen(find_member(roots[i], "pad")->value.svalue) == (size_t)(1 + i * 97));
+                juno_free_ast(roots[i]);
+            }
+        }
+    }
+
+    /* Parse options apply per file; the size limit is checked before reading. */
+    JunoLimits lim;
+    memset(&lim, 0, sizeof(lim));
+    lim.max_input = 1000;
+    JunoParseOptions popts;
+    memset(&popts, 0, sizeof(popts));
+    popts.limits = &lim;
+    opts.parse = &popts;
+    opts.threads = 0;
+    ASSERT_TRUE(juno_parse_files(paths, 12, &opts, roots, NULL) == 9);
+    ASSERT_TRUE(roots[11] == NULL && roots[10] == NULL && roots[9] != NULL);
+    for (int i = 0; i < 12; i++) juno_free_ast(roots[i]);
+
+    for (int i = 0; i < N; i++) remove(names[i]);
+    ASSERT_TRUE(juno_parse_files(paths, 0, NULL, roots, errs) == 0);
+}
+
+/* Streaming minify / pretty-print */
+static void test_reformat(void) {
+    const char *in = " { \"a\" : [ 1 , 2.50e+3 , \"x\\u0041\\n\" ] ,\n\t\"b\":{ } , \"c\" : [ ] ,"
+                     " \"d\" : { \"e\" : null , \"f\" : true } } ";
+    JunoError err;
+    char out[512] = "";
+
+    /* Tokens are copied verbatim: escapes and number spellings survive. */
+    ASSERT_TRUE(juno_reformat_buffer(in, strlen(in), 0, collect_sink, out, &err));
+    ASSERT_STR_EQ("{\"a\":[1,2.50e+3,\"x\\u0041\\n\"],\"b\":{},\"c\":[],\"d\":{\"e\":null,\"f\":true}}", out);
+
+    out[0] = '\0';
+    ASSERT_TRUE(juno_reformat_buffer(in, strlen(in), 2, collect_sink, out, &err));
+    ASSERT_STR_EQ("{\n"
+                  "  \"a\": [\n"
+                  "    1,\n"
+                  "    2.50e+3,\n"
+                  "    \"x\\u0041\\n\"\n"
+                  "  ],\n"
+                  "  \"b\": {},\n"
+                  "  \"c\": [],\n"
+                  "  \"d\": {\n"
+                  "    \"e\": null,\n"
+                  "    \"f\": true\n"
+                  "  }\n"
+                  "}", out);
+
+    /* Streams of documents through a small window, one line each. */
+    const char *ndjson = "{\"id\": 1, \"tags\": [\"alpha\", \"beta\"]}\n[ false ]\n 3 \"s\"";
+    ChunkSource src = { ndjson, strlen(ndjson), 0, 5 };
+    JunoReader *r = juno_reader_new_cb(chunk_read, &src, 16);
+    ASSERT_TRUE(r != NULL);
+    out[0] = '\0';
+    ASSERT_TRUE(juno_reformat(r, 0, collect_sink, out, &err));
+    juno_reader_free(r);
+    ASSERT_STR_EQ("{\"id\":1,\"tags\":[\"alpha\",\"beta\"]}\n[false]\n3\n\"s\"", out);
+
+    /* Invalid input is rejected with the reader's offset, even inside strings. */
+    const char *bad = "{\"a\": [1, 2,]}";
+    out[0] = '\0';
+    ASSERT_TRUE(!juno_reformat_buffer(bad, strlen(bad), 0, collect_sink, out, &err));
+    ASSERT_TRUE(err.code == JUNO_ERR_UNEXPECTED_TOKEN && err.offset == 12);
+    bad = "[\"\\q\"]";
+    out[0] = '\0';
+    ASSERT_TRUE(!juno_reformat_buffer(bad, strlen(bad), 4, collect_sink, out, &err));
+    ASSERT_TRUE(err.code == JUNO_ERR_INVALID_STRING);
+    bad = "{\"\\ud800\": 1}";
+    ASSERT_TRUE(!juno_reformat_buffer(bad, strlen(bad), 0, collect_sink, out, &err));
+    ASSERT_TRUE(err.code == JUNO_ERR_INVALID_STRING && err.offset == 1);
+    ASSERT_STR_EQ("high surrogate without pair", err.msg);
+}
+
+/* Parse cache */
+typedef struct {
+    JunoCache *cache;
+    unsigned   seed;
+    bool       ok;
+} CacheWorker;
+
+static void* cache_worker(void *arg) {
+    CacheWorker *cw = (CacheWorker*)arg;
+    char msg[64];
+    cw->ok = true;
+    for (unsigned i = 0; i < 2000; i++) {
+        unsigned k = (i * 7 + cw->seed) % 24;
+        int len = snprintf(msg, sizeof(msg), "{\"heartbeat\": %u}", k);
+        JunoDoc *doc = juno_cache_parse(cw->cache, msg, (size_t)len, NULL);
+        const JsonNode *v = doc ? juno_doc_root(doc)->first_child : NULL;
+        if (!v || v->value.ivalue != (int64_t)k) cw->ok = false;
+        juno_doc_release(doc);
+    }
+    return NULL;
+}
+
+static void test_parse_cache(void) {
+    const char *a = "{\"op\": \"poll\", \"since\": 17}", *b = "[1, 2, 3]", *c = "{\"op\": \"poll\", \"since\": 18}";
+    JunoCache *cache = juno_cache_new(2, 0);
+    JunoCacheStats st;
+    JunoError err;
+    ASSERT_TRUE(cache != NULL);
+
+    /* Identical bytes give the identical document. */
+    JunoDoc *d1 = juno_cache_parse(cache, a, strlen(a), &err);
+    JunoDoc *d2 = juno_cache_parse(cache, a, strlen(a), &err);
+    ASSERT_TRUE(d1 && d1 == d2 && err.code == JUNO_OK);
+    juno_doc_release(d2);
+    ASSERT_TRUE(juno_cache_parse(cache, "{\"op\":", 6, &err) == NULL && err.code == JUNO_ERR_UNEXPECTED_EOF);
+    juno_cache_stats(cache, &st);
+    ASSERT_TRUE(st.hits == 1 && st.misses == 2 && st.entries == 1 && st.bytes > strlen(a));
+
+    /* CLOCK: with both slots taken, the entry hit since the last sweep survives. */
+    JunoDoc *db = juno_cache_parse(cache, b, strlen(b), NULL);
+    juno_doc_release(juno_cache_parse(cache, a, strlen(a), NULL));
+    JunoDoc *dc = juno_cache_parse(cache, c, strlen(c), NULL);
+    juno_cache_stats(cache, &st);
+    ASSERT_TRUE(st.evictions == 1 && st.entries == 2 && st.hits == 2);
+    JunoDoc *again = juno_cache_parse(cache, a, strlen(a), NULL);
+    ASSERT_TRUE(again == d1);
+    juno_doc_release(again);
+    again = juno_cache_parse(cache, b, strlen(b), NULL);
+    ASSERT_TRUE(again != db);
+
+    /* Evicted documents stay valid for their holders. */
+    ASSERT_TRUE(juno_doc_root(db)->first_child->value.ivalue == 1);
+    juno_doc_release(again);
+    juno_doc_release(db);
+    juno_doc_release(dc);
+
+    juno_cache_clear(cache);
+    juno_cache_stats(cache, &st);
+    ASSERT_TRUE(st.entries == 0 && st.bytes == 0);
+    ASSERT_TRUE(juno_doc_root(d1)->type == JND_OBJ);
+    juno_doc_release(d1);
+    juno_cache_free(cache);
+
+    /* Inputs larger than the byte budget are parsed but not kept. */
+    cache = juno_cache_new(0, 64);
+    d1 = juno_cache_parse(cache, a, strlen(a), NULL);
+    d2 = juno_cache_parse(cache, a, strlen(a), NULL);
+    ASSERT_TRUE(d1 && d2 && d1 != d2);
+    juno_cache_stats(cache, &st);
+    ASSERT_TRUE(st.entries == 0 && st.misses == 2);
+    juno_doc_release(d1);
+    juno_doc_release(d2);
+    juno_cache_free(cache);
+
+    /* Concurrent lookups over a key set larger than one shard's share. */
+    cache = juno_cache_new(256, 0);
+    CacheWorker cw[4];
+    pthread_t tids[4];
+    for (unsigned t = 0; t < 4; t++) {
+        cw[t].cache = cache;
+        cw[t].seed = t;
+        ASSERT_TRUE(pthread_create(&tids[t], NULL, cache_worker, &cw[t]) == 0);
+    }
+    for (unsigned t = 0; t < 4; t++) pthread_join(tids[t], NULL);
+    for (unsigned t = 0; t < 4; t++) ASSERT_TRUE(cw[t].ok);
+    juno_cache_stats(cache, &st);
+    ASSERT_TRUE(st.hits + st.misses == 8000 && st.entries == 24 && st.misses >= 24);
+    juno_cache_free(cache);
+}
+
+/* Long strings in parts */
+static void test_string_parts(void) {
+    /* Escapes, a surrogate pair and raw multi-byte UTF-8 land on every offset. */
+    const char *unit = "ab\\n\\u00e9\\uD83D\\uDE00 \xc3\xa9\xe2\x82\xac\\\"x";
+    char in[2048] = "{\"blob\": \"";
+    for (int i = 0; i < 40; i++) strcat(in, unit);
+    strcat(in, "\", \"n\": [\"short\", 1]}");
+
+    JsonNode *ref = juno_parse(in, strlen(in));
+    ASSERT_TRUE(ref && !juno_is_error(ref));
+    const char *want = ref->first_child->value.svalue;
+
+    /* Without parts the value does not fit the window. */
+    ChunkSource src = { in, strlen(in), 0, 7 };
+    JunoReader *r = juno_reader_new_cb(chunk_read, &src, 64);
+    JunoEvent ev;
+    while (juno_reader_next(r, &ev) != JEV_ERROR && ev.type != JEV_EOF) {}
+    ASSERT_TRUE(juno_reader_error(r)->code == JUNO_ERR_TOKEN_TOO_LARGE);
+    juno_reader_free(r);
+
+    src.pos = 0;
+    r = juno_reader_new_cb(chunk_read, &src, 64);
+    juno_reader_set_string_parts(r, 24);
+    char got[2048] = "";
+    size_t parts = 0;
+    bool bounded = true;
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_OBJ_BEGIN);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_KEY && strcmp(ev.str, "blob") == 0);
+    while (juno_reader_next(r, &ev) == JEV_STRING_PART) {
+        bounded = bounded && ev.str_len <= 24 && strlen(ev.str) == ev.str_len;
+        strcat(got, ev.str);
+        parts++;
+    }
+    ASSERT_TRUE(ev.type == JEV_STRING && ev.depth == 1);
+    strcat(got, ev.str);
+    ASSERT_TRUE(bounded && parts > 20);
+    ASSERT_STR_EQ(want, got);
+
+    /* Short values still arrive whole, with their raw token. */
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_KEY);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_ARR_BEGIN);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_STRING && ev.raw_len == 7 && strncmp(ev.raw, "\"short\"", 7) == 0);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_NUMBER);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_ARR_END);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_OBJ_END);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_DOC_END);
+    ASSERT_TRUE(juno_reader_next(r, &ev) == JEV_EOF);
+    juno_reader_free(r);
+
+    /* Reformatting copies the parts verbatim. */
+    char min[2048] = "", out[2048] = "";
+    JunoError err;
+    ASSERT_TRUE(juno_reformat_buffer(in, strlen(in), 0, collect_sink, min, &err));
+    src.pos = 0;
+    r = juno_reader_new_cb(chunk_read, &src, 64);
+    juno_reader_set_string_parts(r, 1000);
+    ASSERT_TRUE(juno_reformat(r, 0, collect_sink, out, &err));
+    juno_reader_free(r);
+    ASSERT_STR_EQ(min, out);
+
+    /* Errors point at the opening quote. */
+    const char *bad = "[1, \"abcdefghijklmnopqrstuvwxyz\\q\"]";
+    r = juno_reader_new_mem(bad, strlen(bad));
+    juno_reader_set_string_parts(r, 16);
+    while (juno_reader_next(r, &ev) != JEV_ERROR && ev.type != JEV_EOF) {}
+    ASSERT_TRUE(juno_reader_error(r)->code == JUNO_ERR_INVALID_STRING && juno_reader_error(r)->offset == 4);
+    juno_reader_free(r);
+    bad = "[\"abcdefghijklmnopqrstuvwxyz\\uD83D";
+    r = juno_reader_new_mem(bad, strlen(bad));
+    juno_reader_set_string_parts(r, 16);
+    while (juno_reader_next(r, &ev) != JEV_ERROR && ev.type != JEV_EOF) {}
+    ASSERT_TRUE(juno_reader_error(r)->code == JUNO_ERR_INVALID_STRING && juno_reader_error(r)->offset == 1);
+    juno_reader_free(r);
+
+    juno_free_ast(ref);
+}
+
+/* Base64 payloads */
+static void test_base64(void) {
+    /* RFC 4648 section 10 vectors, both directions. */
+    static const char *const vec[][2] = {
+        { "", "" }, { "f", "Zg==" }, { "fo", "Zm8=" }, { "foo", "Zm9v" },
+        { "foob", "Zm9vYg==" }, { "fooba", "Zm9vYmE=" }, { "foobar", "Zm9vYmFy" }
+    };
+    uint8_t bytes[256];
+    char text[512];
+    size_t n = 0;
+    JunoError err;
+    for (size_t i = 0; i < sizeof(vec) / sizeof(vec[0]); i++) {
+        size_t len = strlen(vec[i][0]);
+        n = juno_base64_encode((const uint8_t*)vec[i][0], len, 0, text);
+        ASSERT_TRUE(n == juno_base64_encoded_len(len, 0) && n == strlen(vec[i][1]) && memcmp(text, vec[i][1], n) == 0);
+        ASSERT_TRUE(juno_base64_decode(vec[i][1], strlen(vec[i][1]), 0, bytes, &n, &err));
+        ASSERT_TRUE(n == len && memcmp(bytes, vec[i][0], n) == 0);
+    }
+    ASSERT_TRUE(juno_base64_decode("Zm9vYg", 6, 0, bytes, &n, &err) && n == 4);   /* padding is optional */
+
+    /* Long inputs take the vector path; results and error offsets match. */
+    uint8_t data[192];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 37 + 11);
+    for (unsigned flags = 0; flags <= JUNO_BASE64_URL; flags++) {
+        n = juno_base64_encode(data, sizeof(data), flags, text);
+        ASSERT_TRUE(juno_base64_decode(text, n, flags, bytes, &n, &err));
+        ASSERT_TRUE(n == sizeof(data) && memcmp(bytes, data, n) == 0);
+    }
+    n = juno_base64_encode(data, sizeof(data), 0, text);
+    text[77] = '-';
+    ASSERT_TRUE(!juno_base64_decode(text, n, 0, bytes, &n, &err));
+    ASSERT_TRUE(err.code == JUNO_ERR_INVALID_STRING && err.offset == 77);
+    ASSERT_TRUE(!juno_base64_decode("Zm9vY", 5, 0, bytes, &n, &err) && err.offset == 4);
+    ASSERT_TRUE(!juno_base64_decode("Zh==", 4, 0, bytes, &n, &err));        /* non-zero trailing bits */
+    ASSERT_TRUE(!juno_base64_decode("Zm9v+/==", 8, JUNO_BASE64_URL, bytes, &n, &err) && err.offset == 4);
+
+    /* Parse-time decoding of the named members, at any depth, into binary nodes. */
+    char json[1024];
+    n = juno_base64_encode(data, sizeof(data), 0, text);
+    text[n] = '\0';
+    snprintf(json, sizeof(json), "{\"name\": \"Zm9v\", \"blob\": \"%.*s\", \"meta\": {\"blob\": \"Zm9v\\/w==\"},"
+             " \"list\": [\"Zm9v\"]}", (int)n, text);
+    const char *const keys[] = { "blob", NULL };
+    JunoParseOptions opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.base64_keys = keys;
+    JsonNode *root = juno_parse_opts(json, strlen(json), &opts, &err);
+    ASSERT_TRUE(root != NULL);
+    const uint8_t *bin = juno_binary(juno_obj_get(root, "blob"), &n);
+    ASSERT_TRUE(bin && n == sizeof(data) && memcmp(bin, data, n) == 0);
+    bin = juno_binary(juno_obj_get(juno_obj_get(root, "meta"), "blob"), &n);
+    ASSERT_TRUE(bin && n == 4 && memcmp(bin, "foo\xff", 4) == 0);
+    ASSERT_TRUE(juno_binary(juno_obj_get(root, "name"), &n) == NULL);
+    ASSERT_TRUE(juno_binary(juno_obj_get(root, "list")->first_child, &n) == NULL);
+
+    /* Strings decoded on demand; copies, equality and the writer. */
+    uint8_t *dup = juno_binary_dup(juno_obj_get(root, "name"), 0, &n, &err);
+    ASSERT_TRUE(dup && n == 3 && memcmp(dup, "foo", 3) == 0);
+    free(dup);
+    JsonNode *copy = juno_clone(NULL, root);
+    ASSERT_TRUE(juno_equal(root, copy) && juno_hash(root) == juno_hash(copy));
+    juno_free_ast(copy);
+    char *out = juno_stringify(root, NULL, &err);
+    ASSERT_TRUE(out && strstr(out, text) && strstr(out, "\"Zm9v/w==\""));
+    free(out);
+    juno_free_ast(root);
+
+    /* Arena parses and the URL alphabet. */
+    JunoArena *arena = juno_arena_new(0);
+    opts.arena = arena;
+    opts.flags = JUNO_PARSE_BASE64URL;
+    root = juno_parse_opts("[{\"blob\": \"-_-_\"}]", 18, &opts, &err);
+    bin = root ? juno_binary(root->first_child->first_child, &n) : NULL;
+    ASSERT_TRUE(bin && n == 3 && bin[0] == 0xfb && bin[1] == 0xff && bin[2] == 0xbf);
+    out = juno_stringify(root, NULL, &err);
+    ASSERT_STR_EQ("[{\"blob\":\"-_-_\"}]", out);
+    free(out);
+    juno_arena_free(arena);
+
+    /* Invalid payloads fail the parse at the offending character. */
+    opts.arena = NULL;
+    opts.flags = 0;
+    const char *bad = "{\"blob\": \"Zm9v!A==\"}";
+    ASSERT_TRUE(juno_parse_opts(bad, strlen(bad), &opts, &err) == NULL);
+    ASSERT_TRUE(err.code == JUNO_ERR_INVALID_STRING && err.offset == 14);
+}
+
+/* Parse `doc` with the default parser and with `mode`; both succeed with the
+ * same tree and the same output, or fail with the same error. */
+static bool _same_as_full(const char *doc, JunoParseMode mode, JunoArena *arena) {
+    JunoParseOptions opts;
+    JunoError e1, e2;
+    memset(&opts, 0, sizeof(opts));
+    opts.arena = arena;
+    JsonNode *a = juno_parse_opts(doc, strlen(doc), &opts, &e1);
+    opts.mode = mode;
+    JsonNode *b = juno_parse_opts(doc, strlen(doc), &opts, &e2);
+
+    bool same;
+    if (!a || !b) {
+        same = !a && !b && e1.code == e2.code && e1.offset == e2.offset && e1.depth == e2.depth &&
+               strcmp(e1.msg, e2.msg) == 0;
+    } else {
+        char *s1 = juno_stringify(a, NULL, NULL), *s2 = juno_stringify(b, NULL, NULL);
+        same = juno_equal(a, b) && s1 && s2 && strcmp(s1, s2) == 0;
+        free(s1);
+        free(s2);
+    }
+    juno_free_ast(a);
+    juno_free_ast(b);
+    return same;
+}
+
+static void test_parse_modes(void) {
+    static const char *const valid[] = {
+        "{\"a\": [1, -2, 3.25, -0, 0.5e-3, 1E+2, 9223372036854775807, -9223372036854775808,"
+        " 9223372036854775808, 12345678901234567890123, 0.1, 1e-400, 4.9e-324, 2.2250738585072014e-308],"
+        " \"b\": {\"c\": true, \"d\": false, \"e\": null}, \"f\": \"\", \"g\": {}, \"h\": []}",
+        "\"plain text long enough to take the word-at-a-time scan\"",
+        "[\"esc \\\" \\\\ \\/ \\b \\f \\n \\r \\t \\u00e9 \\ud83d\\ude00\", \"caf\xc3\xa9\"]",
+        " \t\r\n [ 1 , [ [ ] ] , { \"k\" : \"v\" } ] \n",
+        "[1, 2] trailing content is ignored by every parser",
+        "-1.7976931348623157e308",
+    };
+    static const char *const invalid[] = {
+        "", "   ", "[1, 2", "[1 2]", "[1,]", "{\"a\" 1}", "{\"a\": 1,}", "{\"a\": 1 \"b\": 2}", "{1: 2}",
+        "[01]", "[-]", "[1.]", "[1e]", "[1e+]", "[-01]", "[tru]", "[nul]", "[falsy]", "[nulls]",
+        "\"unterminated", "\"bad \\x escape\"", "\"ctl \x01 char\"", "\"\\ud800 alone\"", "[1, @]",
+        "{\"a\": {\"b\": [1, }}", "[1e999]", "{\"k\\q\": 1}",
+    };
+    static const JunoParseMode modes[] = { JUNO_PARSE_MODE_STRICT, JUNO_PARSE_MODE_TRUSTED };
+
+    JunoArena *arena = juno_arena_new(0);
+    for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+        for (size_t m = 0; m < 2; m++) {
+            ASSERT_TRUE(_same_as_full(valid[i], modes[m], NULL));
+            ASSERT_TRUE(_same_as_full(valid[i], modes[m], arena));
+        }
+    }
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        ASSERT_TRUE(_same_as_full(invalid[i], JUNO_PARSE_MODE_STRICT, NULL));
+        ASSERT_TRUE(_same_as_full(invalid[i], JUNO_PARSE_MODE_STRICT, arena));
+        ASSERT_TRUE(_same_as_full(invalid[i], JUNO_PARSE_MODE_DOUBLES, NULL));
+    }
+    /* A failed arena parse gives its allocations back. */
+    juno_arena_reset(arena);
+    ASSERT_TRUE(_same_as_full("[\"x\", [1, 2, {\"k\": ]}]", JUNO_PARSE_MODE_STRICT, arena));
+    ASSERT_TRUE(juno_arena_used(arena) == 0);
+    juno_arena_free(arena);
+
+    /* Nesting is limited the same way. */
+    char deep[2 * JUNO_MAX_NESTING + 8];
+    memset(deep, '[', JUNO_MAX_NESTING + 1);
+    memset(deep + JUNO_MAX_NESTING + 1, ']', JUNO_MAX_NESTING + 1);
+    deep[2 * JUNO_MAX_NESTING + 2] = '\0';
+    ASSERT_TRUE(_same_as_full(deep, JUNO_PARSE_MODE_STRICT, NULL));
+    ASSERT_TRUE(_same_as_full(deep + 1, JUNO_PARSE_MODE_STRICT, NULL));
+    for (int n = JUNO_MAX_NESTING; n <= JUNO_MAX_NESTING + 1; n++) {
+        char *objs = _nested_objects(n);
+        ASSERT_TRUE(_same_as_full(objs, JUNO_PARSE_MODE_STRICT, NULL));
+        free(objs);
+    }
+
+    /* Trusted input skips the checks that do not affect the tree's shape. */
+    JunoParseOptions opts;
+    JunoError err;
+    memset(&opts, 0, sizeof(opts));
+    opts.mode = JUNO_PARSE_MODE_TRUSTED;
+    JsonNode *root = juno_parse_opts("[007, \"tab\there\"]", 17, &opts, &err);
+    ASSERT_TRUE(root && root->first_child->is_integer && root->first_child->value.ivalue == 7);
+    ASSERT_STR_EQ("tab\there", root->value.last_child->value.svalue);
+    juno_free_ast(root);
+
+    /* Doubles only: same values, never int64. */
+    opts.mode = JUNO_PARSE_MODE_DOUBLES;
+    root = juno_parse_opts("[1, -42, 2.5, 12345678901234567890]", 35, &opts, &err);
+    ASSERT_TRUE(root != NULL);
+    double expect[] = { 1, -42, 2.5, 12345678901234567890.0 };
+    size_t i = 0;
+    for (JsonNode *n = root->first_child; n; n = n->next_sibling, i++)
+        ASSERT_TRUE(!n->is_integer && n->value.nvalue == expect[i]);
+    ASSERT_TRUE(i == 4);
+    juno_free_ast(root);
+
+    /* Options only the default parser serves select it whatever the mode. */
+    JunoLimits lim;
+    memset(&lim, 0, sizeof(lim));
+    lim.max_nodes = 2;
+    opts.limits = &lim;
+    ASSERT_TRUE(juno_parse_opts("[1, 2]", 6, &opts, &err) == NULL && err.code == JUNO_ERR_TOO_MANY_NODES);
+}
+
+static void test_compact(void) {
+    /* A tree assembled piece by piece on the heap, with other allocations in between. */
+    JsonNode *root = juno_new_object(NULL);
+    void *noise[64];
+    for (int i = 0; i < 64; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "k%d", i);
+        JsonNode *item = juno_new_array(NULL);
+        juno_array_append(item, juno_new_int(NULL, i));
+        juno_array_append(item, juno_new_string(NULL, key, strlen(key)));
+        juno_array_append(item, juno_new_double(NULL, i + 0.5));
+        ASSERT_TRUE(juno_obj_append(NULL, root, key, item));
+        noise[i] = malloc(48);
+    }
+    juno_obj_append(NULL, root, "raw", juno_new_number_text(NULL, "1.50", 4));
+    juno_obj_append(NULL, root, "bin", juno_new_binary(NULL, "\x01\x02\x03", 3, 0));
+    juno_obj_append(NULL, root, "nil", juno_new_null(NULL));
+    for (int i = 0; i < 64; i++) free(noise[i]);
+
+    JunoError err;
+    JunoDoc *doc = juno_compact(root, &err);
+    ASSERT_TRUE(doc != NULL && err.code == JUNO_OK);
+    const JsonNode *c = juno_doc_root(doc);
+    ASSERT_TRUE(juno_equal(root, c) && juno_hash(root) == juno_hash(c));
+    char *s1 = juno_stringify(root, NULL, &err), *s2 = juno_stringify(c, NULL, &err);
+    ASSERT_STR_EQ(s1, s2);
+    free(s1);
+    free(s2);
+
+    /* Nodes are consecutive in depth-first order, strings follow them. */
+    const JsonNode *expect = c;
+    JunoIter it;
+    juno_iter_init(&it, c);
+    for (JunoIterEvent ev; (ev = juno_iter_next(&it)) != JUNO_ITER_END; )
+        if (ev != JUNO_ITER_LEAVE) ASSERT_TRUE(it.pos.node == expect++);
+    juno_iter_free(&it);
+    const JsonNode *first = c->first_child;
+    ASSERT_TRUE(first == c + 1 && first->first_child == c + 2 && first->next_sibling == c + 5);
+    ASSERT_TRUE((const void*)first->key > (const void*)expect);
+    size_t n = 0;
+    const uint8_t *bin = juno_binary(juno_obj_get(c, "bin"), &n);
+    ASSERT_TRUE(bin && n == 3 && bin[2] == 3 && ((uintptr_t)bin & 7) == 0);
+    ASSERT_STR_EQ("1.50", juno_number_raw(juno_obj_get(c, "raw"), NULL));
+
+    juno_free_ast(root);
+
+    /* Documents compact too. */
+    JunoDoc *again = juno_compact(c, &err);
+    ASSERT_TRUE(again && juno_equal(juno_doc_root(again), c));
+    juno_doc_release(again);
+    juno_doc_release(doc);
+    ASSERT_TRUE(juno_compact(NULL, &err) == NULL && err.code == JUNO_ERR_INVALID_ARG);
+}
+
+/* Parse `doc` against `sc`; on failure both the fused parse and the tree
+ * validator must report `pointer` and `msg`. */
+static bool _schema_rejects(const JunoSchema *sc, const char *doc, const char *pointer, const char *msg) {
+    JunoSchemaError err;
+    JsonNode *root = juno_schema_parse(sc, doc, strlen(doc), NULL, &err);
+    if (root || err.error.code != JUNO_ERR_SCHEMA || strcmp(err.pointer, pointer) != 0 || strcmp(err.error.msg, msg) != 0) {
+        juno_free_ast(root);
+        return false;
+    }
+    root = juno_parse(doc, strlen(doc));
+    if (juno_is_error(root)) {   /* rejected early, before the syntax error further on */
+        juno_free_ast(root);
+        return true;
+    }
+    bool ok = !juno_schema_validate(sc, root, &err) && err.error.code == JUNO_ERR_SCHEMA &&
+              strcmp(err.pointer, pointer) == 0 && strcmp(err.error.msg, msg) == 0;
+    juno_free_ast(root);
+    return ok;
+}
+
+static void test_schema(void) {
+    const char *schema_text =
+        "{\"$schema\": \"https://json-schema.org/draft/2020-12/schema\", \"title\": \"request\","
+        " \"type\": \"object\", \"required\": [\"jsonrpc\", \"method\", \"id\"], \"additionalProperties\": false,"
+        " \"properties\": {"
+        "   \"jsonrpc\": {\"enum\": [\"2.0\"]},"
+        "   \"method\": {\"type\": \"string\", \"minLength\": 1, \"maxLength\": 8},"
+        "   \"id\": {\"type\": [\"integer\", \"string\"]},"
+        "   \"params\": {\"type\": \"array\", \"maxItems\": 3, \"items\": {\"type\": \"object\","
+        "     \"additionalProperties\": false,"
+        "     \"properties\": {\"n\": {\"type\": \"number\", \"minimum\": 0, \"exclusiveMaximum\": 100},"
+        "                     \"a/b~\": {\"type\": \"boolean\"}}}}}}";
+    JsonNode *schema = juno_parse(schema_text, strlen(schema_text));
+    JunoSchemaError err;
+    JunoSchema *sc = juno_schema_compile(schema, &err);
+    juno_free_ast(schema);
+    ASSERT_TRUE(sc != NULL);
+
+    const char *good = "{\"jsonrpc\": \"2.0\", \"method\": \"sum\", \"id\": 7.0, \"params\": [{\"n\": 1.5}, {\"a/b~\": true}]}";
+    JsonNode *root = juno_schema_parse(sc, good, strlen(good), NULL, &err);
+    ASSERT_TRUE(root != NULL && err.error.code == JUNO_OK);
+    ASSERT_TRUE(juno_schema_validate(sc, root, &err));
+    juno_free_ast(root);
+
+    ASSERT_TRUE(_schema_rejects(sc, "{\"jsonrpc\": \"1.0\", \"method\": \"m\", \"id\": 1}", "/jsonrpc", "value not in enum"));
+    ASSERT_TRUE(_schema_rejects(sc, "{\"jsonrpc\": \"2.0\", \"method\": \"\", \"id\": 1}", "/method", "string shorter than minLength"));
+    ASSERT_TRUE(_schema_rejects(sc, "{\"jsonrpc\": \"2.0\", \"method\": \"m\", \"id\": 1.5}", "/id", "value is not an integer"));
+    ASSERT_TRUE(_schema_rejects(sc, "{\"jsonrpc\": \"2.0\", \"method\": \"m\", \"id\": null}", "/id", "value has the wrong type"));
+    ASSERT_TRUE(_schema_rejects(sc, "{\"jsonrpc\": \"2.0\", \"method\": \"m\", \"id\": 1, \"params\": [{}, {\"n\": 100}]}",
+                                "/params/1/n", "value not below exclusiveMaximum"));
+    ASSERT_TRUE(_schema_rejects(sc, "{\"jsonrpc\": \"2.0\", \"method\": \"m\", \"id\": 1, \"params\": [{\"a/b~\": 1}]}",
+                                "/params/0/a~1b~0", "value has the wrong type"));
+    ASSERT_TRUE(_schema_rejects(sc, "{\"jsonrpc\": \"2.0\", \"method\": \"m\"}", "", "missing required member"));
+
+    /* Early rejection: the violation is reported, not the broken text after it. */
+    const char *early = "{\"jsonrpc\": \"2.0\", \"extra\": [1, 2, ";
+    ASSERT_TRUE(_schema_rejects(sc, early, "/extra", "member not allowed by schema"));
+    ASSERT_TRUE(juno_schema_parse(sc, early, strlen(early), NULL, &err) == NULL && err.error.offset == 19);
+    ASSERT_TRUE(_schema_rejects(sc, "{\"id\": 1, \"params\": {\"n\": ", "/params", "value has the wrong type"));
+    ASSERT_TRUE(_schema_rejects(sc, "{\"id\": 1, \"params\": [{}, {}, {}, {", "/params", "array has more items than maxItems"));
+    ASSERT_TRUE(_schema_rejects(sc, "[1, 2, 3]", "", "value has the wrong type"));
+    juno_schema_parse(sc, "{\"jsonrpc\": \"2.0\", \"method\": \"m\"}", 33, NULL, &err);
+    ASSERT_STR_EQ("id", err.member);
+
+    /* Syntax errors come through unchanged. */
+    ASSERT_TRUE(juno_schema_parse(sc, "{\"id\" 1}", 8, NULL, &err) == NULL && err.error.code == JUNO_ERR_UNEXPECTED_TOKEN);
+    juno_schema_free(sc);
+
+    /* Compile errors point into the schema. */
+    const char *bad[][2] = {
+        { "{\"properties\": {\"a\": {\"pattern\": \"x\"}}}", "/properties/a/pattern" },
+        { "{\"type\": [\"string\", \"thing\"]}", "/type" },
+        { "{\"items\": {\"minItems\": -1}}", "/items/minItems" },
+        { "{\"additionalProperties\": 3}", "/additionalProperties" },
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        schema = juno_parse(bad[i][0], strlen(bad[i][0]));
+        ASSERT_TRUE(juno_schema_compile(schema, &err) == NULL && err.error.code == JUNO_ERR_INVALID_ARG);
+        ASSERT_STR_EQ(bad[i][1], err.pointer);
+        juno_free_ast(schema);
+    }
+}
+
 /* ------------------------------------------------------------------
  *  Test runner
  * ------------------------------------------------------------------ */
@@ -264,8 +2072,38 @@ int main(void) {
     RUN_TEST(test_literals);
     RUN_TEST(test_max_nesting_ok);
     RUN_TEST(test_exceed_max_nesting);
+    RUN_TEST(test_object_nesting);
     RUN_TEST(test_reject_comments);
     RUN_TEST(test_number_cases_file);
+    RUN_TEST(test_structured_error);
+    RUN_TEST(test_structured_error_codes);
+    RUN_TEST(test_reader_documents);
+    RUN_TEST(test_reader_events);
+    RUN_TEST(test_reader_errors);
+    RUN_TEST(test_projection);
+    RUN_TEST(test_binary_roundtrip);
+    RUN_TEST(test_binary_scalars);
+    RUN_TEST(test_batch_parse);
+    RUN_TEST(test_arena_parse);
+    RUN_TEST(test_parse_stats);
+    RUN_TEST(test_builder);
+    RUN_TEST(test_stringify);
+    RUN_TEST(test_frozen_doc);
+    RUN_TEST(test_lazy_numbers);
+    RUN_TEST(test_hash_equal);
+    RUN_TEST(test_canonical);
+    RUN_TEST(test_patch);
+    RUN_TEST(test_duplicate_keys);
+    RUN_TEST(test_limits);
+    RUN_TEST(test_iter);
+    RUN_TEST(test_parse_files);
+    RUN_TEST(test_reformat);
+    RUN_TEST(test_parse_cache);
+    RUN_TEST(test_string_parts);
+    RUN_TEST(test_base64);
+    RUN_TEST(test_parse_modes);
+    RUN_TEST(test_compact);
+    RUN_TEST(test_schema);
 
     printf("\n=== Summary ===\n");
     printf("Run: %d, Passed: %d, Failed: %d\n",